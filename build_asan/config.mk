@@ -0,0 +1,22 @@
+PREFIX=/root/.pyenv/versions/3.11.7
+CC=gcc
+CXX=g++
+CXXFLAGS= -D_MP_INTERNAL -D_AMD64_ -D_USE_THREAD_LOCAL -DZ3DEBUG -D_TRACE -std=gnu++98 -fsanitize=address -fno-omit-frame-pointer -fvisibility=hidden -c -mfpmath=sse -msse -msse2 -fopenmp -g -Wall -fno-strict-aliasing -D_LINUX_ -fPIC
+EXAMP_DEBUG_FLAG=-g
+CXX_OUT_FLAG=-o 
+OBJ_EXT=.o
+LIB_EXT=.a
+AR=ar
+AR_FLAGS=rcs
+AR_OUTFLAG=
+EXE_EXT=
+LINK=g++
+LINK_FLAGS=
+LINK_OUT_FLAG=-o 
+LINK_EXTRA_FLAGS=-lpthread -fsanitize=address -fopenmp -lrt
+SO_EXT=.so
+SLINK=g++
+SLINK_FLAGS=-shared
+SLINK_EXTRA_FLAGS= -fopenmp -lrt
+SLINK_OUT_FLAG=-o 
+OS_DEFINES=-D_LINUX_
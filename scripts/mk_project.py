@@ -13,12 +13,12 @@ def init_project_def():
     add_lib('util', [])
     add_lib('polynomial', ['util'], 'math/polynomial')
     add_lib('sat', ['util'])
-    add_lib('nlsat', ['polynomial', 'sat'])
     add_lib('hilbert', ['util'], 'math/hilbert')
     add_lib('simplex', ['util'], 'math/simplex')
     add_lib('interval', ['util'], 'math/interval')
-    add_lib('realclosure', ['interval'], 'math/realclosure')
+    add_lib('realclosure', ['interval', 'polynomial'], 'math/realclosure')
     add_lib('subpaving', ['interval'], 'math/subpaving')
+    add_lib('nlsat', ['polynomial', 'sat', 'subpaving'])
     add_lib('ast', ['util', 'polynomial'])
     add_lib('rewriter', ['ast', 'polynomial'], 'ast/rewriter')
     add_lib('normal_forms', ['rewriter'], 'ast/normal_forms')
@@ -30,11 +30,11 @@ def init_project_def():
     add_lib('euclid', ['util'], 'math/euclid')
     add_lib('core_tactics', ['tactic', 'normal_forms'], 'tactic/core')
     add_lib('sat_tactic', ['tactic', 'sat'], 'sat/tactic')
-    add_lib('arith_tactics', ['core_tactics', 'sat'], 'tactic/arith')
-    add_lib('nlsat_tactic', ['nlsat', 'sat_tactic', 'arith_tactics'], 'nlsat/tactic')
-    add_lib('subpaving_tactic', ['core_tactics', 'subpaving'], 'math/subpaving/tactic')
-    add_lib('aig_tactic', ['tactic'], 'tactic/aig')
+    add_lib('arith_tactics', ['core_tactics', 'sat', 'interval'], 'tactic/arith')
     add_lib('solver', ['model', 'tactic'])
+    add_lib('nlsat_tactic', ['nlsat', 'sat_tactic', 'arith_tactics', 'solver'], 'nlsat/tactic')
+    add_lib('subpaving_tactic', ['core_tactics', 'subpaving'], 'math/subpaving/tactic')
+    add_lib('aig_tactic', ['tactic', 'sat'], 'tactic/aig')
     add_lib('interp', ['solver'])
     add_lib('cmd_context', ['solver', 'rewriter', 'interp'])
     add_lib('extra_cmds', ['cmd_context', 'subpaving_tactic', 'arith_tactics'], 'cmd_context/extra_cmds')
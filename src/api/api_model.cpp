@@ -343,6 +343,118 @@ extern "C" {
         RETURN_Z3(of_expr(r));
         Z3_CATCH_RETURN(0);
     }
+
+    Z3_incremental_evaluator Z3_API Z3_mk_incremental_evaluator(Z3_context c, Z3_model m, unsigned num_exprs, Z3_ast const exprs[], Z3_bool model_completion) {
+        Z3_TRY;
+        LOG_Z3_mk_incremental_evaluator(c, m, num_exprs, exprs, model_completion);
+        RESET_ERROR_CODE();
+        CHECK_NON_NULL(m, 0);
+        for (unsigned i = 0; i < num_exprs; i++) {
+            CHECK_IS_EXPR(exprs[i], 0);
+        }
+        Z3_incremental_evaluator_ref * e = alloc(Z3_incremental_evaluator_ref, mk_c(c)->m(), to_model_ref(m)->copy());
+        e->m_evaluator.set_model_completion(model_completion == Z3_TRUE);
+        for (unsigned i = 0; i < num_exprs; i++)
+            e->m_evaluator.compile(to_expr(exprs[i]));
+        mk_c(c)->save_object(e);
+        RETURN_Z3(of_incremental_evaluator(e));
+        Z3_CATCH_RETURN(0);
+    }
+
+    void Z3_API Z3_incremental_evaluator_inc_ref(Z3_context c, Z3_incremental_evaluator e) {
+        Z3_TRY;
+        LOG_Z3_incremental_evaluator_inc_ref(c, e);
+        RESET_ERROR_CODE();
+        if (e) {
+            to_incremental_evaluator(e)->inc_ref();
+        }
+        Z3_CATCH;
+    }
+
+    void Z3_API Z3_incremental_evaluator_dec_ref(Z3_context c, Z3_incremental_evaluator e) {
+        Z3_TRY;
+        LOG_Z3_incremental_evaluator_dec_ref(c, e);
+        RESET_ERROR_CODE();
+        if (e) {
+            to_incremental_evaluator(e)->dec_ref();
+        }
+        Z3_CATCH;
+    }
+
+    void Z3_API Z3_incremental_evaluator_set_const_interp(Z3_context c, Z3_incremental_evaluator e, Z3_func_decl a, Z3_ast v) {
+        Z3_TRY;
+        LOG_Z3_incremental_evaluator_set_const_interp(c, e, a, v);
+        RESET_ERROR_CODE();
+        CHECK_NON_NULL(e,);
+        CHECK_NON_NULL(a,);
+        CHECK_IS_EXPR(v,);
+        func_decl * d = to_func_decl(a);
+        if (d->get_arity() != 0) {
+            SET_ERROR_CODE(Z3_INVALID_ARG);
+            return;
+        }
+        if (d->get_range() != mk_c(c)->m().get_sort(to_expr(v))) {
+            SET_ERROR_CODE(Z3_SORT_ERROR);
+            return;
+        }
+        Z3_incremental_evaluator_ref * _e = to_incremental_evaluator(e);
+        _e->m_model->register_decl(d, to_expr(v));
+        _e->m_updated.push_back(d);
+        Z3_CATCH;
+    }
+
+    unsigned Z3_API Z3_incremental_evaluator_get_num_exprs(Z3_context c, Z3_incremental_evaluator e) {
+        Z3_TRY;
+        LOG_Z3_incremental_evaluator_get_num_exprs(c, e);
+        RESET_ERROR_CODE();
+        CHECK_NON_NULL(e, 0);
+        return to_incremental_evaluator(e)->m_evaluator.get_num_roots();
+        Z3_CATCH_RETURN(0);
+    }
+
+    Z3_ast Z3_API Z3_incremental_evaluator_get_value(Z3_context c, Z3_incremental_evaluator e, unsigned i) {
+        Z3_TRY;
+        LOG_Z3_incremental_evaluator_get_value(c, e, i);
+        RESET_ERROR_CODE();
+        CHECK_NON_NULL(e, 0);
+        Z3_incremental_evaluator_ref * _e = to_incremental_evaluator(e);
+        if (i >= _e->m_evaluator.get_num_roots()) {
+            SET_ERROR_CODE(Z3_IOB);
+            RETURN_Z3(0);
+        }
+        try {
+            if (!_e->m_evaluated) {
+                _e->m_evaluator(*_e->m_model);
+                _e->m_evaluated = true;
+            }
+            else if (!_e->m_updated.empty()) {
+                _e->m_evaluator.update(*_e->m_model, _e->m_updated.size(), _e->m_updated.c_ptr());
+            }
+        }
+        catch (...) {
+            // the evaluator was invalidated, all values are recomputed in the next call.
+            _e->m_evaluated = false;
+            _e->m_updated.reset();
+            throw;
+        }
+        _e->m_updated.reset();
+        expr * r = _e->m_evaluator.get_value(i);
+        mk_c(c)->save_ast_trail(r);
+        RETURN_Z3(of_expr(r));
+        Z3_CATCH_RETURN(0);
+    }
+
+    Z3_model Z3_API Z3_incremental_evaluator_get_model(Z3_context c, Z3_incremental_evaluator e) {
+        Z3_TRY;
+        LOG_Z3_incremental_evaluator_get_model(c, e);
+        RESET_ERROR_CODE();
+        CHECK_NON_NULL(e, 0);
+        Z3_model_ref * m_ref = alloc(Z3_model_ref);
+        m_ref->m_model = to_incremental_evaluator(e)->m_model->copy();
+        mk_c(c)->save_object(m_ref);
+        RETURN_Z3(of_model(m_ref));
+        Z3_CATCH_RETURN(0);
+    }
    
     // ----------------------------
     //
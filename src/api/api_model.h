@@ -20,6 +20,7 @@ Revision History:
 
 #include"api_util.h"
 #include"model.h"
+#include"compiled_model_evaluator.h"
 
 struct Z3_model_ref : public api::object {
     model_ref  m_model;
@@ -54,5 +55,17 @@ inline Z3_func_entry_ref * to_func_entry(Z3_func_entry s) { return reinterpret_c
 inline Z3_func_entry of_func_entry(Z3_func_entry_ref * s) { return reinterpret_cast<Z3_func_entry>(s); }
 inline func_entry const * to_func_entry_ref(Z3_func_entry s) { return to_func_entry(s)->m_func_entry; }
 
+struct Z3_incremental_evaluator_ref : public api::object {
+    model_ref                m_model;
+    compiled_model_evaluator m_evaluator;
+    func_decl_ref_vector     m_updated;   // constants modified since the last evaluation
+    bool                     m_evaluated;
+    Z3_incremental_evaluator_ref(ast_manager & m, model * md):m_model(md), m_evaluator(m), m_updated(m), m_evaluated(false) {}
+    virtual ~Z3_incremental_evaluator_ref() {}
+};
+
+inline Z3_incremental_evaluator_ref * to_incremental_evaluator(Z3_incremental_evaluator s) { return reinterpret_cast<Z3_incremental_evaluator_ref *>(s); }
+inline Z3_incremental_evaluator of_incremental_evaluator(Z3_incremental_evaluator_ref * s) { return reinterpret_cast<Z3_incremental_evaluator>(s); }
+
 
 #endif
@@ -118,6 +118,10 @@ class FuncEntryObj(ctypes.c_void_p):
   def __init__(self, e): self._as_parameter_ = e
   def from_param(obj): return obj
 
+class IncrementalEvaluatorObj(ctypes.c_void_p):
+  def __init__(self, evaluator): self._as_parameter_ = evaluator
+  def from_param(obj): return obj
+
 class RCFNumObj(ctypes.c_void_p):
   def __init__(self, e): self._as_parameter_ = e
   def from_param(obj): return obj
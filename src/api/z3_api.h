@@ -32,6 +32,7 @@ DEFINE_TYPE(Z3_apply_result);
 DEFINE_TYPE(Z3_func_interp);
 #define Z3_func_interp_opt Z3_func_interp
 DEFINE_TYPE(Z3_func_entry);
+DEFINE_TYPE(Z3_incremental_evaluator);
 DEFINE_TYPE(Z3_fixedpoint);
 DEFINE_TYPE(Z3_optimize);
 DEFINE_TYPE(Z3_rcf_num);
@@ -64,6 +65,7 @@ DEFINE_TYPE(Z3_rcf_num);
    - \c Z3_model: model for the constraints asserted into the logical context.
    - \c Z3_func_interp: interpretation of a function in a model.
    - \c Z3_func_entry: representation of the value of a \c Z3_func_interp at a particular point.
+   - \c Z3_incremental_evaluator: evaluator of a fixed set of expressions in a model that is updated incrementally.
    - \c Z3_fixedpoint: context for the recursive predicate solver.
    - \c Z3_optimize: context for solving optimization queries.
    - \c Z3_ast_vector: vector of \c Z3_ast objects.
@@ -1279,6 +1281,7 @@ typedef enum
   def_Type('APPLY_RESULT',     'Z3_apply_result',     'ApplyResultObj')
   def_Type('FUNC_INTERP',      'Z3_func_interp',      'FuncInterpObj')
   def_Type('FUNC_ENTRY',       'Z3_func_entry',       'FuncEntryObj')
+  def_Type('INCREMENTAL_EVALUATOR', 'Z3_incremental_evaluator', 'IncrementalEvaluatorObj')
   def_Type('FIXEDPOINT',       'Z3_fixedpoint',       'FixedpointObj')
   def_Type('OPTIMIZE',         'Z3_optimize',         'OptimizeObj')
   def_Type('PARAM_DESCRS',     'Z3_param_descrs',     'ParamDescrs')
@@ -1387,6 +1390,8 @@ extern "C" {
 
             - proof  (Boolean)           Enable proof generation
             - debug_ref_count (Boolean)  Enable debug support for Z3_ast reference counting
+            - deferred_deletion (unsigned) When greater than 0, unreferenced terms are deleted incrementally, at most the given number of terms per new term
+            - rewrite_cache (unsigned)   Maximal number of entries of the cache simplifiers use to reuse results between invocations, 0 disables it
             - trace  (Boolean)           Tracing support for VCC
             - trace_file_name (String)   Trace out file for VCC traces
             - timeout (unsigned)         default timeout (in milliseconds) used for solvers
@@ -4522,6 +4527,73 @@ extern "C" {
        def_API('Z3_func_entry_get_arg', AST, (_in(CONTEXT), _in(FUNC_ENTRY), _in(UINT)))
     */
     Z3_ast Z3_API Z3_func_entry_get_arg(Z3_context c, Z3_func_entry e, unsigned i);
+
+    /**
+       \brief Create an evaluator for the expressions \c exprs in a copy of the model \c m.
+
+       The expressions are compiled once. After the interpretation of a few constants is
+       modified using #Z3_incremental_evaluator_set_const_interp, only the subterms that depend
+       on them are evaluated again. This is useful for local search style algorithms that
+       repeatedly modify a model and check the value of a fixed set of constraints.
+
+       If \c model_completion is Z3_TRUE, then Z3 will assign an interpretation for any constant
+       or function that does not have an interpretation in the model (see #Z3_model_eval).
+
+       \remark Reference counting must be used to manage Z3_incremental_evaluator objects, even when
+       the Z3_context was created using #Z3_mk_context instead of #Z3_mk_context_rc.
+
+       def_API('Z3_mk_incremental_evaluator', INCREMENTAL_EVALUATOR, (_in(CONTEXT), _in(MODEL), _in(UINT), _in_array(2, AST), _in(BOOL)))
+    */
+    Z3_incremental_evaluator Z3_API Z3_mk_incremental_evaluator(Z3_context c, Z3_model m, unsigned num_exprs, Z3_ast const exprs[], Z3_bool model_completion);
+
+    /**
+       \brief Increment the reference counter of the given incremental evaluator.
+
+       def_API('Z3_incremental_evaluator_inc_ref', VOID, (_in(CONTEXT), _in(INCREMENTAL_EVALUATOR)))
+    */
+    void Z3_API Z3_incremental_evaluator_inc_ref(Z3_context c, Z3_incremental_evaluator e);
+
+    /**
+       \brief Decrement the reference counter of the given incremental evaluator.
+
+       def_API('Z3_incremental_evaluator_dec_ref', VOID, (_in(CONTEXT), _in(INCREMENTAL_EVALUATOR)))
+    */
+    void Z3_API Z3_incremental_evaluator_dec_ref(Z3_context c, Z3_incremental_evaluator e);
+
+    /**
+       \brief Assign the value \c v to the constant \c a in the model of the evaluator.
+       The values of the expressions are updated by the next call to #Z3_incremental_evaluator_get_value.
+
+       \pre Z3_get_arity(c, a) == 0
+       \pre the sort of \c v is the range of \c a
+
+       def_API('Z3_incremental_evaluator_set_const_interp', VOID, (_in(CONTEXT), _in(INCREMENTAL_EVALUATOR), _in(FUNC_DECL), _in(AST)))
+    */
+    void Z3_API Z3_incremental_evaluator_set_const_interp(Z3_context c, Z3_incremental_evaluator e, Z3_func_decl a, Z3_ast v);
+
+    /**
+       \brief Return the number of expressions of the evaluator.
+
+       def_API('Z3_incremental_evaluator_get_num_exprs', UINT, (_in(CONTEXT), _in(INCREMENTAL_EVALUATOR)))
+    */
+    unsigned Z3_API Z3_incremental_evaluator_get_num_exprs(Z3_context c, Z3_incremental_evaluator e);
+
+    /**
+       \brief Return the value of the i-th expression of the evaluator in its current model.
+
+       \pre i < Z3_incremental_evaluator_get_num_exprs(c, e)
+
+       def_API('Z3_incremental_evaluator_get_value', AST, (_in(CONTEXT), _in(INCREMENTAL_EVALUATOR), _in(UINT)))
+    */
+    Z3_ast Z3_API Z3_incremental_evaluator_get_value(Z3_context c, Z3_incremental_evaluator e, unsigned i);
+
+    /**
+       \brief Return a copy of the current model of the evaluator.
+       Later calls to #Z3_incremental_evaluator_set_const_interp do not affect the returned model.
+
+       def_API('Z3_incremental_evaluator_get_model', MODEL, (_in(CONTEXT), _in(INCREMENTAL_EVALUATOR)))
+    */
+    Z3_model Z3_API Z3_incremental_evaluator_get_model(Z3_context c, Z3_incremental_evaluator e);
     /*@}*/
 
     /** @name Interaction logging */
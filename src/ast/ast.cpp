@@ -25,6 +25,13 @@ Revision History:
 #include"string_buffer.h"
 #include"ast_util.h"
 #include"ast_smt2_pp.h"
+#include"z3_omp.h"
+#include"statistics.h"
+#include"stopwatch.h"
+#include"rewrite_cache.h"
+#ifdef _MSC_VER
+#include<intrin.h>
+#endif
 
 // -----------------------------------
 //
@@ -1301,6 +1308,76 @@ decl_plugin * user_sort_plugin::mk_fresh() {
 //
 // -----------------------------------
 
+/**
+   \brief Data-structures used in concurrent mode.
+*/
+struct ast_manager::concurrent_state {
+    static const unsigned NUM_SHARDS     = 16;
+    static const unsigned NUM_ALLOCATORS = 16; // must fit in ast::m_alloc_idx
+    ast_table                m_tables[NUM_SHARDS];
+    omp_nest_lock_t          m_table_locks[NUM_SHARDS];
+    // m_allocators[0] is the allocator of the manager.
+    small_object_allocator * m_allocators[NUM_ALLOCATORS];
+    omp_nest_lock_t          m_allocator_locks[NUM_ALLOCATORS];
+    // Locks are acquired in the following order: m_plugin_lock, m_table_locks, m_id_lock.
+    omp_nest_lock_t          m_plugin_lock;   // serializes the invocations of decl plugins.
+    omp_nest_lock_t          m_id_lock;       // protects id generators and fresh ids.
+    omp_nest_lock_t          m_pending_lock;  // protects m_pending
+    ptr_vector<ast>          m_pending;       // nodes whose reference counter reached zero.
+
+    concurrent_state(small_object_allocator & a) {
+        m_allocators[0] = &a;
+        for (unsigned i = 1; i < NUM_ALLOCATORS; i++)
+            m_allocators[i] = alloc(small_object_allocator, "ast_manager");
+        for (unsigned i = 0; i < NUM_SHARDS; i++)
+            omp_init_nest_lock(&m_table_locks[i]);
+        for (unsigned i = 0; i < NUM_ALLOCATORS; i++)
+            omp_init_nest_lock(&m_allocator_locks[i]);
+        omp_init_nest_lock(&m_plugin_lock);
+        omp_init_nest_lock(&m_id_lock);
+        omp_init_nest_lock(&m_pending_lock);
+    }
+
+    ~concurrent_state() {
+        for (unsigned i = 1; i < NUM_ALLOCATORS; i++)
+            dealloc(m_allocators[i]);
+        for (unsigned i = 0; i < NUM_SHARDS; i++)
+            omp_destroy_nest_lock(&m_table_locks[i]);
+        for (unsigned i = 0; i < NUM_ALLOCATORS; i++)
+            omp_destroy_nest_lock(&m_allocator_locks[i]);
+        omp_destroy_nest_lock(&m_plugin_lock);
+        omp_destroy_nest_lock(&m_id_lock);
+        omp_destroy_nest_lock(&m_pending_lock);
+    }
+
+    static unsigned shard_of(unsigned h) { 
+        // the low bits of h are used by the tables, so the high bits of a multiplicative hash are used here.
+        return (h * 2654435761u) >> 28; 
+    }
+
+    // Threads with different numbers use different allocators. 
+    // The allocators are protected by locks, since the thread numbers are not unique when parallel regions are nested.
+    static unsigned allocator_of_current_thread() {
+        return static_cast<unsigned>(omp_get_thread_num()) % NUM_ALLOCATORS;
+    }
+};
+
+/**
+   \brief Acquire the given lock if it is not 0.
+*/
+class scoped_ast_lock {
+    omp_nest_lock_t * m_lock;
+public:
+    scoped_ast_lock(omp_nest_lock_t * l):m_lock(l) {
+        if (m_lock)
+            omp_set_nest_lock(m_lock);
+    }
+    ~scoped_ast_lock() {
+        if (m_lock)
+            omp_unset_nest_lock(m_lock);
+    }
+};
+
 ast_manager::ast_manager(proof_gen_mode m, char const * trace_file, bool is_format_manager):
     m_alloc("ast_manager"),
     m_expr_array_manager(*this, m_alloc),
@@ -1353,6 +1430,10 @@ ast_manager::ast_manager(ast_manager const & src, bool disable_proofs):
 }
 
 void ast_manager::init() {
+    m_cstate     = 0;
+    m_concurrent = false;
+    m_deferred_batch = 0;
+    m_rewrite_cache = 0;
     m_int_real_coercions = true;
     m_debug_ref_count = false;
     m_fresh_id = 0;
@@ -1385,6 +1466,9 @@ void ast_manager::init() {
 
 ast_manager::~ast_manager() {
     SASSERT(is_format_manager() || !m_family_manager.has_family(symbol("format")));
+    disable_concurrency();
+    set_rewrite_cache_size(0);
+    disable_deferred_deletion();
 
     dec_ref(m_bool_sort);
     dec_ref(m_proof_sort);
@@ -1403,8 +1487,8 @@ ast_manager::~ast_manager() {
             dealloc(*it);
     }
     DEBUG_CODE({
-        if (!m_ast_table.empty()) 
-            std::cout << "ast_manager LEAKED: " << m_ast_table.size() << std::endl;
+        if (get_num_asts() != 0) 
+            std::cout << "ast_manager LEAKED: " << get_num_asts() << std::endl;
     });
 #if 1
     DEBUG_CODE({
@@ -1431,24 +1515,257 @@ ast_manager::~ast_manager() {
         dealloc(m_trace_stream);
         m_trace_stream = 0;
     }
+    if (m_cstate)
+        dealloc(m_cstate);
 }
 
-void ast_manager::compact_memory() {
-    m_alloc.consolidate();
-    unsigned capacity = m_ast_table.capacity();
-    if (capacity > 4*m_ast_table.size()) {
-        ast_table new_ast_table;           
-        ast_table::iterator it  = m_ast_table.begin();
-        ast_table::iterator end = m_ast_table.end();
-        for (; it != end; ++it) {
-            new_ast_table.insert(*it);
+unsigned ast_manager::num_ast_tables() const {
+    return m_concurrent ? concurrent_state::NUM_SHARDS : 1;
+}
+
+ast_table & ast_manager::get_ast_table(unsigned idx) const {
+    SASSERT(idx < num_ast_tables());
+    if (m_concurrent)
+        return m_cstate->m_tables[idx];
+    return const_cast<ast_table&>(m_ast_table);
+}
+
+ast_table & ast_manager::get_ast_table_of(unsigned h) const {
+    if (m_concurrent)
+        return m_cstate->m_tables[concurrent_state::shard_of(h)];
+    return const_cast<ast_table&>(m_ast_table);
+}
+
+bool ast_manager::contains(ast * a) const { 
+    scoped_ast_lock lock(m_concurrent ? &m_cstate->m_table_locks[concurrent_state::shard_of(a->hash())] : 0);
+    return get_ast_table_of(a->hash()).contains(a);
+}
+
+unsigned ast_manager::get_num_asts() const { 
+    unsigned r = 0;
+    for (unsigned i = 0; i < num_ast_tables(); i++)
+        r += get_ast_table(i).size();
+    return r;
+}
+
+size_t ast_manager::get_allocation_size() const {
+    if (m_cstate == 0)
+        return m_alloc.get_allocation_size(); 
+    // Nodes may be deleted using a different allocator. So, only the sum is meaningful.
+    size_t r = 0;
+    for (unsigned i = 0; i < concurrent_state::NUM_ALLOCATORS; i++)
+        r += m_cstate->m_allocators[i]->get_allocation_size();
+    return r;
+}
+
+void ast_manager::enable_concurrency() {
+    if (m_concurrent)
+        return;
+    // dec_ref does not queue nodes in concurrent mode.
+    reclaim_deferred(UINT_MAX);
+    if (m_cstate == 0)
+        m_cstate = alloc(concurrent_state, m_alloc);
+    ast_table::iterator it  = m_ast_table.begin();
+    ast_table::iterator end = m_ast_table.end();
+    for (; it != end; ++it) 
+        m_cstate->m_tables[concurrent_state::shard_of((*it)->hash())].insert(*it);
+    m_ast_table.finalize();
+    m_concurrent = true;
+}
+
+void ast_manager::disable_concurrency() {
+    if (!m_concurrent)
+        return;
+    collect_garbage();
+    for (unsigned i = 0; i < concurrent_state::NUM_SHARDS; i++) {
+        ast_table & t = m_cstate->m_tables[i];
+        ast_table::iterator it  = t.begin();
+        ast_table::iterator end = t.end();
+        for (; it != end; ++it) 
+            m_ast_table.insert(*it);
+        t.finalize();
+    }
+    m_concurrent = false;
+}
+
+void ast_manager::collect_garbage() {
+    reclaim_deferred(UINT_MAX);
+    if (m_cstate == 0)
+        return;
+    ptr_vector<ast> & todo = m_cstate->m_pending;
+    ptr_vector<ast> nodes;
+    while (!todo.empty()) {
+        nodes.reset();
+        nodes.swap(todo);
+        // A node may occur more than once, and it may have been referenced again after being added.
+        std::sort(nodes.begin(), nodes.end());
+        ptr_vector<ast>::iterator it = std::unique(nodes.begin(), nodes.end());
+        nodes.shrink(static_cast<unsigned>(it - nodes.begin()));
+        unsigned j = 0;
+        for (unsigned i = 0; i < nodes.size(); i++) {
+            if (nodes[i]->get_ref_count() == 0)
+                nodes[j++] = nodes[i];
         }
-        m_ast_table.swap(new_ast_table);
-        IF_VERBOSE(10, verbose_stream() << "(ast-table :prev-capacity " << capacity 
-                   << " :capacity " << m_ast_table.capacity() << " :size " << m_ast_table.size() << ")\n";);
+        nodes.shrink(j);
+        TRACE("ast_collect_garbage", tout << "deleting " << nodes.size() << " nodes\n";);
+        // The remaining nodes are not referenced. So, deleting one of them does not delete another one.
+        // delete_node may add new nodes to todo (e.g., parameters of declarations).
+        for (unsigned i = 0; i < nodes.size(); i++) 
+            delete_node(nodes[i]);
+    }
+}
+
+void ast_manager::enable_deferred_deletion(unsigned batch) {
+    m_deferred_batch = batch == 0 ? 1 : batch;
+}
+
+void ast_manager::disable_deferred_deletion() {
+    reclaim_deferred(UINT_MAX);
+    m_deferred_batch = 0;
+}
+
+void ast_manager::defer_node(ast * n) {
+    SASSERT(n->get_ref_count() == 0);
+    n->m_dead = true;
+    m_deferred_stats.m_num_deferred++;
+    if (!n->m_deferred) {
+        n->m_deferred = true;
+        m_deferred_todo.push_back(n);
+        if (m_deferred_todo.size() > m_deferred_stats.m_max_pending)
+            m_deferred_stats.m_max_pending = m_deferred_todo.size();
+    }
+}
+
+void ast_manager::reclaim_deferred(unsigned max_nodes) {
+    if (m_deferred_todo.empty())
+        return;
+    stopwatch timer;
+    timer.start();
+    ptr_buffer<ast> worklist;
+    unsigned num = 0;
+    // The queue is used as a stack: the children of a reclaimed node are reclaimed next.
+    while (num < max_nodes && !m_deferred_todo.empty()) {
+        ast * n = m_deferred_todo.back();
+        m_deferred_todo.pop_back();
+        n->m_deferred = false;
+        if (!n->m_dead) {
+            // n was reused after being queued.
+            continue;
+        }
+        SASSERT(n->get_ref_count() == 0);
+        delete_node_core(n, worklist);
+        num++;
+        for (unsigned i = 0; i < worklist.size(); i++)
+            defer_node(worklist[i]);
+        worklist.reset();
+    }
+    timer.stop();
+    double t = timer.get_seconds();
+    m_deferred_stats.m_num_reclaimed += num;
+    m_deferred_stats.m_num_pauses++;
+    m_deferred_stats.m_time += t;
+    if (t > m_deferred_stats.m_max_pause)
+        m_deferred_stats.m_max_pause = t;
+    TRACE("ast_deferred", tout << "reclaimed " << num << " nodes, pending: " << m_deferred_todo.size() << "\n";);
+}
+
+void ast_manager::set_rewrite_cache_size(unsigned max_size) {
+    if (max_size == 0) {
+        if (m_rewrite_cache) {
+            dealloc(m_rewrite_cache);
+            m_rewrite_cache = 0;
+        }
+    }
+    else if (m_rewrite_cache) {
+        m_rewrite_cache->set_max_size(max_size);
     }
     else {
-        IF_VERBOSE(10, verbose_stream() << "(ast-table :capacity " << m_ast_table.capacity() << " :size " << m_ast_table.size() << ")\n";);
+        m_rewrite_cache = alloc(rewrite_cache, *this, max_size);
+    }
+}
+
+void ast_manager::collect_statistics(statistics & st) const {
+    if (m_deferred_stats.m_num_deferred > 0) {
+        st.update("ast deferred nodes", m_deferred_stats.m_num_deferred);
+        st.update("ast reclaimed nodes", m_deferred_stats.m_num_reclaimed);
+        st.update("ast max pending nodes", m_deferred_stats.m_max_pending);
+        st.update("ast reclaim pauses", m_deferred_stats.m_num_pauses);
+        st.update("ast reclaim time", m_deferred_stats.m_time);
+        st.update("ast max reclaim pause", m_deferred_stats.m_max_pause);
+    }
+    if (m_rewrite_cache)
+        m_rewrite_cache->collect_statistics(st);
+}
+
+void ast_manager::reset_statistics() {
+    m_deferred_stats.reset();
+    if (m_rewrite_cache)
+        m_rewrite_cache->reset_statistics();
+}
+
+void ast_manager::inc_ref_concurrent(ast * n) {
+#ifdef _MSC_VER
+    _InterlockedIncrement(reinterpret_cast<long volatile *>(&n->m_ref_count));
+#else
+    __sync_add_and_fetch(&n->m_ref_count, 1u);
+#endif
+}
+
+void ast_manager::dec_ref_concurrent(ast * n) {
+    SASSERT(n->get_ref_count() > 0);
+#ifdef _MSC_VER
+    unsigned r = static_cast<unsigned>(_InterlockedDecrement(reinterpret_cast<long volatile *>(&n->m_ref_count)));
+#else
+    unsigned r = __sync_sub_and_fetch(&n->m_ref_count, 1u);
+#endif
+    if (r == 0) {
+        scoped_ast_lock lock(&m_cstate->m_pending_lock);
+        m_cstate->m_pending.push_back(n);
+    }
+}
+
+void * ast_manager::allocate_node_concurrent(unsigned size) {
+    unsigned idx = concurrent_state::allocator_of_current_thread();
+    scoped_ast_lock lock(&m_cstate->m_allocator_locks[idx]);
+    return m_cstate->m_allocators[idx]->allocate(size);
+}
+
+void ast_manager::deallocate_node_concurrent(ast * n, unsigned sz) {
+    unsigned idx = concurrent_state::allocator_of_current_thread();
+    scoped_ast_lock lock(&m_cstate->m_allocator_locks[idx]);
+    m_cstate->m_allocators[idx]->deallocate(sz, n);
+}
+
+unsigned ast_manager::mk_fresh_id() {
+    scoped_ast_lock lock(m_concurrent ? &m_cstate->m_id_lock : 0);
+    return m_fresh_id++;
+}
+
+void ast_manager::compact_memory() {
+    if (m_cstate) {
+        for (unsigned i = 0; i < concurrent_state::NUM_ALLOCATORS; i++)
+            m_cstate->m_allocators[i]->consolidate();
+    }
+    else {
+        m_alloc.consolidate();
+    }
+    for (unsigned i = 0; i < num_ast_tables(); i++) {
+        ast_table & table = get_ast_table(i);
+        unsigned capacity = table.capacity();
+        if (capacity > 4*table.size()) {
+            ast_table new_ast_table;           
+            ast_table::iterator it  = table.begin();
+            ast_table::iterator end = table.end();
+            for (; it != end; ++it) {
+                new_ast_table.insert(*it);
+            }
+            table.swap(new_ast_table);
+            IF_VERBOSE(10, verbose_stream() << "(ast-table :prev-capacity " << capacity 
+                       << " :capacity " << table.capacity() << " :size " << table.size() << ")\n";);
+        }
+        else {
+            IF_VERBOSE(10, verbose_stream() << "(ast-table :capacity " << table.capacity() << " :size " << table.size() << ")\n";);
+        }
     }
 }
 
@@ -1456,21 +1773,24 @@ void ast_manager::compress_ids() {
     ptr_vector<ast> asts;
     m_expr_id_gen.cleanup();
     m_decl_id_gen.cleanup(c_first_decl_id);
-    ast_table::iterator it  = m_ast_table.begin();
-    ast_table::iterator end = m_ast_table.end();
-    for (; it != end; ++it) {
-        ast * n = *it;
-        if (is_decl(n))
-            n->m_id = m_decl_id_gen.mk();
-        else
-            n->m_id = m_expr_id_gen.mk();
-        asts.push_back(n);
+    for (unsigned i = 0; i < num_ast_tables(); i++) {
+        ast_table & table = get_ast_table(i);
+        ast_table::iterator it  = table.begin();
+        ast_table::iterator end = table.end();
+        for (; it != end; ++it) {
+            ast * n = *it;
+            if (is_decl(n))
+                n->m_id = m_decl_id_gen.mk();
+            else
+                n->m_id = m_expr_id_gen.mk();
+            asts.push_back(n);
+        }
+        table.finalize();
     }
-    m_ast_table.finalize();
     ptr_vector<ast>::iterator it2  = asts.begin();
     ptr_vector<ast>::iterator end2 = asts.end();
     for (; it2 != end2; ++it2)
-        m_ast_table.insert(*it2);
+        get_ast_table_of((*it2)->hash()).insert(*it2);
 }
 
 void ast_manager::raise_exception(char const * msg) {
@@ -1511,14 +1831,20 @@ void ast_manager::copy_families_plugins(ast_manager const & from) {
 void ast_manager::set_next_expr_id(unsigned id) {
     while (true) {
         id = m_expr_id_gen.set_next_id(id);
-        ast_table::iterator it  = m_ast_table.begin();
-        ast_table::iterator end = m_ast_table.end();
-        for (; it != end; ++it) {
-            ast * curr = *it;
-            if (curr->get_id() == id)
-                break;
+        bool in_use = false;
+        for (unsigned i = 0; i < num_ast_tables() && !in_use; i++) {
+            ast_table & table = get_ast_table(i);
+            ast_table::iterator it  = table.begin();
+            ast_table::iterator end = table.end();
+            for (; it != end; ++it) {
+                ast * curr = *it;
+                if (curr->get_id() == id) {
+                    in_use = true;
+                    break;
+                }
+            }
         }
-        if (it == end)
+        if (!in_use)
             return;
         // id is in use, move to the next one.
         id++; 
@@ -1592,8 +1918,10 @@ bool ast_manager::is_bool(expr const * n) const {
 
 #ifdef Z3DEBUG
 bool ast_manager::slow_not_contains(ast const * n) {
-    ast_table::iterator it  = m_ast_table.begin();
-    ast_table::iterator end = m_ast_table.end();
+    // equal nodes have the same hash code, so they are in the same table.
+    ast_table & table = get_ast_table_of(n->hash());
+    ast_table::iterator it  = table.begin();
+    ast_table::iterator end = table.end();
     unsigned num = 0;
     for (; it != end; ++it) {
         ast * curr = *it;
@@ -1609,7 +1937,7 @@ bool ast_manager::slow_not_contains(ast const * n) {
                   to_app(curr)->get_num_args() == 0));
         num++;
     }
-    SASSERT(num == m_ast_table.size());
+    SASSERT(num == table.size());
     return true;
 }
 #endif
@@ -1617,8 +1945,11 @@ bool ast_manager::slow_not_contains(ast const * n) {
 ast * ast_manager::register_node_core(ast * n) {
     unsigned h = get_node_hash(n); 
     n->m_hash = h;
+    // In concurrent mode, the shard is locked until n is fully initialized.
+    scoped_ast_lock lock(m_concurrent ? &m_cstate->m_table_locks[concurrent_state::shard_of(h)] : 0);
+    ast_table & table = get_ast_table_of(h);
 #ifdef Z3DEBUG
-    bool contains = m_ast_table.contains(n);
+    bool contains = table.contains(n);
     CASSERT("nondet_bug", contains || slow_not_contains(n));
 #endif
 
@@ -1626,10 +1957,10 @@ ast * ast_manager::register_node_core(ast * n) {
     static unsigned counter = 0;
     counter++;
     if (counter % 100000 == 0)
-        verbose_stream() << "[ast-table] counter: " << counter << " collisions: " << m_ast_table.collisions() << " capacity: " << m_ast_table.capacity() << " size: " << m_ast_table.size() << "\n";
+        verbose_stream() << "[ast-table] counter: " << counter << " collisions: " << table.collisions() << " capacity: " << table.capacity() << " size: " << table.size() << "\n";
 #endif
 
-    ast * r = m_ast_table.insert_if_not_there(n);
+    ast * r = table.insert_if_not_there(n);
     SASSERT(r->m_hash == h);
     if (r != n) {
 #if 0
@@ -1639,7 +1970,7 @@ ast * ast_manager::register_node_core(ast * n) {
             verbose_stream() << "[ast-table] reused: " << reused << "\n";
 #endif
         SASSERT(contains);
-        SASSERT(m_ast_table.contains(n));
+        SASSERT(table.contains(n));
         if (is_func_decl(r) && to_func_decl(r)->get_range() != to_func_decl(n)->get_range()) {
             std::ostringstream buffer;
             buffer << "Recycling of declaration for the same name '" << to_func_decl(r)->get_name().str().c_str() << "'"
@@ -1647,14 +1978,26 @@ ast * ast_manager::register_node_core(ast * n) {
             throw ast_exception(buffer.str().c_str());
         }
         deallocate_node(n, ::get_node_size(n));
+        if (r->m_dead) {
+            // r is in the queue of deferred deletion, but it is being reused.
+            SASSERT(r->get_ref_count() == 0);
+            r->m_dead = false;
+        }
         return r;
     }
     else {
         SASSERT(!contains);
-        SASSERT(m_ast_table.contains(n));
+        SASSERT(table.contains(n));
     }
 
-    n->m_id   = is_decl(n) ? m_decl_id_gen.mk() : m_expr_id_gen.mk();
+    if (m_concurrent) {
+        n->m_alloc_idx = concurrent_state::allocator_of_current_thread();
+        scoped_ast_lock id_lock(&m_cstate->m_id_lock);
+        n->m_id   = is_decl(n) ? m_decl_id_gen.mk() : m_expr_id_gen.mk();
+    }
+    else {
+        n->m_id   = is_decl(n) ? m_decl_id_gen.mk() : m_expr_id_gen.mk();
+    }
 
     TRACE("ast", tout << "Object " << n->m_id << " was created.\n";);
     TRACE("mk_var_bug", tout << "mk_ast: " << n->m_id << "\n";);
@@ -1749,67 +2092,78 @@ void ast_manager::delete_node(ast * n) {
     while (!worklist.empty()) {
         n = worklist.back();
         worklist.pop_back();
-        
-        TRACE("ast", tout << "Deleting object " << n->m_id << " " << n << "\n";);
-        CTRACE("del_quantifier", is_quantifier(n), tout << "deleting quantifier " << n->m_id << " " << n << "\n";);
-        TRACE("mk_var_bug", tout << "del_ast: " << n->m_id << "\n";);
-        TRACE("ast_delete_node", tout << mk_bounded_pp(n, *this) << "\n";);
+        delete_node_core(n, worklist);
+    }
+}
 
-        SASSERT(m_ast_table.contains(n));
-        m_ast_table.erase(n);
-        SASSERT(!m_ast_table.contains(n));
-        SASSERT(!m_debug_ref_count || !m_debug_free_indices.contains(n->m_id));
+/**
+   \brief Delete n, and store in worklist its children whose reference counter reached zero.
+*/
+void ast_manager::delete_node_core(ast * n, ptr_buffer<ast> & worklist) {
+    TRACE("ast", tout << "Deleting object " << n->m_id << " " << n << "\n";);
+    CTRACE("del_quantifier", is_quantifier(n), tout << "deleting quantifier " << n->m_id << " " << n << "\n";);
+    TRACE("mk_var_bug", tout << "del_ast: " << n->m_id << "\n";);
+    TRACE("ast_delete_node", tout << mk_bounded_pp(n, *this) << "\n";);
+
+    ast_table & table = get_ast_table_of(n->hash());
+    SASSERT(table.contains(n));
+    table.erase(n);
+    SASSERT(!table.contains(n));
+    SASSERT(!m_debug_ref_count || !m_debug_free_indices.contains(n->m_id));
 
 #ifdef RECYCLE_FREE_AST_INDICES
-        if (!m_debug_ref_count) {
-            if (is_decl(n))
-                m_decl_id_gen.recycle(n->m_id);
-            else 
-                m_expr_id_gen.recycle(n->m_id);
-        }
+    if (!m_debug_ref_count) {
+        if (is_decl(n))
+            m_decl_id_gen.recycle(n->m_id);
+        else 
+            m_expr_id_gen.recycle(n->m_id);
+    }
 #endif
-        switch (n->get_kind()) {
-        case AST_SORT:
-            if (to_sort(n)->m_info != 0 && !m_debug_ref_count) { 
-                sort_info * info = to_sort(n)->get_info();
-                info->del_eh(*this);
-                dealloc(info); 
-            }
-            break;
-        case AST_FUNC_DECL:
-            if (to_func_decl(n)->m_info != 0 && !m_debug_ref_count) { 
-                func_decl_info * info = to_func_decl(n)->get_info();
-                info->del_eh(*this);
-                dealloc(info);
-            }
-            dec_array_ref(worklist, to_func_decl(n)->get_arity(), to_func_decl(n)->get_domain());
-            dec_ref(worklist, to_func_decl(n)->get_range());
-            break;
-        case AST_APP:
-            dec_ref(worklist, to_app(n)->get_decl());
-            dec_array_ref(worklist, to_app(n)->get_num_args(), to_app(n)->get_args());
-            break;
-        case AST_VAR:
-            dec_ref(worklist, to_var(n)->get_sort());
-            break;
-        case AST_QUANTIFIER:
-            dec_array_ref(worklist, to_quantifier(n)->get_num_decls(), to_quantifier(n)->get_decl_sorts());
-            dec_ref(worklist, to_quantifier(n)->get_expr());
-            dec_array_ref(worklist, to_quantifier(n)->get_num_patterns(), to_quantifier(n)->get_patterns());
-            dec_array_ref(worklist, to_quantifier(n)->get_num_no_patterns(), to_quantifier(n)->get_no_patterns());
-            break;
-    default:
-        break;
+    switch (n->get_kind()) {
+    case AST_SORT:
+        if (to_sort(n)->m_info != 0 && !m_debug_ref_count) { 
+            sort_info * info = to_sort(n)->get_info();
+            info->del_eh(*this);
+            dealloc(info); 
         }
-        if (m_debug_ref_count) {
-            m_debug_free_indices.insert(n->m_id,0);
+        break;
+    case AST_FUNC_DECL:
+        if (to_func_decl(n)->m_info != 0 && !m_debug_ref_count) { 
+            func_decl_info * info = to_func_decl(n)->get_info();
+            info->del_eh(*this);
+            dealloc(info);
         }
-        deallocate_node(n, ::get_node_size(n));
+        dec_array_ref(worklist, to_func_decl(n)->get_arity(), to_func_decl(n)->get_domain());
+        dec_ref(worklist, to_func_decl(n)->get_range());
+        break;
+    case AST_APP:
+        dec_ref(worklist, to_app(n)->get_decl());
+        dec_array_ref(worklist, to_app(n)->get_num_args(), to_app(n)->get_args());
+        break;
+    case AST_VAR:
+        dec_ref(worklist, to_var(n)->get_sort());
+        break;
+    case AST_QUANTIFIER:
+        dec_array_ref(worklist, to_quantifier(n)->get_num_decls(), to_quantifier(n)->get_decl_sorts());
+        dec_ref(worklist, to_quantifier(n)->get_expr());
+        dec_array_ref(worklist, to_quantifier(n)->get_num_patterns(), to_quantifier(n)->get_patterns());
+        dec_array_ref(worklist, to_quantifier(n)->get_num_no_patterns(), to_quantifier(n)->get_no_patterns());
+        break;
+    default:
+        break;
+    }
+    if (m_debug_ref_count) {
+        m_debug_free_indices.insert(n->m_id,0);
     }
+    if (m_cstate)
+        m_cstate->m_allocators[n->m_alloc_idx]->deallocate(::get_node_size(n), n);
+    else
+        deallocate_node(n, ::get_node_size(n));
 }
 
 sort * ast_manager::mk_sort(family_id fid, decl_kind k, unsigned num_parameters, parameter const * parameters) {
     decl_plugin * p = get_plugin(fid);
+    scoped_ast_lock lock(m_concurrent ? &m_cstate->m_plugin_lock : 0);
     if (p)
         return p->mk_sort(k, num_parameters, parameters);
     return 0;
@@ -1818,6 +2172,7 @@ sort * ast_manager::mk_sort(family_id fid, decl_kind k, unsigned num_parameters,
 func_decl * ast_manager::mk_func_decl(family_id fid, decl_kind k, unsigned num_parameters, parameter const * parameters,
                                       unsigned arity, sort * const * domain, sort * range) {
     decl_plugin * p = get_plugin(fid);
+    scoped_ast_lock lock(m_concurrent ? &m_cstate->m_plugin_lock : 0);
     if (p)
         return p->mk_func_decl(k, num_parameters, parameters, arity, domain, range);
     return 0;
@@ -1826,6 +2181,7 @@ func_decl * ast_manager::mk_func_decl(family_id fid, decl_kind k, unsigned num_p
 func_decl * ast_manager::mk_func_decl(family_id fid, decl_kind k, unsigned num_parameters, parameter const * parameters, 
                                       unsigned num_args, expr * const * args, sort * range) {
     decl_plugin * p = get_plugin(fid);
+    scoped_ast_lock lock(m_concurrent ? &m_cstate->m_plugin_lock : 0);
     if (p)
         return p->mk_func_decl(k, num_parameters, parameters, num_args, args, range);
     return 0;
@@ -2146,8 +2502,9 @@ func_decl * ast_manager::mk_fresh_func_decl(symbol const & prefix, symbol const
     info.m_skolem = true;
     SASSERT(info.is_skolem());
     func_decl * d;
+    unsigned id = mk_fresh_id();
     if (prefix == symbol::null && suffix == symbol::null) {
-        d = mk_func_decl(symbol(m_fresh_id), arity, domain, range, &info);
+        d = mk_func_decl(symbol(id), arity, domain, range, &info);
     }
     else {
         string_buffer<64> buffer;
@@ -2157,10 +2514,9 @@ func_decl * ast_manager::mk_fresh_func_decl(symbol const & prefix, symbol const
         buffer << "!";
         if (suffix != symbol::null)
             buffer << suffix << "!";
-        buffer << m_fresh_id;
+        buffer << id;
         d = mk_func_decl(symbol(buffer.c_str()), arity, domain, range, &info);
     }
-    m_fresh_id++;
     SASSERT(d->get_info());
     SASSERT(d->is_skolem());
     return d;
@@ -2168,15 +2524,13 @@ func_decl * ast_manager::mk_fresh_func_decl(symbol const & prefix, symbol const
 
 sort * ast_manager::mk_fresh_sort(char const * prefix) {
     string_buffer<32> buffer;
-    buffer << prefix << "!" << m_fresh_id;
-    m_fresh_id++;
+    buffer << prefix << "!" << mk_fresh_id();
     return mk_uninterpreted_sort(symbol(buffer.c_str()));
 }
 
 symbol ast_manager::mk_fresh_var_name(char const * prefix) {
     string_buffer<32> buffer;
-    buffer << (prefix ? prefix : "var") << "!" << m_fresh_id;
-    m_fresh_id++;
+    buffer << (prefix ? prefix : "var") << "!" << mk_fresh_id();
     return symbol(buffer.c_str());
 }
 
@@ -55,6 +55,8 @@ Revision History:
 
 class ast;
 class ast_manager;
+class statistics;
+class rewrite_cache;
 
 /**
    \brief Generic exception for AST related errors.
@@ -436,6 +438,11 @@ protected:
     void mark_so(bool flag) { m_mark_shared_occs = flag; }
     void reset_mark_so() { m_mark_shared_occs = false; }
     bool is_marked_so() const { return m_mark_shared_occs; }
+    // Allocator used to create this node in concurrent mode (see ast_manager::enable_concurrency).
+    unsigned m_alloc_idx:4;
+    // Deferred deletion (see ast_manager::enable_deferred_deletion).
+    unsigned m_deferred:1; // node is in the queue of nodes to be reclaimed.
+    unsigned m_dead:1;     // reference counter reached zero, and the node was not reused since then.
     unsigned m_ref_count;
     unsigned m_hash;
 #ifdef Z3DEBUG
@@ -454,7 +461,7 @@ protected:
         m_ref_count --; 
     }
     
-    ast(ast_kind k):m_id(UINT_MAX), m_kind(k), m_mark1(false), m_mark2(false), m_mark_shared_occs(false), m_ref_count(0) {
+    ast(ast_kind k):m_id(UINT_MAX), m_kind(k), m_mark1(false), m_mark2(false), m_mark_shared_occs(false), m_alloc_idx(0), m_deferred(false), m_dead(false), m_ref_count(0) {
         DEBUG_CODE({
             m_mark1_owner = 0;
             m_mark2_owner = 0;
@@ -1440,6 +1447,23 @@ protected:
     family_id                 m_user_sort_family_id;
     family_id                 m_arith_family_id;
     ast_table                 m_ast_table;       
+    struct concurrent_state;
+    concurrent_state *        m_cstate;          // created by the first invocation of enable_concurrency().
+    bool                      m_concurrent;      // true if the concurrent mode is enabled.
+    unsigned                  m_deferred_batch;  // 0 if deferred deletion is disabled.
+    ptr_vector<ast>           m_deferred_todo;   // nodes to be reclaimed when deferred deletion is enabled.
+    struct deferred_stats {
+        unsigned m_num_deferred;
+        unsigned m_num_reclaimed;
+        unsigned m_max_pending;
+        unsigned m_num_pauses;
+        double   m_time;
+        double   m_max_pause;
+        deferred_stats() { reset(); }
+        void reset() { m_num_deferred = m_num_reclaimed = m_max_pending = m_num_pauses = 0; m_time = m_max_pause = 0.0; }
+    };
+    deferred_stats            m_deferred_stats;
+    rewrite_cache *           m_rewrite_cache;   // shared by rewriters, see set_rewrite_cache_size.
     id_gen                    m_expr_id_gen;
     id_gen                    m_decl_id_gen;
     sort *                    m_bool_sort;
@@ -1560,22 +1584,104 @@ public:
     
     bool are_distinct(expr * a, expr * b) const;
     
-    bool contains(ast * a) const { return m_ast_table.contains(a); }
+    bool contains(ast * a) const;
     
-    unsigned get_num_asts() const { return m_ast_table.size(); }
+    unsigned get_num_asts() const;
 
     void debug_ref_count() { m_debug_ref_count = true; }
+
+    /**
+       \brief Enable the concurrent mode. In this mode, several (OpenMP) threads can create terms
+       and update reference counters using the same manager. Thus, they can share one term DAG
+       without using ast_translation.
+
+       - The hash-consing table is split in shards, each one protected by its own lock.
+       - Reference counters are updated using atomic operations.
+       - Nodes are created using per-thread allocators.
+       - A node whose reference counter reaches zero is not deleted immediately.
+         It is only reclaimed by collect_garbage().
+
+       Decl plugins are not thread safe. The methods that access them using a family id
+       (e.g., mk_sort(fid, ...), mk_func_decl(fid, ...) and mk_app(fid, ...)) are serialized,
+       but utilities that invoke plugins directly are not.
+       The ast marks, the trace stream, expression arrays and dependencies must not be used concurrently.
+
+       This method must be invoked when no other thread is using the manager.
+    */
+    void enable_concurrency();
+
+    /**
+       \brief Disable the concurrent mode, and reclaim the nodes that are not referenced anymore.
+       This method must be invoked when no other thread is using the manager.
+    */
+    void disable_concurrency();
+
+    bool concurrency_enabled() const { return m_concurrent; }
+
+    /**
+       \brief Delete the nodes whose reference counter reached zero in concurrent mode.
+       This method must be invoked when no other thread is using the manager.
+    */
+    void collect_garbage();
+
+    /**
+       \brief Enable deferred deletion. In this mode, a node whose reference counter reaches zero
+       is not deleted immediately (with all nodes it was keeping alive). Instead, it is added to a queue,
+       and at most \c batch nodes of the queue are reclaimed each time a new node is created.
+       Thus, dropping a big term does not produce a long pause.
+
+       A queued node that is created again (hash-consing) is not reclaimed.
+       collect_garbage() reclaims all queued nodes.
+    */
+    void enable_deferred_deletion(unsigned batch = 16);
+
+    /**
+       \brief Disable deferred deletion, and reclaim all queued nodes.
+    */
+    void disable_deferred_deletion();
+
+    bool deferred_deletion_enabled() const { return m_deferred_batch > 0; }
+
+    unsigned get_num_deferred() const { return m_deferred_todo.size(); }
+
+    /**
+       \brief Create a cache that rewriters (e.g., th_rewriter) use to share their results
+       between invocations and between instances. The cache contains at most \c max_size entries.
+       The cache is deleted if \c max_size is 0.
+       
+       The cache must not be used in concurrent mode, and rewriters created before
+       the cache do not use it.
+    */
+    void set_rewrite_cache_size(unsigned max_size);
+
+    rewrite_cache * get_rewrite_cache() const { return m_rewrite_cache; }
+
+    void collect_statistics(statistics & st) const;
+    void reset_statistics();
     
     void inc_ref(ast * n) { 
-        if (n)
-            n->inc_ref();
+        if (n) {
+            if (m_concurrent)
+                inc_ref_concurrent(n);
+            else
+                n->inc_ref();
+        }
     }
     
     void dec_ref(ast * n) {
         if (n) {
-            n->dec_ref();
-            if (n->get_ref_count() == 0)
-                delete_node(n);
+            if (m_concurrent) {
+                dec_ref_concurrent(n);
+            }
+            else {
+                n->dec_ref();
+                if (n->get_ref_count() == 0) {
+                    if (m_deferred_batch > 0)
+                        defer_node(n);
+                    else
+                        delete_node(n);
+                }
+            }
         }
     }
     
@@ -1595,11 +1701,18 @@ public:
     
     static unsigned get_node_size(ast const * n);
     
-    size_t get_allocation_size() const { 
-        return m_alloc.get_allocation_size(); 
-    }
+    size_t get_allocation_size() const;
     
 protected:
+    void inc_ref_concurrent(ast * n);
+    void dec_ref_concurrent(ast * n);
+    unsigned num_ast_tables() const;
+    ast_table & get_ast_table(unsigned idx) const;
+    ast_table & get_ast_table_of(unsigned h) const;
+    unsigned mk_fresh_id();
+    void * allocate_node_concurrent(unsigned size);
+    void deallocate_node_concurrent(ast * n, unsigned sz);
+
     ast * register_node_core(ast * n);
     
     template<typename T>
@@ -1608,13 +1721,27 @@ protected:
     }
     
     void delete_node(ast * n);
+
+    void delete_node_core(ast * n, ptr_buffer<ast> & worklist);
+
+    void defer_node(ast * n);
+
+    void reclaim_deferred(unsigned max_nodes);
     
     void * allocate_node(unsigned size) { 
+        if (m_concurrent)
+            return allocate_node_concurrent(size);
+        if (!m_deferred_todo.empty())
+            reclaim_deferred(m_deferred_batch);
         return m_alloc.allocate(size);
     }
     
+    // Deallocate a node that was allocated by the current thread.
     void deallocate_node(ast * n, unsigned sz) {
-        m_alloc.deallocate(sz, n);
+        if (m_concurrent)
+            deallocate_node_concurrent(n, sz);
+        else
+            m_alloc.deallocate(sz, n);
     }
     
 public:
@@ -0,0 +1,106 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    rewrite_cache.cpp
+
+Abstract:
+
+    Cache for rewriting results that survives rewriter invocations.
+
+Author:
+
+Revision History:
+
+--*/
+#include"rewrite_cache.h"
+#include"statistics.h"
+
+rewrite_cache::rewrite_cache(ast_manager & m, unsigned max_size):
+    m_manager(m),
+    m_max_size(max_size < 2 ? 2 : max_size),
+    m_num_active(0),
+    m_table(hash_proc(this), eq_proc(this)) {
+}
+
+rewrite_cache::~rewrite_cache() {
+    reset();
+}
+
+expr * rewrite_cache::find(expr * k, unsigned cfg) {
+    m_probe = entry(k, cfg, 0);
+    unsigned probe = probe_idx;
+    unsigned idx;
+    if (m_table.find(probe, idx)) {
+        m_stats.m_num_hits++;
+        return m_entries[idx].m_value;
+    }
+    m_stats.m_num_misses++;
+    return 0;
+}
+
+void rewrite_cache::insert(expr * k, unsigned cfg, expr * v) {
+    if (m_entries.size() >= m_max_size && m_num_active == 0)
+        evict();
+    unsigned idx = m_entries.size();
+    m_entries.push_back(entry(k, cfg, v));
+    if (m_table.insert_if_not_there(idx) != idx) {
+        // k was already cached.
+        m_entries.pop_back();
+        return;
+    }
+    m_manager.inc_ref(k);
+    m_manager.inc_ref(v);
+}
+
+void rewrite_cache::rebuild_table() {
+    m_table.reset();
+    for (unsigned i = 0; i < m_entries.size(); i++)
+        m_table.insert(i);
+}
+
+void rewrite_cache::evict() {
+    unsigned num = m_entries.size() / 2;
+    TRACE("rewrite_cache", tout << "evicting " << num << " entries\n";);
+    for (unsigned i = 0; i < num; i++)
+        dec_ref(m_entries[i]);
+    unsigned j = 0;
+    for (unsigned i = num; i < m_entries.size(); i++)
+        m_entries[j++] = m_entries[i];
+    m_entries.shrink(j);
+    m_stats.m_num_evicted += num;
+    rebuild_table();
+}
+
+void rewrite_cache::shrink() {
+    if (m_num_active > 0)
+        return;
+    while (m_entries.size() > m_max_size)
+        evict();
+}
+
+void rewrite_cache::dec_active() {
+    SASSERT(m_num_active > 0);
+    m_num_active--;
+    shrink();
+}
+
+void rewrite_cache::reset() {
+    m_table.reset();
+    for (unsigned i = 0; i < m_entries.size(); i++)
+        dec_ref(m_entries[i]);
+    m_entries.reset();
+}
+
+void rewrite_cache::set_max_size(unsigned max_size) {
+    m_max_size = max_size < 2 ? 2 : max_size;
+    shrink();
+}
+
+void rewrite_cache::collect_statistics(statistics & st) const {
+    st.update("rewrite cache hits", m_stats.m_num_hits);
+    st.update("rewrite cache misses", m_stats.m_num_misses);
+    st.update("rewrite cache evicted", m_stats.m_num_evicted);
+    st.update("rewrite cache size", m_entries.size());
+}
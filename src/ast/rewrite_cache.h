@@ -0,0 +1,136 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    rewrite_cache.h
+
+Abstract:
+
+    Cache for rewriting results that survives rewriter invocations.
+
+    The cache is attached to an ast_manager (see ast_manager::set_rewrite_cache_size),
+    and it is shared by all rewriters that opt in (e.g., th_rewriter).
+    An entry is keyed on the id of the rewritten expression and on a
+    hash of the rewriter configuration. So, rewriters using different
+    parameters do not share results.
+
+    The number of entries is bounded. When the bound is reached, the
+    oldest half of the entries is discarded. Running rewriters keep raw
+    pointers to the results they obtain from the cache, so entries are
+    not discarded while a rewriter invocation is active (see
+    scoped_rewrite_cache_use). The bound may be exceeded until the
+    last active invocation finishes.
+
+    Stale entries (e.g., of rewriters whose parameters were updated) are
+    not removed eagerly, since another rewriter may be using the same
+    configuration. They are discarded by the eviction policy.
+
+Author:
+
+Revision History:
+
+--*/
+#ifndef REWRITE_CACHE_H_
+#define REWRITE_CACHE_H_
+
+#include"ast.h"
+#include"chashtable.h"
+
+class statistics;
+
+class rewrite_cache {
+    struct entry {
+        expr *   m_key;
+        expr *   m_value;
+        unsigned m_cfg;
+        entry() {}
+        entry(expr * k, unsigned cfg, expr * v):m_key(k), m_value(v), m_cfg(cfg) {}
+    };
+
+    static const unsigned probe_idx = UINT_MAX;
+
+    struct hash_proc {
+        rewrite_cache const * m_owner;
+        hash_proc(rewrite_cache const * o = 0):m_owner(o) {}
+        unsigned operator()(unsigned idx) const { 
+            entry const & e = m_owner->get_entry(idx);
+            return hash_u_u(e.m_key->get_id(), e.m_cfg); 
+        }
+    };
+
+    struct eq_proc {
+        rewrite_cache const * m_owner;
+        eq_proc(rewrite_cache const * o = 0):m_owner(o) {}
+        bool operator()(unsigned idx1, unsigned idx2) const { 
+            entry const & e1 = m_owner->get_entry(idx1);
+            entry const & e2 = m_owner->get_entry(idx2);
+            return e1.m_key == e2.m_key && e1.m_cfg == e2.m_cfg; 
+        }
+    };
+
+    typedef chashtable<unsigned, hash_proc, eq_proc> table;
+
+    struct stats {
+        unsigned m_num_hits;
+        unsigned m_num_misses;
+        unsigned m_num_evicted;
+        stats() { reset(); }
+        void reset() { m_num_hits = m_num_misses = m_num_evicted = 0; }
+    };
+
+    ast_manager &  m_manager;
+    unsigned       m_max_size;
+    unsigned       m_num_active; // number of active rewriter invocations.
+    svector<entry> m_entries; // in insertion order
+    entry          m_probe;
+    table          m_table;
+    stats          m_stats;
+
+    entry const & get_entry(unsigned idx) const { return idx == probe_idx ? m_probe : m_entries[idx]; }
+    void dec_ref(entry const & e) { m_manager.dec_ref(e.m_key); m_manager.dec_ref(e.m_value); }
+    void rebuild_table();
+    void evict();
+    void shrink();
+
+public:
+    rewrite_cache(ast_manager & m, unsigned max_size);
+    ~rewrite_cache();
+
+    ast_manager & m() const { return m_manager; }
+
+    /**
+       \brief Return the result of rewriting \c k using a rewriter with configuration \c cfg,
+       or 0 if it is not in the cache.
+    */
+    expr * find(expr * k, unsigned cfg);
+
+    void insert(expr * k, unsigned cfg, expr * v);
+
+    /**
+       \brief Mark the beginning (end) of a rewriter invocation that uses the cache.
+       Entries are only evicted when there are no active invocations.
+    */
+    void inc_active() { m_num_active++; }
+    void dec_active();
+
+    void reset();
+
+    unsigned size() const { return m_entries.size(); }
+
+    unsigned get_max_size() const { return m_max_size; }
+
+    void set_max_size(unsigned max_size);
+
+    void collect_statistics(statistics & st) const;
+    void reset_statistics() { m_stats.reset(); }
+};
+
+class scoped_rewrite_cache_use {
+    rewrite_cache * m_cache;
+public:
+    scoped_rewrite_cache_use(rewrite_cache * c):m_cache(c) { if (m_cache) m_cache->inc_active(); }
+    ~scoped_rewrite_cache_use() { if (m_cache) m_cache->dec_active(); }
+};
+
+#endif
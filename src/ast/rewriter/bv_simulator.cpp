@@ -0,0 +1,656 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    bv_simulator.cpp
+
+Abstract:
+
+    Bit-parallel simulation of quantifier free bit-vector formulas.
+
+Author:
+
+Revision History:
+
+--*/
+#include"bv_simulator.h"
+#include"ast_smt2_pp.h"
+
+enum sim_op {
+    // Boolean results
+    SIM_NOT,
+    SIM_AND,
+    SIM_OR,
+    SIM_XOR,
+    SIM_IFF,
+    SIM_IMPLIES,
+    SIM_ITE,
+    SIM_DISTINCT,
+    SIM_CARRY,
+    SIM_XOR3,
+    SIM_BV_EQ,
+    SIM_BV_DISTINCT,
+    SIM_ULE,
+    SIM_ULT,
+    SIM_UGE,
+    SIM_UGT,
+    SIM_SLE,
+    SIM_SLT,
+    SIM_SGE,
+    SIM_SGT,
+    SIM_BIT2BOOL,
+    // bit-vector results
+    SIM_BV_ITE,
+    SIM_ADD,
+    SIM_SUB,
+    SIM_NEG,
+    SIM_MUL,
+    SIM_UDIV,
+    SIM_UREM,
+    SIM_SDIV,
+    SIM_SREM,
+    SIM_SMOD,
+    SIM_BAND,
+    SIM_BOR,
+    SIM_BXOR,
+    SIM_BNOT,
+    SIM_BNAND,
+    SIM_BNOR,
+    SIM_BXNOR,
+    SIM_CONCAT,
+    SIM_SIGN_EXT,
+    SIM_ZERO_EXT,
+    SIM_EXTRACT,
+    SIM_REPEAT,
+    SIM_REDOR,
+    SIM_REDAND,
+    SIM_COMP,
+    SIM_SHL,
+    SIM_LSHR,
+    SIM_ASHR,
+    SIM_ROTATE_LEFT,
+    SIM_ROTATE_RIGHT,
+    SIM_EXT_ROTATE_LEFT,
+    SIM_EXT_ROTATE_RIGHT
+};
+
+static inline uint64 mk_mask(unsigned sz) {
+    return sz >= 64 ? ~static_cast<uint64>(0) : (static_cast<uint64>(1) << sz) - 1;
+}
+
+// signed value of the bit-vector v of size sz
+static inline int64 to_int(uint64 v, unsigned sz) {
+    if (sz >= 64)
+        return static_cast<int64>(v);
+    uint64 sign = static_cast<uint64>(1) << (sz - 1);
+    return static_cast<int64>(v ^ sign) - static_cast<int64>(sign);
+}
+
+static inline uint64 rotate_left(uint64 a, unsigned k, unsigned sz) {
+    k %= sz;
+    if (k == 0)
+        return a;
+    return ((a << k) | (a >> (sz - k))) & mk_mask(sz);
+}
+
+// -----------------------------------
+//
+// Operations on a single lane.
+// Arguments are bit-vectors of size sz,
+// the result is masked by the caller.
+//
+// -----------------------------------
+
+struct sim_sub   { uint64 operator()(uint64 a, uint64 b, unsigned) const { return a - b; } };
+struct sim_nand  { uint64 operator()(uint64 a, uint64 b, unsigned) const { return ~(a & b); } };
+struct sim_nor   { uint64 operator()(uint64 a, uint64 b, unsigned) const { return ~(a | b); } };
+struct sim_xnor  { uint64 operator()(uint64 a, uint64 b, unsigned) const { return ~(a ^ b); } };
+struct sim_comp  { uint64 operator()(uint64 a, uint64 b, unsigned) const { return a == b ? 1 : 0; } };
+
+struct sim_udiv {
+    uint64 operator()(uint64 a, uint64 b, unsigned) const { return b == 0 ? ~static_cast<uint64>(0) : a / b; }
+};
+
+struct sim_urem {
+    uint64 operator()(uint64 a, uint64 b, unsigned) const { return b == 0 ? a : a % b; }
+};
+
+struct sim_sdiv {
+    uint64 operator()(uint64 a, uint64 b, unsigned sz) const {
+        int64 sa = to_int(a, sz), sb = to_int(b, sz);
+        if (sb == 0)
+            return sa < 0 ? 1 : ~static_cast<uint64>(0);
+        if (sb == -1)
+            return 0 - a; // avoid overflow of INT64_MIN / -1
+        return static_cast<uint64>(sa / sb);
+    }
+};
+
+struct sim_srem {
+    uint64 operator()(uint64 a, uint64 b, unsigned sz) const {
+        int64 sa = to_int(a, sz), sb = to_int(b, sz);
+        if (sb == 0)
+            return a;
+        if (sb == -1)
+            return 0;
+        return static_cast<uint64>(sa % sb);
+    }
+};
+
+struct sim_smod {
+    uint64 operator()(uint64 a, uint64 b, unsigned sz) const {
+        int64 sa = to_int(a, sz), sb = to_int(b, sz);
+        if (sb == 0)
+            return a;
+        uint64 abs_a = sa < 0 ? 0 - static_cast<uint64>(sa) : static_cast<uint64>(sa);
+        uint64 abs_b = sb < 0 ? 0 - static_cast<uint64>(sb) : static_cast<uint64>(sb);
+        uint64 u     = abs_a % abs_b;
+        if (u == 0 || (sa > 0 && sb > 0))
+            return u;
+        if (sa < 0 && sb > 0)
+            return b - u;
+        if (sa > 0 && sb < 0)
+            return u + b;
+        return 0 - u;
+    }
+};
+
+struct sim_shl {
+    uint64 operator()(uint64 a, uint64 b, unsigned sz) const { return b >= sz ? 0 : a << b; }
+};
+
+struct sim_lshr {
+    uint64 operator()(uint64 a, uint64 b, unsigned sz) const { return b >= sz ? 0 : a >> b; }
+};
+
+struct sim_ashr {
+    uint64 operator()(uint64 a, uint64 b, unsigned sz) const {
+        int64 sa = to_int(a, sz);
+        if (b >= sz)
+            return sa < 0 ? ~static_cast<uint64>(0) : 0;
+        return static_cast<uint64>(sa >> b);
+    }
+};
+
+struct sim_ext_rotate_left {
+    uint64 operator()(uint64 a, uint64 b, unsigned sz) const { return rotate_left(a, static_cast<unsigned>(b % sz), sz); }
+};
+
+struct sim_ext_rotate_right {
+    uint64 operator()(uint64 a, uint64 b, unsigned sz) const { return rotate_left(a, sz - static_cast<unsigned>(b % sz), sz); }
+};
+
+struct sim_eq  { bool operator()(uint64 a, uint64 b, unsigned) const { return a == b; } };
+struct sim_ule { bool operator()(uint64 a, uint64 b, unsigned) const { return a <= b; } };
+struct sim_ult { bool operator()(uint64 a, uint64 b, unsigned) const { return a < b; } };
+struct sim_sle { bool operator()(uint64 a, uint64 b, unsigned sz) const { return to_int(a, sz) <= to_int(b, sz); } };
+struct sim_slt { bool operator()(uint64 a, uint64 b, unsigned sz) const { return to_int(a, sz) < to_int(b, sz); } };
+
+template<typename F>
+static void lane_op(uint64 * r, uint64 const * a, uint64 const * b, unsigned sz) {
+    F      f;
+    uint64 msk = mk_mask(sz);
+    for (unsigned l = 0; l < bv_simulator::LANES; l++)
+        r[l] = f(a[l], b[l], sz) & msk;
+}
+
+template<typename P>
+static uint64 lane_pred(uint64 const * a, uint64 const * b, unsigned sz) {
+    P      p;
+    uint64 r = 0;
+    for (unsigned l = 0; l < bv_simulator::LANES; l++)
+        if (p(a[l], b[l], sz))
+            r |= static_cast<uint64>(1) << l;
+    return r;
+}
+
+bv_simulator::bv_simulator(ast_manager & m, unsigned seed):
+    m_manager(m),
+    m_util(m),
+    m_rand(seed),
+    m_pinned(m),
+    m_inputs(m) {
+}
+
+void bv_simulator::reset() {
+    m_pinned.reset();
+    m_inputs.reset();
+    m_offset.reset();
+    m_code.reset();
+    m_args.reset();
+    m_arg_sizes.reset();
+    m_values.reset();
+}
+
+bool bv_simulator::is_supported_sort(sort * s) const {
+    if (m().is_bool(s))
+        return true;
+    return m_util.is_bv_sort(s) && m_util.get_bv_size(s) <= 64;
+}
+
+unsigned bv_simulator::mk_slot(expr * t) {
+    unsigned off = m_values.size();
+    m_values.resize(off + (m().is_bool(t) ? 1 : LANES), 0);
+    m_offset.insert(t, off);
+    return off;
+}
+
+void bv_simulator::mk_instr(unsigned op, app * t, unsigned param) {
+    instr i;
+    i.m_op    = op;
+    i.m_param = param;
+    i.m_begin = m_args.size();
+    unsigned num_args = t->get_num_args();
+    for (unsigned j = 0; j < num_args; j++) {
+        expr * arg = t->get_arg(j);
+        m_args.push_back(m_offset.find(arg));
+        m_arg_sizes.push_back(m_util.is_bv(arg) ? m_util.get_bv_size(arg) : 0);
+    }
+    i.m_end = m_args.size();
+    if (m_util.is_bv(t))
+        i.m_bv_size = m_util.get_bv_size(t);
+    else
+        i.m_bv_size = num_args > 0 ? m_arg_sizes[i.m_begin] : 0;
+    i.m_dst = mk_slot(t);
+    m_code.push_back(i);
+}
+
+bool bv_simulator::compile_core(app * t) {
+    m_pinned.push_back(t);
+    if (is_uninterp_const(t)) {
+        mk_slot(t);
+        m_inputs.push_back(t);
+        return true;
+    }
+    family_id fid = t->get_family_id();
+    decl_kind k   = t->get_decl_kind();
+    if (fid == m().get_basic_family_id()) {
+        bool is_bool_arg = t->get_num_args() > 0 && m().is_bool(t->get_arg(0));
+        switch (k) {
+        case OP_TRUE:    m_values[mk_slot(t)] = ~static_cast<uint64>(0); return true;
+        case OP_FALSE:   mk_slot(t); return true;
+        case OP_NOT:     mk_instr(SIM_NOT, t); return true;
+        case OP_AND:     mk_instr(SIM_AND, t); return true;
+        case OP_OR:      mk_instr(SIM_OR, t); return true;
+        case OP_XOR:     mk_instr(SIM_XOR, t); return true;
+        case OP_IFF:     mk_instr(SIM_IFF, t); return true;
+        case OP_IMPLIES: mk_instr(SIM_IMPLIES, t); return true;
+        case OP_EQ:      mk_instr(is_bool_arg ? SIM_IFF : SIM_BV_EQ, t); return true;
+        case OP_DISTINCT: mk_instr(is_bool_arg ? SIM_DISTINCT : SIM_BV_DISTINCT, t); return true;
+        case OP_ITE:     mk_instr(m().is_bool(t) ? SIM_ITE : SIM_BV_ITE, t); return true;
+        default:         return false;
+        }
+    }
+    if (fid != m_util.get_fid())
+        return false;
+    rational val;
+    unsigned sz;
+    if (m_util.is_numeral(t, val, sz)) {
+        uint64 v     = val.get_uint64();
+        unsigned off = mk_slot(t);
+        for (unsigned l = 0; l < LANES; l++)
+            m_values[off + l] = v;
+        return true;
+    }
+    func_decl * d = t->get_decl();
+    switch (k) {
+    case OP_BIT0:          mk_slot(t); return true;
+    case OP_BIT1:          { unsigned off = mk_slot(t); for (unsigned l = 0; l < LANES; l++) m_values[off + l] = 1; return true; }
+    case OP_BADD:          mk_instr(SIM_ADD, t); return true;
+    case OP_BSUB:          mk_instr(SIM_SUB, t); return true;
+    case OP_BNEG:          mk_instr(SIM_NEG, t); return true;
+    case OP_BMUL:          mk_instr(SIM_MUL, t); return true;
+    case OP_BUDIV:
+    case OP_BUDIV_I:       mk_instr(SIM_UDIV, t); return true;
+    case OP_BUREM:
+    case OP_BUREM_I:       mk_instr(SIM_UREM, t); return true;
+    case OP_BSDIV:
+    case OP_BSDIV_I:       mk_instr(SIM_SDIV, t); return true;
+    case OP_BSREM:
+    case OP_BSREM_I:       mk_instr(SIM_SREM, t); return true;
+    case OP_BSMOD:
+    case OP_BSMOD_I:       mk_instr(SIM_SMOD, t); return true;
+    case OP_ULEQ:          mk_instr(SIM_ULE, t); return true;
+    case OP_ULT:           mk_instr(SIM_ULT, t); return true;
+    case OP_UGEQ:          mk_instr(SIM_UGE, t); return true;
+    case OP_UGT:           mk_instr(SIM_UGT, t); return true;
+    case OP_SLEQ:          mk_instr(SIM_SLE, t); return true;
+    case OP_SLT:           mk_instr(SIM_SLT, t); return true;
+    case OP_SGEQ:          mk_instr(SIM_SGE, t); return true;
+    case OP_SGT:           mk_instr(SIM_SGT, t); return true;
+    case OP_BAND:          mk_instr(SIM_BAND, t); return true;
+    case OP_BOR:           mk_instr(SIM_BOR, t); return true;
+    case OP_BXOR:          mk_instr(SIM_BXOR, t); return true;
+    case OP_BNOT:          mk_instr(SIM_BNOT, t); return true;
+    case OP_BNAND:         mk_instr(SIM_BNAND, t); return true;
+    case OP_BNOR:          mk_instr(SIM_BNOR, t); return true;
+    case OP_BXNOR:         mk_instr(SIM_BXNOR, t); return true;
+    case OP_CONCAT:        mk_instr(SIM_CONCAT, t); return true;
+    case OP_SIGN_EXT:      mk_instr(SIM_SIGN_EXT, t); return true;
+    case OP_ZERO_EXT:      mk_instr(SIM_ZERO_EXT, t); return true;
+    case OP_EXTRACT:       mk_instr(SIM_EXTRACT, t, m_util.get_extract_low(d)); return true;
+    case OP_REPEAT:        mk_instr(SIM_REPEAT, t); return true;
+    case OP_BREDOR:        mk_instr(SIM_REDOR, t); return true;
+    case OP_BREDAND:       mk_instr(SIM_REDAND, t); return true;
+    case OP_BCOMP:         mk_instr(SIM_COMP, t); return true;
+    case OP_BSHL:          mk_instr(SIM_SHL, t); return true;
+    case OP_BLSHR:         mk_instr(SIM_LSHR, t); return true;
+    case OP_BASHR:         mk_instr(SIM_ASHR, t); return true;
+    case OP_ROTATE_LEFT:   mk_instr(SIM_ROTATE_LEFT, t, d->get_parameter(0).get_int()); return true;
+    case OP_ROTATE_RIGHT:  mk_instr(SIM_ROTATE_RIGHT, t, d->get_parameter(0).get_int()); return true;
+    case OP_EXT_ROTATE_LEFT:  mk_instr(SIM_EXT_ROTATE_LEFT, t); return true;
+    case OP_EXT_ROTATE_RIGHT: mk_instr(SIM_EXT_ROTATE_RIGHT, t); return true;
+    case OP_BIT2BOOL:      mk_instr(SIM_BIT2BOOL, t, d->get_parameter(0).get_int()); return true;
+    case OP_CARRY:         mk_instr(SIM_CARRY, t); return true;
+    case OP_XOR3:          mk_instr(SIM_XOR3, t); return true;
+    default:
+        return false;
+    }
+}
+
+bool bv_simulator::compile(unsigned num_roots, expr * const * roots) {
+    SASSERT(m_todo.empty());
+    for (unsigned i = 0; i < num_roots; i++)
+        m_todo.push_back(roots[i]);
+    while (!m_todo.empty()) {
+        expr * t = m_todo.back();
+        if (m_offset.contains(t)) {
+            m_todo.pop_back();
+            continue;
+        }
+        if (!is_app(t) || !is_supported_sort(m().get_sort(t))) {
+            m_todo.reset();
+            return false;
+        }
+        app * a      = to_app(t);
+        bool visited = true;
+        for (unsigned i = 0; i < a->get_num_args(); i++) {
+            expr * arg = a->get_arg(i);
+            if (!m_offset.contains(arg)) {
+                m_todo.push_back(arg);
+                visited = false;
+            }
+        }
+        if (!visited)
+            continue;
+        m_todo.pop_back();
+        if (!compile_core(a)) {
+            TRACE("bv_simulator", tout << "not supported: " << mk_ismt2_pp(a, m()) << "\n";);
+            m_todo.reset();
+            return false;
+        }
+    }
+    return true;
+}
+
+void bv_simulator::exec(instr const & i) {
+    uint64 *         vals = m_values.c_ptr();
+    uint64 *         r    = vals + i.m_dst;
+    unsigned const * args = m_args.c_ptr() + i.m_begin;
+    unsigned         num  = i.m_end - i.m_begin;
+    unsigned         sz   = i.m_bv_size;
+    uint64           msk  = mk_mask(sz);
+    switch (i.m_op) {
+    case SIM_NOT:
+        r[0] = ~vals[args[0]];
+        break;
+    case SIM_AND:
+        r[0] = ~static_cast<uint64>(0);
+        for (unsigned j = 0; j < num; j++)
+            r[0] &= vals[args[j]];
+        break;
+    case SIM_OR:
+        r[0] = 0;
+        for (unsigned j = 0; j < num; j++)
+            r[0] |= vals[args[j]];
+        break;
+    case SIM_XOR:
+        r[0] = 0;
+        for (unsigned j = 0; j < num; j++)
+            r[0] ^= vals[args[j]];
+        break;
+    case SIM_IFF:
+        r[0] = ~(vals[args[0]] ^ vals[args[1]]);
+        break;
+    case SIM_IMPLIES:
+        r[0] = ~vals[args[0]] | vals[args[1]];
+        break;
+    case SIM_ITE:
+        r[0] = (vals[args[0]] & vals[args[1]]) | (~vals[args[0]] & vals[args[2]]);
+        break;
+    case SIM_DISTINCT:
+        r[0] = ~static_cast<uint64>(0);
+        for (unsigned j = 0; j < num; j++)
+            for (unsigned k = j + 1; k < num; k++)
+                r[0] &= vals[args[j]] ^ vals[args[k]];
+        break;
+    case SIM_CARRY: {
+        uint64 a = vals[args[0]], b = vals[args[1]], c = vals[args[2]];
+        r[0] = (a & b) | (a & c) | (b & c);
+        break;
+    }
+    case SIM_XOR3:
+        r[0] = vals[args[0]] ^ vals[args[1]] ^ vals[args[2]];
+        break;
+    case SIM_BV_EQ:
+        r[0] = lane_pred<sim_eq>(vals + args[0], vals + args[1], sz);
+        break;
+    case SIM_BV_DISTINCT:
+        r[0] = ~static_cast<uint64>(0);
+        for (unsigned j = 0; j < num; j++)
+            for (unsigned k = j + 1; k < num; k++)
+                r[0] &= ~lane_pred<sim_eq>(vals + args[j], vals + args[k], sz);
+        break;
+    case SIM_ULE: r[0] = lane_pred<sim_ule>(vals + args[0], vals + args[1], sz); break;
+    case SIM_ULT: r[0] = lane_pred<sim_ult>(vals + args[0], vals + args[1], sz); break;
+    case SIM_UGE: r[0] = lane_pred<sim_ule>(vals + args[1], vals + args[0], sz); break;
+    case SIM_UGT: r[0] = lane_pred<sim_ult>(vals + args[1], vals + args[0], sz); break;
+    case SIM_SLE: r[0] = lane_pred<sim_sle>(vals + args[0], vals + args[1], sz); break;
+    case SIM_SLT: r[0] = lane_pred<sim_slt>(vals + args[0], vals + args[1], sz); break;
+    case SIM_SGE: r[0] = lane_pred<sim_sle>(vals + args[1], vals + args[0], sz); break;
+    case SIM_SGT: r[0] = lane_pred<sim_slt>(vals + args[1], vals + args[0], sz); break;
+    case SIM_BIT2BOOL: {
+        uint64 const * a = vals + args[0];
+        uint64 res = 0;
+        for (unsigned l = 0; l < LANES; l++)
+            res |= ((a[l] >> i.m_param) & 1) << l;
+        r[0] = res;
+        break;
+    }
+    case SIM_BV_ITE: {
+        uint64 c = vals[args[0]];
+        uint64 const * t = vals + args[1];
+        uint64 const * e = vals + args[2];
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = ((c >> l) & 1) ? t[l] : e[l];
+        break;
+    }
+    case SIM_ADD:
+    case SIM_MUL:
+    case SIM_BAND:
+    case SIM_BOR:
+    case SIM_BXOR: {
+        uint64 const * a = vals + args[0];
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = a[l];
+        for (unsigned j = 1; j < num; j++) {
+            a = vals + args[j];
+            switch (i.m_op) {
+            case SIM_ADD:  for (unsigned l = 0; l < LANES; l++) r[l] += a[l]; break;
+            case SIM_MUL:  for (unsigned l = 0; l < LANES; l++) r[l] *= a[l]; break;
+            case SIM_BAND: for (unsigned l = 0; l < LANES; l++) r[l] &= a[l]; break;
+            case SIM_BOR:  for (unsigned l = 0; l < LANES; l++) r[l] |= a[l]; break;
+            default:       for (unsigned l = 0; l < LANES; l++) r[l] ^= a[l]; break;
+            }
+        }
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] &= msk;
+        break;
+    }
+    case SIM_SUB:   lane_op<sim_sub>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_UDIV:  lane_op<sim_udiv>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_UREM:  lane_op<sim_urem>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_SDIV:  lane_op<sim_sdiv>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_SREM:  lane_op<sim_srem>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_SMOD:  lane_op<sim_smod>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_BNAND: lane_op<sim_nand>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_BNOR:  lane_op<sim_nor>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_BXNOR: lane_op<sim_xnor>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_COMP:  lane_op<sim_comp>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_SHL:   lane_op<sim_shl>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_LSHR:  lane_op<sim_lshr>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_ASHR:  lane_op<sim_ashr>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_EXT_ROTATE_LEFT:  lane_op<sim_ext_rotate_left>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_EXT_ROTATE_RIGHT: lane_op<sim_ext_rotate_right>(r, vals + args[0], vals + args[1], sz); break;
+    case SIM_NEG: {
+        uint64 const * a = vals + args[0];
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = (0 - a[l]) & msk;
+        break;
+    }
+    case SIM_BNOT: {
+        uint64 const * a = vals + args[0];
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = ~a[l] & msk;
+        break;
+    }
+    case SIM_CONCAT: {
+        // the first argument contains the most significant bits
+        unsigned const * arg_sizes = m_arg_sizes.c_ptr() + i.m_begin;
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = 0;
+        for (unsigned j = 0; j < num; j++) {
+            uint64 const * a = vals + args[j];
+            unsigned       s = arg_sizes[j];
+            for (unsigned l = 0; l < LANES; l++)
+                r[l] = s >= 64 ? a[l] : (r[l] << s) | a[l];
+        }
+        break;
+    }
+    case SIM_SIGN_EXT: {
+        uint64 const * a = vals + args[0];
+        unsigned       s = m_arg_sizes[i.m_begin];
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = static_cast<uint64>(to_int(a[l], s)) & msk;
+        break;
+    }
+    case SIM_ZERO_EXT: {
+        uint64 const * a = vals + args[0];
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = a[l];
+        break;
+    }
+    case SIM_EXTRACT: {
+        uint64 const * a = vals + args[0];
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = (a[l] >> i.m_param) & msk;
+        break;
+    }
+    case SIM_REPEAT: {
+        uint64 const * a = vals + args[0];
+        unsigned       s = m_arg_sizes[i.m_begin];
+        unsigned       n = sz / s;
+        for (unsigned l = 0; l < LANES; l++) {
+            uint64 v = 0;
+            for (unsigned j = 0; j < n; j++)
+                v = s >= 64 ? a[l] : (v << s) | a[l];
+            r[l] = v;
+        }
+        break;
+    }
+    case SIM_REDOR: {
+        uint64 const * a = vals + args[0];
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = a[l] != 0 ? 1 : 0;
+        break;
+    }
+    case SIM_REDAND: {
+        uint64 const * a = vals + args[0];
+        uint64 all = mk_mask(m_arg_sizes[i.m_begin]);
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = a[l] == all ? 1 : 0;
+        break;
+    }
+    case SIM_ROTATE_LEFT:
+    case SIM_ROTATE_RIGHT: {
+        uint64 const * a = vals + args[0];
+        unsigned       k = i.m_param % sz;
+        if (i.m_op == SIM_ROTATE_RIGHT)
+            k = sz - k;
+        for (unsigned l = 0; l < LANES; l++)
+            r[l] = rotate_left(a[l], k, sz);
+        break;
+    }
+    default:
+        UNREACHABLE();
+    }
+}
+
+void bv_simulator::run() {
+    svector<instr>::const_iterator it  = m_code.begin();
+    svector<instr>::const_iterator end = m_code.end();
+    for (; it != end; ++it)
+        exec(*it);
+}
+
+void bv_simulator::set_value(app * input, unsigned lane, uint64 v) {
+    SASSERT(lane < LANES);
+    unsigned off = m_offset.find(input);
+    if (m().is_bool(input)) {
+        uint64 bit = static_cast<uint64>(1) << lane;
+        if (v)
+            m_values[off] |= bit;
+        else
+            m_values[off] &= ~bit;
+    }
+    else {
+        m_values[off + lane] = v & mk_mask(m_util.get_bv_size(input));
+    }
+}
+
+static uint64 random_word(random_gen & r) {
+    uint64 w = 0;
+    for (unsigned i = 0; i < 5; i++)
+        w = (w << 15) ^ static_cast<uint64>(r());
+    return w;
+}
+
+void bv_simulator::randomize() {
+    for (unsigned i = 0; i < m_inputs.size(); i++) {
+        app *    t   = m_inputs.get(i);
+        unsigned off = m_offset.find(t);
+        if (m().is_bool(t)) {
+            m_values[off] = random_word(m_rand);
+        }
+        else {
+            uint64 msk = mk_mask(m_util.get_bv_size(t));
+            for (unsigned l = 0; l < LANES; l++)
+                m_values[off + l] = random_word(m_rand) & msk;
+        }
+    }
+}
+
+uint64 bv_simulator::get_value(expr * t, unsigned lane) const {
+    SASSERT(lane < LANES);
+    unsigned off = m_offset.find(t);
+    if (m().is_bool(t))
+        return (m_values[off] >> lane) & 1;
+    return m_values[off + lane];
+}
+
+uint64 bv_simulator::get_bool(expr * t) const {
+    SASSERT(m().is_bool(t));
+    return m_values[m_offset.find(t)];
+}
+
+bool bv_simulator::equal_on_all_lanes(expr * t1, expr * t2) const {
+    SASSERT(m().get_sort(t1) == m().get_sort(t2));
+    unsigned off1 = m_offset.find(t1);
+    unsigned off2 = m_offset.find(t2);
+    unsigned n    = m().is_bool(t1) ? 1 : LANES;
+    for (unsigned l = 0; l < n; l++)
+        if (m_values[off1 + l] != m_values[off2 + l])
+            return false;
+    return true;
+}
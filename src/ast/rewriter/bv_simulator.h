@@ -0,0 +1,129 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    bv_simulator.h
+
+Abstract:
+
+    Bit-parallel simulation of quantifier free bit-vector formulas.
+
+    A set of terms is compiled into a flat sequence of instructions
+    (children before parents), and the instructions are executed on
+    LANES input vectors at once. A Boolean term is stored as a single
+    64-bit word (bit i is its value in lane i), and a bit-vector term of
+    size at most 64 is stored as LANES 64-bit words (one value per lane).
+    The loops over the lanes have no dependencies, and are suitable for
+    auto-vectorization.
+
+    Uninterpreted constants of Boolean or bit-vector sort are the inputs
+    of the simulation. Division by zero uses the "hardware interpretation"
+    (see hi_div0 in bv_rewriter).
+
+    Applications: cheap detection of candidate equivalences (terms that
+    agree on all lanes), scoring of many candidate assignments in local
+    search, and quick satisfiability checks.
+
+Author:
+
+Revision History:
+
+--*/
+#ifndef BV_SIMULATOR_H_
+#define BV_SIMULATOR_H_
+
+#include"ast.h"
+#include"bv_decl_plugin.h"
+#include"obj_hashtable.h"
+#include"util.h"
+
+class bv_simulator {
+public:
+    static const unsigned LANES = 64;
+private:
+    struct instr {
+        unsigned m_op;
+        unsigned m_dst;       // offset of the result in m_values
+        unsigned m_bv_size;   // size of the result, or of the arguments of bit-vector predicates
+        unsigned m_param;     // additional parameter (e.g., low bit of extract)
+        unsigned m_begin;     // the arguments are m_args[m_begin], ..., m_args[m_end - 1]
+        unsigned m_end;
+    };
+
+    ast_manager &            m_manager;
+    bv_util                  m_util;
+    random_gen               m_rand;
+    expr_ref_vector          m_pinned;
+    app_ref_vector           m_inputs;
+    obj_map<expr, unsigned>  m_offset;   // term -> offset of its value in m_values
+    svector<instr>           m_code;
+    unsigned_vector          m_args;     // offsets of the arguments
+    unsigned_vector          m_arg_sizes;
+    svector<uint64>          m_values;
+    ptr_vector<expr>         m_todo;
+
+    unsigned mk_slot(expr * t);
+    bool is_supported_sort(sort * s) const;
+    bool compile_core(app * t);
+    void mk_instr(unsigned op, app * t, unsigned param = 0);
+    void exec(instr const & i);
+
+public:
+    bv_simulator(ast_manager & m, unsigned seed = 0);
+
+    ast_manager & m() const { return m_manager; }
+
+    /**
+       \brief Compile the given terms (and their subterms). Return false if one of them
+       is not supported: quantifiers, bit-vectors with more than 64 bits, and
+       operators that are not Boolean or bit-vector operators with a fixed interpretation.
+       The terms compiled by previous calls are preserved.
+    */
+    bool compile(unsigned num_roots, expr * const * roots);
+    bool compile(expr * root) { return compile(1, &root); }
+
+    void reset();
+
+    bool contains(expr * t) const { return m_offset.contains(t); }
+    unsigned get_num_instructions() const { return m_code.size(); }
+
+    /**
+       \brief Uninterpreted constants occurring in the compiled terms.
+    */
+    unsigned get_num_inputs() const { return m_inputs.size(); }
+    app * get_input(unsigned i) const { return m_inputs.get(i); }
+
+    /**
+       \brief Set the value of the given input in the given lane.
+       For Boolean inputs, v must be 0 or 1.
+    */
+    void set_value(app * input, unsigned lane, uint64 v);
+
+    /**
+       \brief Assign random values to all inputs.
+    */
+    void randomize();
+
+    /**
+       \brief Evaluate all compiled terms.
+    */
+    void run();
+
+    /**
+       \brief Value of the given compiled term in the given lane (0 or 1 for Boolean terms).
+    */
+    uint64 get_value(expr * t, unsigned lane) const;
+
+    /**
+       \brief Value of the given compiled Boolean term: bit i is its value in lane i.
+    */
+    uint64 get_bool(expr * t) const;
+
+    /**
+       \brief Return true if t1 and t2 (with the same sort) have the same value in all lanes.
+    */
+    bool equal_on_all_lanes(expr * t1, expr * t2) const;
+};
+
+#endif
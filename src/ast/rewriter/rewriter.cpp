@@ -52,6 +52,8 @@ void rewriter_core::cache_result(expr * k, expr * v) {
     TRACE("rewriter_cache_result", tout << mk_ismt2_pp(k, m()) << "\n--->\n" << mk_ismt2_pp(v, m()) << "\n";);
 
     m_cache->insert(k, v);
+    if (m_persistent_cache != 0 && m_scopes.empty())
+        m_persistent_cache->insert(k, m_persistent_key, v);
 #if 0
     static unsigned num_cached = 0;
     num_cached ++;
@@ -173,7 +175,10 @@ rewriter_core::rewriter_core(ast_manager & m, bool proof_gen):
     m_proof_gen(proof_gen),
     m_result_stack(m),
     m_result_pr_stack(m),
-    m_num_qvars(0) {
+    m_num_qvars(0),
+    m_persistent(false),
+    m_persistent_key(0),
+    m_persistent_cache(0) {
     init_cache_stack();
 }
 
@@ -192,6 +197,7 @@ void rewriter_core::reset() {
     m_root = 0;
     m_num_qvars = 0;
     m_scopes.reset();
+    m_persistent_cache = 0;
 }
 
 // free memory & reset (macro definitions are not erased)
@@ -22,6 +22,7 @@ Notes:
 #include"ast.h"
 #include"rewriter_types.h"
 #include"act_cache.h"
+#include"rewrite_cache.h"
 
 /**
    \brief Common infrastructure for AST rewriters.
@@ -69,6 +70,11 @@ protected:
     };
     svector<scope>             m_scopes;
 
+    // Persistent cache (see ast_manager::set_rewrite_cache_size).
+    bool                       m_persistent;       // true if the rewriter may use the persistent cache.
+    unsigned                   m_persistent_key;   // identifies the configuration of the rewriter.
+    rewrite_cache *            m_persistent_cache; // persistent cache used by the current invocation, or 0.
+
     // Return true if the rewriting result of the given expression must be cached.
     bool must_cache(expr * t) const {
         return 
@@ -90,7 +96,13 @@ protected:
     void del_cache_stack();
     void reset_cache();
     void cache_result(expr * k, expr * v);
-    expr * get_cached(expr * k) const { return m_cache->find(k); } 
+    expr * get_cached(expr * k) const { 
+        expr * r = m_cache->find(k);
+        // the persistent cache is only used for results that do not depend on bindings.
+        if (r == 0 && m_persistent_cache != 0 && m_scopes.empty())
+            r = m_persistent_cache->find(k, m_persistent_key);
+        return r;
+    } 
 
     void cache_result(expr * k, expr * v, proof * pr);
     proof * get_cached_pr(expr * k) const { return static_cast<proof*>(m_cache_pr->find(k)); } 
@@ -118,6 +130,16 @@ public:
     void display_stack(std::ostream & out, unsigned pp_depth);
 #endif
     unsigned get_cache_size() const;
+
+    /**
+       \brief Use the rewrite cache of the manager (if any) for expressions rewritten
+       without bindings and without proof generation. Rewriters using the same \c key must
+       produce the same results.
+    */
+    void enable_persistent_cache(unsigned key) { m_persistent = true; m_persistent_key = key; }
+    void disable_persistent_cache() { m_persistent = false; m_persistent_cache = 0; }
+    bool persistent_cache_enabled() const { return m_persistent; }
+    unsigned get_persistent_key() const { return m_persistent_key; }
 };
 
 class var_shifter_core : public rewriter_core {
@@ -551,6 +551,21 @@ void rewriter_tpl<Config>::main_loop(expr * t, expr_ref & result, proof_ref & re
     m_root      = t;
     m_num_qvars = 0;
     m_num_steps = 0;
+    m_persistent_cache = 0;
+    if (!ProofGen && m_persistent && m_bindings.empty() && !m().concurrency_enabled())
+        m_persistent_cache = m().get_rewrite_cache();
+    // entries of the persistent cache are not evicted while this invocation holds pointers to them.
+    scoped_rewrite_cache_use use(m_persistent_cache);
+    bool persist = m_persistent_cache != 0 && ((is_app(t) && to_app(t)->get_num_args() > 0) || is_quantifier(t));
+    // t may be referenced only by result (e.g., rw(r, r)), it must survive until it is inserted.
+    expr_ref t_ref(persist ? t : 0, m());
+    if (persist) {
+        expr * r = m_persistent_cache->find(t, m_persistent_key);
+        if (r != 0) {
+            result = r;
+            return;
+        }
+    }
     if (visit<ProofGen>(t, RW_UNBOUNDED_DEPTH)) {
         result = result_stack().back();
         result_stack().pop_back();
@@ -562,9 +577,12 @@ void rewriter_tpl<Config>::main_loop(expr * t, expr_ref & result, proof_ref & re
                 result_pr = m().mk_reflexivity(t);
             SASSERT(result_pr_stack().empty());
         }
-        return;
     }
-    resume_core<ProofGen>(result, result_pr);
+    else {
+        resume_core<ProofGen>(result, result_pr);
+    }
+    if (persist)
+        m_persistent_cache->insert(t, m_persistent_key, result);
 }
 
 /**
@@ -34,6 +34,8 @@ Notes:
 #include"var_subst.h"
 #include"ast_util.h"
 #include"well_sorted.h"
+#include"gparams.h"
+#include<sstream>
 
 struct th_rewriter_cfg : public default_rewriter_cfg {
     bool_rewriter       m_b_rw;
@@ -694,6 +696,29 @@ struct th_rewriter::imp : public rewriter_tpl<th_rewriter_cfg> {
     imp(ast_manager & m, params_ref const & p):
         rewriter_tpl<th_rewriter_cfg>(m, m.proofs_enabled(), m_cfg),
         m_cfg(m, p) {
+        updt_persistent_cache(p);
+    }
+
+    // The results depend on the parameters of the rewriter (local and global ones).
+    static unsigned mk_persistent_key(params_ref const & p) {
+        std::ostringstream strm;
+        p.display(strm);
+        strm << "|";
+        gparams::get_module("rewriter").display(strm);
+        std::string s = strm.str();
+        return string_hash(s.c_str(), static_cast<unsigned>(s.length()), 17);
+    }
+
+    // The key is computed only if the manager has a rewrite cache when the rewriter
+    // is created (or its parameters are updated). Entries of an old key are not
+    // removed, other rewriters may be using the same configuration.
+    void updt_persistent_cache(params_ref const & p) {
+        if (m().get_rewrite_cache() == 0 || m_cfg.m_subst != 0) {
+            // with a substitution, the results depend on it.
+            disable_persistent_cache();
+            return;
+        }
+        enable_persistent_cache(mk_persistent_key(p));
     }
 };
 
@@ -709,6 +734,7 @@ ast_manager & th_rewriter::m() const {
 void th_rewriter::updt_params(params_ref const & p) {
     m_params = p;
     m_imp->cfg().updt_params(p);
+    m_imp->updt_persistent_cache(p);
 }
 
 void th_rewriter::get_param_descrs(param_descrs & r) {
@@ -741,6 +767,7 @@ void th_rewriter::cleanup() {
 void th_rewriter::reset() {
     m_imp->reset();
     m_imp->cfg().reset();
+    m_imp->updt_persistent_cache(m_params);
 }
 
 void th_rewriter::operator()(expr_ref & term) {
@@ -764,6 +791,7 @@ void th_rewriter::operator()(expr * n, unsigned num_bindings, expr * const * bin
 void th_rewriter::set_substitution(expr_substitution * s) {
     m_imp->reset(); // reset the cache
     m_imp->cfg().set_substitution(s);
+    m_imp->updt_persistent_cache(m_params);
 }
 
 expr_dependency * th_rewriter::get_used_dependencies() {
@@ -1691,6 +1691,7 @@ void cmd_context::display_statistics(bool show_total_time, double total_time) {
     st.update("time", get_seconds());
     get_memory_statistics(st);
     get_rlimit_statistics(m().limit(), st);
+    m().collect_statistics(st);
     if (m_check_sat_result) {
         m_check_sat_result->collect_statistics(st);
     }
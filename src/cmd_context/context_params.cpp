@@ -32,6 +32,8 @@ context_params::context_params() {
     m_proof          = false;
     m_trace          = false;
     m_debug_ref_count = false;
+    m_deferred_deletion = 0;
+    m_rewrite_cache = 0;
     m_smtlib2_compliant = false;
     m_well_sorted_check = false;
     m_timeout = UINT_MAX;
@@ -117,6 +119,12 @@ void context_params::set(char const * param, char const * value) {
     else if (p == "debug_ref_count") {
         set_bool(m_debug_ref_count, param, value);
     }
+    else if (p == "deferred_deletion") {
+        set_uint(m_deferred_deletion, param, value);
+    }
+    else if (p == "rewrite_cache") {
+        set_uint(m_rewrite_cache, param, value);
+    }
     else if (p == "smtlib2_compliant") {
         set_bool(m_smtlib2_compliant, param, value);
     }
@@ -148,6 +156,8 @@ void context_params::updt_params(params_ref const & p) {
     m_trace_file_name   = p.get_str("trace_file_name", "z3.log");
     m_unsat_core        = p.get_bool("unsat_core", m_unsat_core);
     m_debug_ref_count   = p.get_bool("debug_ref_count", m_debug_ref_count);
+    m_deferred_deletion = p.get_uint("deferred_deletion", m_deferred_deletion);
+    m_rewrite_cache     = p.get_uint("rewrite_cache", m_rewrite_cache);
     m_smtlib2_compliant = p.get_bool("smtlib2_compliant", m_smtlib2_compliant);
 }
 
@@ -162,6 +172,8 @@ void context_params::collect_param_descrs(param_descrs & d) {
     d.insert("trace", CPK_BOOL, "trace generation for VCC", "false");
     d.insert("trace_file_name", CPK_STRING, "trace out file name (see option 'trace')", "z3.log");
     d.insert("debug_ref_count", CPK_BOOL, "debug support for AST reference counting", "false");
+    d.insert("deferred_deletion", CPK_UINT, "when greater than 0, terms that are not referenced anymore are deleted incrementally: at most the given number of terms is deleted each time a new term is created", "0");
+    d.insert("rewrite_cache", CPK_UINT, "maximal number of entries of a cache that allows simplifiers to reuse results between invocations, 0 disables the cache", "0");
     d.insert("smtlib2_compliant", CPK_BOOL, "enable/disable SMT-LIB 2.0 compliance", "false");
     collect_solver_param_descrs(d);
 }
@@ -198,6 +210,10 @@ ast_manager * context_params::mk_ast_manager() {
         r->enable_int_real_coercions(false);
     if (m_debug_ref_count)
         r->debug_ref_count();
+    if (m_deferred_deletion > 0)
+        r->enable_deferred_deletion(m_deferred_deletion);
+    if (m_rewrite_cache > 0)
+        r->set_rewrite_cache_size(m_rewrite_cache);
     return r;
 }
 
@@ -32,6 +32,8 @@ public:
     bool        m_proof;
     bool        m_interpolants;
     bool        m_debug_ref_count;
+    unsigned    m_deferred_deletion;
+    unsigned    m_rewrite_cache;
     bool        m_trace;
     std::string m_trace_file_name;
     bool        m_well_sorted_check;
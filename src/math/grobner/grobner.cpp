@@ -19,6 +19,7 @@ Revision History:
 #include"grobner.h"
 #include"ast_pp.h"
 #include"ref_util.h"
+#include"map.h"
 
 // #define PROFILE_GB
 
@@ -29,7 +30,9 @@ grobner::grobner(ast_manager & m, v_dependency_manager & d):
     m_var_lt(m_var2weight),
     m_monomial_lt(m_var_lt),
     m_changed_leading_term(false),
-    m_unsat(0) {
+    m_unsat(0),
+    m_f4(false),
+    m_f4_max_degree(UINT_MAX) {
 }
 
 grobner::~grobner() {
@@ -929,6 +932,10 @@ void grobner::compute_basis_init() {
 }
 
 bool grobner::compute_basis_step() {
+    return m_f4 ? compute_basis_f4_step() : compute_basis_buchberger_step();
+}
+
+bool grobner::compute_basis_buchberger_step() {
     equation * eq = pick_next();
     if (!eq)
         return true;
@@ -960,6 +967,455 @@ bool grobner::compute_basis(unsigned threshold) {
     return false;
 }
 
+// -----------------------------------
+//
+// F4-style reduction
+//
+// -----------------------------------
+
+/**
+   \brief Row of the F4 matrix: (the multiple of) an equation, its justification, and
+   whether it is a linear combination of the input equations.
+*/
+struct grobner::f4_row {
+    unsigned_vector  m_columns;
+    vector<rational> m_coeffs;
+    v_dependency *   m_dep;
+    bool             m_lc;
+    f4_row():m_dep(0), m_lc(true) {}
+};
+
+/**
+   \brief Sparse Macaulay matrix used by compute_basis_f4_step.
+   The columns are the monomials occurring in the rows. A row is an equation multiplied by
+   a (possibly empty) product of variables. After f4_sort_columns, the columns are numbered
+   using the monomial order (column 0 is the biggest monomial), and the entries of each row
+   are sorted by column.
+*/
+struct grobner::f4_matrix {
+    struct hash_proc {
+        unsigned operator()(monomial const * m) const {
+            unsigned h = m->get_degree();
+            for (unsigned i = 0; i < m->get_degree(); i++)
+                h = combine_hash(h, m->get_var(i)->get_id());
+            return h;
+        }
+    };
+    struct eq_proc {
+        bool operator()(monomial const * m1, monomial const * m2) const { return is_eq_monomial_body(m1, m2); }
+    };
+    typedef map<monomial const *, unsigned, hash_proc, eq_proc> monomial2column;
+
+    ptr_vector<monomial> m_columns;     //!< m_columns[c] is the monomial of column c, its coefficient is not used.
+    monomial2column      m_monomial2column;
+    unsigned_vector      m_reducer;     //!< m_reducer[c] is the reducer whose leading monomial is at column c, or UINT_MAX.
+    vector<f4_row>       m_reducers;    //!< processed equations multiplied by monomials.
+    vector<f4_row>       m_rows;        //!< equations being processed.
+};
+
+/**
+   \brief Add eq * rest as a row of the matrix. The new columns are stored in todo.
+*/
+void grobner::f4_add_row(f4_matrix & M, equation const * eq, ptr_vector<expr> const & rest, vector<f4_row> & rows, unsigned_vector & todo) {
+    ptr_vector<monomial> & new_monomials = m_tmp_monomials;
+    new_monomials.reset();
+    mul_append(0, eq, rational(1), rest, new_monomials);
+    rows.push_back(f4_row());
+    f4_row & r = rows.back();
+    r.m_dep = eq->m_dep;
+    r.m_lc  = eq->m_lc && rest.empty();
+    ptr_vector<monomial>::iterator it  = new_monomials.begin();
+    ptr_vector<monomial>::iterator end = new_monomials.end();
+    for (; it != end; ++it) {
+        monomial * m = *it;
+        unsigned c;
+        r.m_coeffs.push_back(m->m_coeff);
+        if (M.m_monomial2column.find(m, c)) {
+            del_monomial(m);
+        }
+        else {
+            c = M.m_columns.size();
+            M.m_columns.push_back(m);
+            M.m_monomial2column.insert(m, c);
+            M.m_reducer.push_back(UINT_MAX);
+            todo.push_back(c);
+        }
+        r.m_columns.push_back(c);
+    }
+    new_monomials.reset();
+}
+
+/**
+   \brief Create the rows for the selected equations, and for every monomial that is
+   a multiple of the leading monomial of a processed equation, add the corresponding multiple
+   of this equation as a reducer.
+*/
+void grobner::f4_symbolic_preprocessing(f4_matrix & M, ptr_vector<equation> const & selected) {
+    unsigned_vector todo;
+    ptr_vector<expr> no_vars;
+    ptr_vector<equation>::const_iterator it  = selected.begin();
+    ptr_vector<equation>::const_iterator end = selected.end();
+    for (; it != end; ++it)
+        f4_add_row(M, *it, no_vars, M.m_rows, todo);
+    ptr_vector<expr> & rest = m_tmp_vars2;
+    while (!todo.empty()) {
+        unsigned c = todo.back();
+        todo.pop_back();
+        monomial const * m = M.m_columns[c];
+        equation_set::iterator it2  = m_processed.begin();
+        equation_set::iterator end2 = m_processed.end();
+        for (; it2 != end2; ++it2) {
+            equation const * p = *it2;
+            if (p->get_num_monomials() == 0)
+                continue;
+            rest.reset();
+            if (is_subset(p->get_monomial(0), m, rest)) {
+                M.m_reducer[c] = M.m_reducers.size();
+                f4_add_row(M, p, rest, M.m_reducers, todo);
+                break;
+            }
+        }
+    }
+}
+
+struct grobner::f4_column_lt {
+    f4_matrix &   m_matrix;
+    monomial_lt & m_lt;
+    f4_column_lt(f4_matrix & M, monomial_lt & lt):m_matrix(M), m_lt(lt) {}
+    bool operator()(unsigned c1, unsigned c2) const { return m_lt(m_matrix.m_columns[c1], m_matrix.m_columns[c2]); }
+};
+
+static void f4_sort_row(unsigned_vector const & pos, unsigned_vector & columns, vector<rational> & coeffs) {
+    svector<std::pair<unsigned, unsigned> > entries;
+    for (unsigned i = 0; i < columns.size(); i++)
+        entries.push_back(std::make_pair(pos[columns[i]], i));
+    std::sort(entries.begin(), entries.end());
+    vector<rational> new_coeffs;
+    for (unsigned i = 0; i < entries.size(); i++) {
+        columns[i] = entries[i].first;
+        new_coeffs.push_back(coeffs[entries[i].second]);
+    }
+    coeffs.swap(new_coeffs);
+}
+
+/**
+   \brief Renumber the columns using the monomial order.
+*/
+void grobner::f4_sort_columns(f4_matrix & M) {
+    unsigned num_columns = M.m_columns.size();
+    unsigned_vector order;
+    for (unsigned c = 0; c < num_columns; c++)
+        order.push_back(c);
+    std::sort(order.begin(), order.end(), f4_column_lt(M, m_monomial_lt));
+    unsigned_vector pos;
+    pos.resize(num_columns, 0);
+    for (unsigned i = 0; i < num_columns; i++)
+        pos[order[i]] = i;
+    ptr_vector<monomial> columns;
+    unsigned_vector      reducer;
+    for (unsigned i = 0; i < num_columns; i++) {
+        columns.push_back(M.m_columns[order[i]]);
+        reducer.push_back(M.m_reducer[order[i]]);
+    }
+    M.m_columns.swap(columns);
+    M.m_reducer.swap(reducer);
+    M.m_monomial2column.reset();
+    for (unsigned i = 0; i < M.m_reducers.size(); i++)
+        f4_sort_row(pos, M.m_reducers[i].m_columns, M.m_reducers[i].m_coeffs);
+    for (unsigned i = 0; i < M.m_rows.size(); i++)
+        f4_sort_row(pos, M.m_rows[i].m_columns, M.m_rows[i].m_coeffs);
+}
+
+// Rows are first reduced modulo a prime. Only the rows that do not vanish modulo the prime
+// are reduced using rational arithmetic. Since most of the rows of the matrix usually reduce
+// to zero, this saves most of the rational arithmetic. An unlucky prime may discard a row
+// that does not vanish over the rationals. This only makes the basis less complete.
+static const uint64 f4_prime = 2147483647ull;
+
+static uint64 f4_mul(uint64 a, uint64 b) { return (a * b) % f4_prime; }
+
+static uint64 f4_inv(uint64 a) {
+    SASSERT(a != 0);
+    uint64 r = 1;
+    uint64 k = f4_prime - 2;
+    while (k > 0) {
+        if (k & 1)
+            r = f4_mul(r, a);
+        a = f4_mul(a, a);
+        k >>= 1;
+    }
+    return r;
+}
+
+static bool f4_to_zp(rational const & a, uint64 & r) {
+    rational p(f4_prime, rational::ui64());
+    rational d = mod(denominator(a), p);
+    if (d.is_zero())
+        return false;
+    rational n = mod(numerator(a), p);
+    r = f4_mul(n.get_uint64(), f4_inv(d.get_uint64()));
+    return true;
+}
+
+struct f4_zp_row {
+    unsigned_vector m_columns;
+    svector<uint64> m_coeffs;
+};
+
+static bool f4_to_zp(unsigned_vector const & columns, vector<rational> const & coeffs, f4_zp_row & r) {
+    r.m_columns.append(columns);
+    for (unsigned i = 0; i < coeffs.size(); i++) {
+        uint64 c;
+        if (!f4_to_zp(coeffs[i], c))
+            return false;
+        r.m_coeffs.push_back(c);
+    }
+    if (r.m_coeffs[0] == 0)
+        return false;
+    uint64 lc_inv = f4_inv(r.m_coeffs[0]);
+    for (unsigned i = 0; i < r.m_coeffs.size(); i++)
+        r.m_coeffs[i] = f4_mul(r.m_coeffs[i], lc_inv);
+    return true;
+}
+
+/**
+   \brief Store in live[i] whether the i-th row does not vanish after reducing the
+   rows modulo a prime. Return false if the coefficients cannot be mapped to the prime field.
+*/
+bool grobner::f4_reduce_zp(f4_matrix const & M, svector<bool> & live) {
+    unsigned num_columns = M.m_columns.size();
+    vector<f4_zp_row> reducers;
+    vector<f4_zp_row> pivots;
+    unsigned_vector   pivot;
+    pivot.resize(num_columns, UINT_MAX);
+    for (unsigned i = 0; i < M.m_reducers.size(); i++) {
+        reducers.push_back(f4_zp_row());
+        if (!f4_to_zp(M.m_reducers[i].m_columns, M.m_reducers[i].m_coeffs, reducers.back()))
+            return false;
+    }
+    svector<uint64> acc;
+    acc.resize(num_columns, 0);
+    for (unsigned i = 0; i < M.m_rows.size(); i++) {
+        if (m_manager.canceled())
+            return false;
+        f4_zp_row r;
+        if (!f4_to_zp(M.m_rows[i].m_columns, M.m_rows[i].m_coeffs, r))
+            return false;
+        for (unsigned j = 0; j < r.m_columns.size(); j++)
+            acc[r.m_columns[j]] = r.m_coeffs[j];
+        unsigned c = r.m_columns[0];
+        for (; c < num_columns; c++) {
+            if (acc[c] == 0)
+                continue;
+            f4_zp_row const * p;
+            if (M.m_reducer[c] != UINT_MAX)
+                p = &reducers[M.m_reducer[c]];
+            else if (pivot[c] != UINT_MAX)
+                p = &pivots[pivot[c]];
+            else
+                break;
+            uint64 k = f4_prime - acc[c];
+            for (unsigned j = 0; j < p->m_columns.size(); j++) {
+                unsigned c2 = p->m_columns[j];
+                acc[c2] = (acc[c2] + f4_mul(k, p->m_coeffs[j])) % f4_prime;
+            }
+            SASSERT(acc[c] == 0);
+        }
+        live.push_back(c < num_columns);
+        if (c < num_columns) {
+            // new pivot, it is not necessary to reduce its tail.
+            pivot[c] = pivots.size();
+            pivots.push_back(f4_zp_row());
+            f4_zp_row & new_p = pivots.back();
+            uint64 lc_inv = f4_inv(acc[c]);
+            for (; c < num_columns; c++) {
+                if (acc[c] != 0) {
+                    new_p.m_columns.push_back(c);
+                    new_p.m_coeffs.push_back(f4_mul(acc[c], lc_inv));
+                    acc[c] = 0;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+   \brief Reduce the rows of the matrix using rational arithmetic, and store the
+   rows that do not vanish in new_rows. The leading monomials of the new rows are
+   not multiples of the leading monomials of the processed equations, and are pairwise distinct.
+   The tails of the new rows are reduced with respect to the processed equations.
+
+   Return false if the reduction was interrupted.
+*/
+bool grobner::f4_reduce(f4_matrix & M, vector<f4_row> & new_rows) {
+    unsigned num_columns = M.m_columns.size();
+    svector<bool> live;
+    if (!f4_reduce_zp(M, live)) {
+        if (m_manager.canceled())
+            return false;
+        live.reset();
+        live.resize(M.m_rows.size(), true);
+    }
+    for (unsigned i = 0; i < M.m_reducers.size(); i++) {
+        f4_row & r = M.m_reducers[i];
+        if (!r.m_coeffs[0].is_one()) {
+            rational lc_inv = rational(1) / r.m_coeffs[0];
+            for (unsigned j = 0; j < r.m_coeffs.size(); j++)
+                r.m_coeffs[j] *= lc_inv;
+        }
+    }
+    unsigned_vector  pivot;
+    pivot.resize(num_columns, UINT_MAX);
+    vector<rational> acc;
+    acc.resize(num_columns, rational::zero());
+    for (unsigned i = 0; i < M.m_rows.size(); i++) {
+        m_stats.m_f4_rows++;
+        if (!live[i]) {
+            m_stats.m_f4_zero_rows++;
+            continue;
+        }
+        if (m_manager.canceled())
+            return false;
+        f4_row const & r = M.m_rows[i];
+        v_dependency * dep = r.m_dep;
+        bool lc            = r.m_lc;
+        for (unsigned j = 0; j < r.m_columns.size(); j++)
+            acc[r.m_columns[j]] = r.m_coeffs[j];
+        unsigned lead = UINT_MAX;
+        for (unsigned c = r.m_columns[0]; c < num_columns; c++) {
+            if (acc[c].is_zero())
+                continue;
+            f4_row const * p;
+            if (M.m_reducer[c] != UINT_MAX)
+                p = &M.m_reducers[M.m_reducer[c]];
+            else if (lead == UINT_MAX && pivot[c] != UINT_MAX)
+                p = &new_rows[pivot[c]];
+            else {
+                if (lead == UINT_MAX)
+                    lead = c;
+                continue;
+            }
+            rational k = acc[c];
+            k.neg();
+            for (unsigned j = 0; j < p->m_columns.size(); j++) {
+                unsigned c2 = p->m_columns[j];
+                acc[c2] += k * p->m_coeffs[j];
+            }
+            SASSERT(acc[c].is_zero());
+            dep = m_dep_manager.mk_join(dep, p->m_dep);
+            lc  = lc && p->m_lc;
+        }
+        if (lead == UINT_MAX) {
+            m_stats.m_f4_zero_rows++;
+            continue;
+        }
+        pivot[lead] = new_rows.size();
+        new_rows.push_back(f4_row());
+        f4_row & new_r = new_rows.back();
+        new_r.m_dep = dep;
+        new_r.m_lc  = lc;
+        rational lc_inv = rational(1) / acc[lead];
+        for (unsigned c = lead; c < num_columns; c++) {
+            if (!acc[c].is_zero()) {
+                new_r.m_columns.push_back(c);
+                new_r.m_coeffs.push_back(acc[c] * lc_inv);
+                acc[c].reset();
+            }
+        }
+    }
+    return true;
+}
+
+/**
+   \brief F4-style step: the unprocessed equations with leading monomials of minimal degree are
+   reduced together with respect to the processed equations. The reduction is performed using
+   Gaussian elimination on a sparse matrix instead of pairwise simplifications.
+*/
+bool grobner::compute_basis_f4_step() {
+    if (inconsistent())
+        return true;
+    unsigned min_degree = UINT_MAX;
+    ptr_buffer<equation> to_delete;
+    equation_set::iterator it  = m_to_process.begin();
+    equation_set::iterator end = m_to_process.end();
+    for (; it != end; ++it) {
+        equation * curr = *it;
+        if (is_trivial(curr))
+            to_delete.push_back(curr);
+        else
+            min_degree = std::min(min_degree, curr->m_monomials[0]->get_degree());
+    }
+    for (unsigned i = 0; i < to_delete.size(); i++)
+        del_equation(to_delete[i]);
+    if (min_degree == UINT_MAX)
+        return true;
+    if (min_degree > m_f4_max_degree)
+        return compute_basis_buchberger_step();
+
+    ptr_vector<equation> selected;
+    for (it = m_to_process.begin(), end = m_to_process.end(); it != end; ++it) {
+        equation * curr = *it;
+        if (curr->m_monomials[0]->get_degree() == min_degree)
+            selected.push_back(curr);
+    }
+    for (unsigned i = 0; i < selected.size(); i++)
+        m_to_process.erase(selected[i]);
+    m_stats.m_f4_steps++;
+    m_stats.m_num_processed += selected.size();
+
+    f4_matrix M;
+    vector<f4_row> new_rows;
+    f4_symbolic_preprocessing(M, selected);
+    f4_sort_columns(M);
+    TRACE("grobner", tout << "F4 matrix: " << M.m_rows.size() << " rows, " << M.m_reducers.size() << " reducers, "
+          << M.m_columns.size() << " columns\n";);
+    bool ok = f4_reduce(M, new_rows);
+    ptr_vector<equation> new_eqs;
+    if (ok) {
+        for (unsigned i = 0; i < new_rows.size(); i++) {
+            f4_row const & r = new_rows[i];
+            equation * eq = alloc(equation);
+            for (unsigned j = 0; j < r.m_columns.size(); j++) {
+                monomial * m = copy_monomial(M.m_columns[r.m_columns[j]]);
+                m->m_coeff   = r.m_coeffs[j];
+                eq->m_monomials.push_back(m);
+            }
+            init_equation(eq, r.m_dep);
+            eq->m_lc = r.m_lc;
+            new_eqs.push_back(eq);
+        }
+    }
+    del_monomials(M.m_columns);
+
+    if (!ok) {
+        // interrupted, the selected equations are restored
+        for (unsigned i = 0; i < selected.size(); i++)
+            m_to_process.insert(selected[i]);
+        return false;
+    }
+
+    // the selected equations were replaced by the new ones.
+    for (unsigned i = 0; i < selected.size(); i++) {
+        equation * eq = selected[i];
+        if (eq->m_scope_lvl < get_scope_level())
+            m_equations_to_unfreeze.push_back(eq);
+        else
+            del_equation(eq);
+    }
+
+    for (unsigned i = 0; i < new_eqs.size(); i++) {
+        equation * eq = new_eqs[i];
+        simplify(eq);
+        simplify_processed(eq);
+        superpose(eq);
+        m_processed.insert(eq);
+        simplify_to_process(eq);
+    }
+    TRACE("grobner", tout << "end of F4 step:\n"; display(tout););
+    return false;
+}
+
 void grobner::copy_to(equation_set const & s, ptr_vector<equation> & result) const {
     equation_set::iterator it  = s.begin();
     equation_set::iterator end = s.end();
@@ -29,6 +29,7 @@ Revision History:
 
 struct grobner_stats {
     long m_simplify; long m_superpose; long m_compute_basis; long m_num_processed;
+    long m_f4_steps; long m_f4_rows; long m_f4_zero_rows;
     void reset() { memset(this, 0, sizeof(grobner_stats)); }
     grobner_stats() { reset(); }
 };
@@ -40,6 +41,9 @@ struct grobner_stats {
 class grobner {
 protected:
     struct monomial_lt;
+    struct f4_row;
+    struct f4_matrix;
+    struct f4_column_lt;
 public:
     grobner_stats m_stats;
     class monomial {
@@ -114,6 +118,8 @@ protected:
     ptr_vector<expr>        m_tmp_vars1;
     ptr_vector<expr>        m_tmp_vars2;
     unsigned                m_num_new_equations; // temporary variable
+    bool                    m_f4;            // use F4-style reduction steps.
+    unsigned                m_f4_max_degree; // use Buchberger steps for equations of bigger degree.
 
     bool is_monomial_lt(monomial const & m1, monomial const & m2) const;
 
@@ -187,6 +193,20 @@ protected:
 
     void copy_to(equation_set const & s, ptr_vector<equation> & result) const;
 
+    void f4_add_row(f4_matrix & M, equation const * eq, ptr_vector<expr> const & rest, vector<f4_row> & rows, unsigned_vector & todo);
+
+    void f4_symbolic_preprocessing(f4_matrix & M, ptr_vector<equation> const & selected);
+
+    void f4_sort_columns(f4_matrix & M);
+
+    bool f4_reduce_zp(f4_matrix const & M, svector<bool> & live);
+
+    bool f4_reduce(f4_matrix & M, vector<f4_row> & new_rows);
+
+    bool compute_basis_buchberger_step();
+
+    bool compute_basis_f4_step();
+
 public:
     grobner(ast_manager & m, v_dependency_manager & dep_m);
 
@@ -203,6 +223,13 @@ public:
 
     int get_weight(expr * n) const { int w = 0; m_var2weight.find(n, w); return w; }
 
+    /**
+       \brief Use F4-style steps: all unprocessed equations of minimal degree are reduced at once
+       using Gaussian elimination on a sparse matrix. Equations of degree bigger than max_degree
+       are processed using Buchberger steps.
+    */
+    void set_f4(bool f, unsigned max_degree = UINT_MAX) { m_f4 = f; m_f4_max_degree = max_degree; }
+
     /**
        \brief Update equations after set_weight was invoked once or more.
     */
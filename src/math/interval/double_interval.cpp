@@ -0,0 +1,316 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    double_interval.cpp
+
+Abstract:
+
+    Batched interval arithmetic over hardware doubles with outward rounding.
+
+Author:
+
+Revision History:
+
+--*/
+#include<math.h>
+#include<string.h>
+#include<algorithm>
+#include"double_interval.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define DINTERVAL_SSE2
+#include<emmintrin.h>
+#else
+#include<fenv.h>
+#endif
+
+dinterval dinterval::entire() {
+    return dinterval(-HUGE_VAL, HUGE_VAL);
+}
+
+// -----------------------------------
+//
+// Rounding mode
+//
+// -----------------------------------
+
+dinterval_round_up::dinterval_round_up() {
+#ifdef DINTERVAL_SSE2
+    m_old = _mm_getcsr();
+    _mm_setcsr((m_old & ~_MM_ROUND_MASK) | _MM_ROUND_UP);
+#else
+    m_old = fegetround();
+    fesetround(FE_UPWARD);
+#endif
+}
+
+dinterval_round_up::~dinterval_round_up() {
+#ifdef DINTERVAL_SSE2
+    _mm_setcsr(m_old);
+#else
+    fesetround(m_old);
+#endif
+}
+
+// -----------------------------------
+//
+// Conversion
+//
+// -----------------------------------
+
+static uint64 dbl2raw(double d) { uint64 r; memcpy(&r, &d, sizeof(double)); return r; }
+static double raw2dbl(uint64 r) { double d; memcpy(&d, &r, sizeof(double)); return d; }
+
+// successor of a finite double
+static double next_up(double d) {
+    if (d == 0.0)
+        return raw2dbl(1); // smallest positive subnormal
+    uint64 r = dbl2raw(d);
+    return raw2dbl(d > 0.0 ? r + 1 : r - 1);
+}
+
+static double next_down(double d) {
+    return -next_up(-d);
+}
+
+// store the finite double d in r
+static void to_mpq(unsynch_mpq_manager & m, double d, mpq & r) {
+    uint64 raw    = dbl2raw(d);
+    bool   is_neg = (raw >> 63) != 0;
+    int    exp    = static_cast<int>((raw >> 52) & 0x7FF);
+    uint64 sig    = raw & 0x000FFFFFFFFFFFFFull;
+    if (exp == 0)
+        exp = 1; // subnormal
+    else
+        sig |= 0x0010000000000000ull;
+    exp -= 1075;
+    // d = sig * 2^exp
+    scoped_mpz n(m), k(m);
+    m.set(n, static_cast<int64>(sig));
+    if (is_neg)
+        m.neg(n);
+    m.set(k, 1);
+    if (exp >= 0) {
+        m.mul2k(n, exp);
+    }
+    else {
+        m.mul2k(k, -exp);
+    }
+    m.set(r, n, k);
+}
+
+// 2^53: integers of smaller absolute value are represented exactly
+static const int64 max_exact_int = 0x20000000000000ll;
+
+void dinterval_set(unsynch_mpq_manager & m, mpz const & a, dinterval & r) {
+    if (m.is_int64(a)) {
+        int64 v = m.get_int64(a);
+        if (-max_exact_int <= v && v <= max_exact_int) {
+            double d = static_cast<double>(v);
+            r = dinterval(d, d);
+            return;
+        }
+    }
+    scoped_mpq q(m);
+    m.set(q, a);
+    dinterval_set(m, q, r);
+}
+
+void dinterval_set(unsynch_mpq_manager & m, mpq const & a, dinterval & r) {
+    if (m.is_int(a) && m.is_int64(a.numerator())) {
+        int64 v = m.get_int64(a.numerator());
+        if (-max_exact_int <= v && v <= max_exact_int) {
+            double d = static_cast<double>(v);
+            r = dinterval(d, d);
+            return;
+        }
+    }
+    // The approximation computed by get_double is not necessarily correctly rounded.
+    // So, the enclosure is checked using precise arithmetic.
+    double d = m.get_double(a);
+    if (d != d || d == HUGE_VAL || d == -HUGE_VAL) {
+        r = dinterval::entire();
+        return;
+    }
+    scoped_mpq q(m);
+    to_mpq(m, d, q);
+    if (m.eq(q, a)) {
+        r = dinterval(d, d);
+        return;
+    }
+    double l, u;
+    if (m.lt(q, a)) {
+        l = d;
+        u = next_up(d);
+        if (u == HUGE_VAL) {
+            r = dinterval::entire();
+            return;
+        }
+        to_mpq(m, u, q);
+        if (m.lt(q, a)) {
+            r = dinterval::entire();
+            return;
+        }
+    }
+    else {
+        u = d;
+        l = next_down(d);
+        if (l == -HUGE_VAL) {
+            r = dinterval::entire();
+            return;
+        }
+        to_mpq(m, l, q);
+        if (m.gt(q, a)) {
+            r = dinterval::entire();
+            return;
+        }
+    }
+    r = dinterval(l, u);
+}
+
+// -----------------------------------
+//
+// Arithmetic
+//
+// The following functions assume the rounding mode is +oo.
+// Since the lower bound is stored negated, the arithmetic
+// on both components is the same up to a swap.
+//
+// -----------------------------------
+
+#ifdef DINTERVAL_SSE2
+
+static inline __m128d load(dinterval const & a) { return _mm_loadu_pd(&a.m_neg_l); }
+static inline void store(__m128d v, dinterval & r) { _mm_storeu_pd(&r.m_neg_l, v); }
+static inline __m128d swap(__m128d v) { return _mm_shuffle_pd(v, v, 1); }
+// replace NaN (obtained from 0 * oo) with 0
+static inline __m128d nan2zero(__m128d v) { return _mm_andnot_pd(_mm_cmpunord_pd(v, v), v); }
+
+void dinterval_add(unsigned sz, dinterval const * a, dinterval const * b, dinterval * r) {
+    // (-l1, u1) + (-l2, u2)
+    for (unsigned i = 0; i < sz; i++)
+        store(_mm_add_pd(load(a[i]), load(b[i])), r[i]);
+}
+
+void dinterval_add(unsigned sz, dinterval const & a, dinterval const * b, dinterval * r) {
+    __m128d va = load(a);
+    for (unsigned i = 0; i < sz; i++)
+        store(_mm_add_pd(va, load(b[i])), r[i]);
+}
+
+void dinterval_sub(unsigned sz, dinterval const * a, dinterval const * b, dinterval * r) {
+    // (-l1, u1) + (u2, -l2)
+    for (unsigned i = 0; i < sz; i++)
+        store(_mm_add_pd(load(a[i]), swap(load(b[i]))), r[i]);
+}
+
+void dinterval_sub(unsigned sz, dinterval const & a, dinterval const * b, dinterval * r) {
+    __m128d va = load(a);
+    for (unsigned i = 0; i < sz; i++)
+        store(_mm_add_pd(va, swap(load(b[i]))), r[i]);
+}
+
+void dinterval_mul(unsigned sz, dinterval const * a, dinterval const * b, dinterval * r) {
+    __m128d sign = _mm_set1_pd(-0.0);
+    for (unsigned i = 0; i < sz; i++) {
+        __m128d va  = load(a[i]);         // (-l1, u1)
+        __m128d nva = _mm_xor_pd(va, sign); // (l1, -u1)
+        __m128d vb  = load(b[i]);         // (-l2, u2)
+        __m128d svb = swap(vb);           // (u2, -l2)
+        // candidates for -l: -l1*u2, -u1*l2, -l1*l2, -u1*u2
+        __m128d neg_l = _mm_max_pd(nan2zero(_mm_mul_pd(va, svb)), nan2zero(_mm_mul_pd(nva, vb)));
+        // candidates for u: l1*l2, u1*u2, l1*u2, u1*l2
+        __m128d u     = _mm_max_pd(nan2zero(_mm_mul_pd(va, vb)), nan2zero(_mm_mul_pd(nva, svb)));
+        store(_mm_max_pd(_mm_unpacklo_pd(neg_l, u), _mm_unpackhi_pd(neg_l, u)), r[i]);
+    }
+}
+
+void dinterval_sum(unsigned sz, dinterval const * a, dinterval & r) {
+    __m128d acc = _mm_setzero_pd();
+    for (unsigned i = 0; i < sz; i++)
+        acc = _mm_add_pd(acc, load(a[i]));
+    store(acc, r);
+}
+
+#else
+
+static inline double mul_up(double a, double b) {
+    if (a == 0.0 || b == 0.0)
+        return 0.0;
+    return a * b;
+}
+
+static inline double max4(double a, double b, double c, double d) {
+    return std::max(std::max(a, b), std::max(c, d));
+}
+
+void dinterval_add(unsigned sz, dinterval const * a, dinterval const * b, dinterval * r) {
+    for (unsigned i = 0; i < sz; i++) {
+        r[i].m_neg_l = a[i].m_neg_l + b[i].m_neg_l;
+        r[i].m_u     = a[i].m_u + b[i].m_u;
+    }
+}
+
+void dinterval_add(unsigned sz, dinterval const & a, dinterval const * b, dinterval * r) {
+    dinterval c = a;
+    for (unsigned i = 0; i < sz; i++) {
+        r[i].m_neg_l = c.m_neg_l + b[i].m_neg_l;
+        r[i].m_u     = c.m_u + b[i].m_u;
+    }
+}
+
+void dinterval_sub(unsigned sz, dinterval const * a, dinterval const * b, dinterval * r) {
+    for (unsigned i = 0; i < sz; i++) {
+        double neg_l = a[i].m_neg_l + b[i].m_u;
+        r[i].m_u     = a[i].m_u + b[i].m_neg_l;
+        r[i].m_neg_l = neg_l;
+    }
+}
+
+void dinterval_sub(unsigned sz, dinterval const & a, dinterval const * b, dinterval * r) {
+    dinterval c = a;
+    for (unsigned i = 0; i < sz; i++) {
+        double neg_l = c.m_neg_l + b[i].m_u;
+        r[i].m_u     = c.m_u + b[i].m_neg_l;
+        r[i].m_neg_l = neg_l;
+    }
+}
+
+void dinterval_mul(unsigned sz, dinterval const * a, dinterval const * b, dinterval * r) {
+    for (unsigned i = 0; i < sz; i++) {
+        double nl1 = a[i].m_neg_l, u1 = a[i].m_u;
+        double nl2 = b[i].m_neg_l, u2 = b[i].m_u;
+        // candidates for -l: -l1*u2, -u1*l2, -l1*l2, -u1*u2
+        double neg_l = max4(mul_up(nl1, u2), mul_up(u1, nl2), mul_up(-nl1, nl2), mul_up(-u1, u2));
+        // candidates for u: l1*l2, u1*u2, l1*u2, u1*l2
+        double u     = max4(mul_up(nl1, nl2), mul_up(u1, u2), mul_up(-nl1, u2), mul_up(-u1, nl2));
+        r[i].m_neg_l = neg_l;
+        r[i].m_u     = u;
+    }
+}
+
+void dinterval_sum(unsigned sz, dinterval const * a, dinterval & r) {
+    double neg_l = 0.0, u = 0.0;
+    for (unsigned i = 0; i < sz; i++) {
+        neg_l += a[i].m_neg_l;
+        u     += a[i].m_u;
+    }
+    r.m_neg_l = neg_l;
+    r.m_u     = u;
+}
+
+#endif
+
+void dinterval_div(dinterval const & a, dinterval const & b, dinterval & r) {
+    if (b.contains_zero()) {
+        r = dinterval::entire();
+        return;
+    }
+    // 1/[l, u] = [1/u, 1/l]
+    dinterval inv;
+    inv.m_neg_l = -1.0 / b.m_u;
+    inv.m_u     = 1.0 / (-b.m_neg_l);
+    dinterval_mul(a, inv, r);
+}
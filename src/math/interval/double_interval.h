@@ -0,0 +1,89 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    double_interval.h
+
+Abstract:
+
+    Batched interval arithmetic over hardware doubles with outward rounding.
+
+    The rounding mode is set to +oo once for a whole batch of operations
+    (see dinterval_round_up), instead of switching it for each end point.
+    For this purpose, an interval [l, u] is stored as the pair (-l, u), and
+    both components are rounded up: the lower bound -(-l) is then rounded down.
+    The pair fits in one SSE2 register, and most operations are a few
+    packed instructions.
+
+    The main application is a cheap and sound filter for propagation
+    procedures that use precise numerals (e.g., mpq): an enclosure of the
+    precise result is computed first, and the precise computation is skipped
+    if the enclosure shows it would not produce anything new.
+
+Author:
+
+Revision History:
+
+--*/
+#ifndef DOUBLE_INTERVAL_H_
+#define DOUBLE_INTERVAL_H_
+
+#include<math.h>
+#include"mpq.h"
+
+/**
+   \brief Closed interval [lower(), upper()] of doubles.
+   The lower bound is stored negated. -oo and +oo are represented by HUGE_VAL.
+*/
+struct dinterval {
+    double m_neg_l;
+    double m_u;
+    dinterval() {}
+    dinterval(double l, double u):m_neg_l(-l), m_u(u) {}
+    double lower() const { return -m_neg_l; }
+    double upper() const { return m_u; }
+    bool contains_zero() const { return m_neg_l >= 0.0 && m_u >= 0.0; }
+    // false if one of the end points is infinite or NaN
+    bool is_finite() const { return m_neg_l < HUGE_VAL && m_u < HUGE_VAL && m_neg_l > -HUGE_VAL && m_u > -HUGE_VAL; }
+    static dinterval entire();
+};
+
+/**
+   \brief Set the rounding mode to +oo while this object is alive.
+   The functions below that perform arithmetic must only be used in the scope of this object.
+*/
+class dinterval_round_up {
+    unsigned m_old;
+public:
+    dinterval_round_up();
+    ~dinterval_round_up();
+};
+
+/**
+   \brief Store in r an enclosure of the given numeral. The result does not depend on
+   the rounding mode. r is the entire line if a is out of the range of doubles.
+*/
+void dinterval_set(unsynch_mpq_manager & m, mpq const & a, dinterval & r);
+void dinterval_set(unsynch_mpq_manager & m, mpz const & a, dinterval & r);
+
+// r[i] := a[i] + b[i]
+void dinterval_add(unsigned sz, dinterval const * a, dinterval const * b, dinterval * r);
+// r[i] := a + b[i]
+void dinterval_add(unsigned sz, dinterval const & a, dinterval const * b, dinterval * r);
+// r[i] := a[i] - b[i]
+void dinterval_sub(unsigned sz, dinterval const * a, dinterval const * b, dinterval * r);
+// r[i] := a - b[i]
+void dinterval_sub(unsigned sz, dinterval const & a, dinterval const * b, dinterval * r);
+// r[i] := a[i] * b[i]
+void dinterval_mul(unsigned sz, dinterval const * a, dinterval const * b, dinterval * r);
+// r := a[0] + ... + a[sz-1]
+void dinterval_sum(unsigned sz, dinterval const * a, dinterval & r);
+// r := a / b, r is the entire line if b contains zero.
+void dinterval_div(dinterval const & a, dinterval const & b, dinterval & r);
+
+inline void dinterval_add(dinterval const & a, dinterval const & b, dinterval & r) { dinterval_add(1, &a, &b, &r); }
+inline void dinterval_sub(dinterval const & a, dinterval const & b, dinterval & r) { dinterval_sub(1, &a, &b, &r); }
+inline void dinterval_mul(dinterval const & a, dinterval const & b, dinterval & r) { dinterval_mul(1, &a, &b, &r); }
+
+#endif /* DOUBLE_INTERVAL_H_ */
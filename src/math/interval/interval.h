@@ -121,7 +121,6 @@ private:
     numeral    m_mul_bd;
     numeral    m_one;
     numeral    m_minus_one;
-    numeral    m_inv_k;
 
     unsigned   m_pi_n;
     interval   m_pi_div_2;
@@ -50,7 +50,6 @@ interval_manager<C>::~interval_manager() {
     m().del(m_mul_bd);
     m().del(m_minus_one);
     m().del(m_one);
-    m().del(m_inv_k);
 }
 
 template<typename C>
@@ -866,13 +865,12 @@ void interval_manager<C>::div_mul(numeral const & k, interval const & a, interva
             set_lower_is_open(b, l_o);
             set_upper_is_open(b, u_o);
             if (inv_k) {
+                // l/k is rounded once, the rounding of 1/k in l*(1/k) would depend on the sign of l.
                 round_to_minus_inf();
-                m().inv(k, m_inv_k);
-                ::mul(m(), l, l_k, m_inv_k, EN_NUMERAL, new_l_val, new_l_kind);
+                ::div(m(), l, l_k, k, EN_NUMERAL, new_l_val, new_l_kind);
                 
                 round_to_plus_inf();
-                m().inv(k, m_inv_k);
-                ::mul(m(), u, u_k, m_inv_k, EN_NUMERAL, new_u_val, new_u_kind);
+                ::div(m(), u, u_k, k, EN_NUMERAL, new_u_val, new_u_kind);
             }
             else {
                 round_to_minus_inf();
@@ -886,12 +884,10 @@ void interval_manager<C>::div_mul(numeral const & k, interval const & a, interva
             set_upper_is_open(b, l_o);
             if (inv_k) {
                 round_to_minus_inf();
-                m().inv(k, m_inv_k);
-                ::mul(m(), u, u_k, m_inv_k, EN_NUMERAL, new_l_val, new_l_kind);
+                ::div(m(), u, u_k, k, EN_NUMERAL, new_l_val, new_l_kind);
 
                 round_to_plus_inf();
-                m().inv(k, m_inv_k);
-                ::mul(m(), l, l_k, m_inv_k, EN_NUMERAL, new_u_val, new_u_kind);
+                ::div(m(), l, l_k, k, EN_NUMERAL, new_u_val, new_u_kind);
             }
             else {
                 round_to_minus_inf();
@@ -89,12 +89,17 @@ namespace algebraic_numbers {
         bool                       m_factor;
         polynomial::factor_params  m_factor_params;
         int                        m_zero_accuracy;
+        enum isolation_kind { ISOLATE_DRS, ISOLATE_VCA, ISOLATE_STURM };
+        isolation_kind             m_isolation;
+        unsigned                   m_isolation_threads;
+        unsigned                   m_par_isolation_min_degree;
 
         // statistics            
         unsigned                 m_compare_cheap;
         unsigned                 m_compare_sturm;
         unsigned                 m_compare_refine;
         unsigned                 m_compare_poly_eq;
+        unsigned                 m_par_isolations;
 
         imp(reslimit& lim, manager & w, unsynch_mpq_manager & m, params_ref const & p, small_object_allocator & a):
             m_limit(lim),
@@ -135,6 +140,7 @@ namespace algebraic_numbers {
             m_compare_sturm   = 0;
             m_compare_refine  = 0;
             m_compare_poly_eq = 0;
+            m_par_isolations  = 0;
         }
 
         void collect_statistics(statistics & st) {
@@ -143,6 +149,7 @@ namespace algebraic_numbers {
             st.update("algebraic compare sturm", m_compare_sturm);
             st.update("algebraic compare refine", m_compare_refine);
             st.update("algebraic compare poly", m_compare_poly_eq);
+            st.update("algebraic par isolations", m_par_isolations);
 #endif
         }
 
@@ -154,6 +161,15 @@ namespace algebraic_numbers {
             m_factor_params.m_p_trials = p.factor_num_primes();
             m_factor_params.m_max_search_size = p.factor_search_size();
             m_zero_accuracy            = -static_cast<int>(p.zero_accuracy());
+            symbol isolation           = p.isolation();
+            if (isolation == "vca")
+                m_isolation = ISOLATE_VCA;
+            else if (isolation == "sturm")
+                m_isolation = ISOLATE_STURM;
+            else
+                m_isolation = ISOLATE_DRS;
+            m_isolation_threads        = p.isolation_threads();
+            m_par_isolation_min_degree = p.par_isolation_min_degree();
         }
 
         unsynch_mpq_manager & qm() { 
@@ -564,6 +580,26 @@ namespace algebraic_numbers {
             std::sort(r.begin(), r.end(), lt_proc(m_wrapper));
         }
         
+        // Isolate the roots of a square free polynomial f that does not have zero roots
+        void sqf_nz_isolate_roots(upoly const & f, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers) {
+            if (m_isolation_threads > 1 && upm().degree(f) >= m_par_isolation_min_degree) {
+                m_par_isolations++;
+                upm().par_isolate_roots(f.size(), f.c_ptr(), m_isolation_threads, bqm(), roots, lowers, uppers);
+                return;
+            }
+            switch (m_isolation) {
+            case ISOLATE_VCA:
+                upm().vca_isolate_roots(f.size(), f.c_ptr(), bqm(), roots, lowers, uppers);
+                break;
+            case ISOLATE_STURM:
+                upm().sturm_isolate_roots(f.size(), f.c_ptr(), bqm(), roots, lowers, uppers);
+                break;
+            default:
+                upm().sqf_isolate_roots(f.size(), f.c_ptr(), bqm(), roots, lowers, uppers);
+                break;
+            }
+        }
+
         void isolate_roots(scoped_upoly const & up, numeral_vector & roots) {
             if (up.empty())
                 return; // ignore the zero polynomial
@@ -599,7 +635,7 @@ namespace algebraic_numbers {
                     continue;
                 }
                 SASSERT(m_isolate_roots.empty() && m_isolate_lowers.empty() && m_isolate_uppers.empty());
-                upm().sqf_isolate_roots(f.size(), f.c_ptr(), bqm(), m_isolate_roots, m_isolate_lowers, m_isolate_uppers);
+                sqf_nz_isolate_roots(f, m_isolate_roots, m_isolate_lowers, m_isolate_uppers);
                 // collect rational/basic roots
                 unsigned sz = m_isolate_roots.size();
                 for (unsigned i = 0; i < sz; i++) {
@@ -402,6 +402,109 @@ unsigned mpz_matrix_manager::linear_independent_rows(mpz_matrix const & _A, unsi
     return r_sz;
 }
 
+void mpz_matrix_manager::dot_rows(mpz_matrix const & A, unsigned i, unsigned j, mpz & r) {
+    nm().reset(r);
+    for (unsigned k = 0; k < A.n; k++)
+        nm().addmul(r, A(i, k), A(j, k), r);
+}
+
+// Size reduction step of the integral LLL: b_k <- b_k - q*b_l where q = round(lambda_kl / d_l)
+void mpz_matrix_manager::lll_reduce(mpz_matrix & A, mpz_matrix & lambda, mpz const * d, unsigned k, unsigned l) {
+    scoped_mpz two_l(nm()), q(nm());
+    nm().mul2k(lambda(k, l), 1, two_l);
+    nm().abs(two_l);
+    if (nm().le(two_l, d[l+1]))
+        return;
+    // q = floor((2*lambda_kl + d_l) / (2*d_l))
+    nm().mul2k(lambda(k, l), 1, q);
+    nm().add(q, d[l+1], q);
+    nm().mul2k(d[l+1], 1, two_l);
+    nm().div(q, two_l, q);
+    for (unsigned j = 0; j < A.n; j++)
+        nm().submul(A(k, j), q, A(l, j), A(k, j));
+    nm().submul(lambda(k, l), q, d[l+1], lambda(k, l));
+    for (unsigned i = 0; i < l; i++)
+        nm().submul(lambda(k, i), q, lambda(l, i), lambda(k, i));
+}
+
+void mpz_matrix_manager::lll_swap(mpz_matrix & A, mpz_matrix & lambda, mpz * d, unsigned k, unsigned k_max) {
+    swap_rows(A, k, k-1);
+    for (unsigned j = 0; j + 1 < k; j++)
+        ::swap(lambda(k, j), lambda(k-1, j));
+    mpz const & l = lambda(k, k-1);
+    scoped_mpz B(nm()), t(nm()), tmp(nm());
+    // B = (d_{k-2}*d_k + l^2) / d_{k-1}
+    nm().mul(d[k-1], d[k+1], B);
+    nm().addmul(B, l, l, B);
+    nm().div(B, d[k], B);
+    for (unsigned i = k + 1; i <= k_max; i++) {
+        nm().set(t, lambda(i, k));
+        nm().mul(d[k+1], lambda(i, k-1), tmp);
+        nm().submul(tmp, l, t, tmp);
+        nm().div(tmp, d[k], lambda(i, k));
+        nm().mul(B, t, tmp);
+        nm().addmul(tmp, l, lambda(i, k), tmp);
+        nm().div(tmp, d[k+1], lambda(i, k-1));
+    }
+    nm().set(d[k], B);
+}
+
+bool mpz_matrix_manager::lll(mpz_matrix & A, mpz * d) {
+    unsigned n = A.m;
+    // lambda(i, j) for j < i stores d_j * mu_ij
+    scoped_mpz_matrix lambda(*this);
+    mk(n, n, lambda);
+    scoped_mpz u(nm()), lhs(nm()), rhs(nm()), tmp(nm());
+    nm().set(d[0], 1);
+    dot_rows(A, 0, 0, d[1]);
+    if (nm().is_zero(d[1]))
+        return false;
+    unsigned k = 1;
+    unsigned k_max = 0;
+    while (k < n) {
+        if (k > k_max) {
+            // incremental Gram-Schmidt
+            k_max = k;
+            for (unsigned j = 0; j <= k; j++) {
+                dot_rows(A, k, j, u);
+                for (unsigned i = 0; i < j; i++) {
+                    nm().mul(d[i+1], u, u);
+                    nm().submul(u, lambda(k, i), lambda(j, i), u);
+                    nm().div(u, d[i], u);
+                }
+                if (j < k) {
+                    nm().set(lambda(k, j), u);
+                }
+                else {
+                    if (nm().is_zero(u))
+                        return false; // rows are linearly dependent
+                    nm().set(d[k+1], u);
+                }
+            }
+        }
+        lll_reduce(A, lambda, d, k, k-1);
+        // Lovasz condition with delta = 3/4: 4*d_k*d_{k-2} >= 3*d_{k-1}^2 - 4*lambda_{k,k-1}^2
+        nm().mul(d[k+1], d[k-1], lhs);
+        nm().mul2k(lhs, 2);
+        nm().mul(d[k], d[k], rhs);
+        nm().mul(rhs, mpz(3), rhs);
+        nm().mul(lambda(k, k-1), lambda(k, k-1), tmp);
+        nm().mul2k(tmp, 2);
+        nm().sub(rhs, tmp, rhs);
+        if (nm().lt(lhs, rhs)) {
+            lll_swap(A, lambda, d, k, k_max);
+            if (k > 1)
+                k--;
+        }
+        else {
+            for (unsigned l = k - 1; l-- > 0; )
+                lll_reduce(A, lambda, d, k, l);
+            k++;
+        }
+    }
+    return true;
+}
+
 void mpz_matrix_manager::display(std::ostream & out, mpz_matrix const & A, unsigned cell_width) const {
     out << A.m << " x " << A.n << " Matrix\n";
     for (unsigned i = 0; i < A.m; i++) {
@@ -21,6 +21,9 @@ Abstract:
         an overkill to use mpz instead of int. We use mpz just to be safe. 
         Remark: We do not use rational arithmetic. The solver is slightly more complicated with integers, but is saves space.
 
+    It also provides LLL lattice basis reduction, which is used to recombine
+    the modular factors in univariate polynomial factorization.
+
 Author:
 
     Leonardo (leonardo) 2013-01-07
@@ -62,6 +65,9 @@ class mpz_matrix_manager {
     bool normalize_row(mpz * A_i, unsigned n, mpz * b_i, bool int_solver);
     bool eliminate(mpz_matrix & A, mpz * b, unsigned k1, unsigned k2, bool int_solver);
     bool solve_core(mpz_matrix const & A, mpz * b, bool int_solver);
+    void dot_rows(mpz_matrix const & A, unsigned i, unsigned j, mpz & r);
+    void lll_reduce(mpz_matrix & A, mpz_matrix & lambda, mpz const * d, unsigned k, unsigned l);
+    void lll_swap(mpz_matrix & A, mpz_matrix & lambda, mpz * d, unsigned k, unsigned k_max);
 public:
     mpz_matrix_manager(unsynch_mpz_manager & nm, small_object_allocator & a);
     ~mpz_matrix_manager();
@@ -113,6 +119,20 @@ public:
     */
     unsigned linear_independent_rows(mpz_matrix const & A, unsigned * r, mpz_matrix & B);
 
+    /**
+       \brief LLL-reduce (with delta = 3/4) the basis formed by the rows of A.
+       The integral version of the algorithm is used, so no rational arithmetic
+       is needed [Cohen, A Course in Computational Algebraic Number Theory, Alg. 2.6.7].
+
+       On return, d[0] = 1 and d[i+1] is the determinant of the Gram matrix of the
+       first i+1 rows. Thus, d[i+1]/d[i] is the squared norm of the i-th Gram-Schmidt vector.
+
+       Return false if the rows of A are linearly dependent.
+
+       \pre d is a vector of size A.m + 1
+    */
+    bool lll(mpz_matrix & A, mpz * d);
+
     // method for debugging purposes
     void display(std::ostream & out, mpz_matrix const & A, unsigned cell_width=4) const;
 };
@@ -40,25 +40,29 @@ namespace polynomial {
     factor_params::factor_params():
         m_max_p(UINT_MAX),
         m_p_trials(1),
-        m_max_search_size(UINT_MAX) {
+        m_max_search_size(UINT_MAX),
+        m_lattice_min_factors(8) {
     }
 
-    factor_params::factor_params(unsigned max_p, unsigned p_trials, unsigned max_search_size):
+    factor_params::factor_params(unsigned max_p, unsigned p_trials, unsigned max_search_size, unsigned lattice_min_factors):
         m_max_p(max_p),
         m_p_trials(p_trials),
-        m_max_search_size(max_search_size) {
+        m_max_search_size(max_search_size),
+        m_lattice_min_factors(lattice_min_factors) {
     }
     
     void factor_params::updt_params(params_ref const & p) {
         m_max_p    = p.get_uint("max_prime", UINT_MAX);
         m_p_trials = p.get_uint("num_primes", 1);
         m_max_search_size = p.get_uint("max_search_size", UINT_MAX);
+        m_lattice_min_factors = p.get_uint("lattice_min_factors", 8);
     }
     
     void factor_params::get_param_descrs(param_descrs & r) {
         r.insert("max_search_size", CPK_UINT, "(default: infty) Z3 polynomial factorization is composed of three steps: factorization in GF(p), lifting and search. This parameter can be used to limit the search space."); 
         r.insert("max_prime", CPK_UINT, "(default: infty) Z3 polynomial factorization is composed of three steps: factorization in GF(p), lifting and search. This parameter limits the maximum prime number p to be used in the first step.");
         r.insert("num_primes", CPK_UINT, "(default: 1) Z3 polynomial factorization is composed of three steps: factorization in GF(p), lifting and search. The search space may be reduced by factoring the polynomial in different GF(p)'s. This parameter specify the maximum number of finite factorizations to be considered, before lifiting and searching.");
+        r.insert("lattice_min_factors", CPK_UINT, "(default: 8) when the lifted factorization has at least this many factors, the search step is replaced by a lattice reduction (van Hoeij) that recombines the factors. Set to 0 to disable it.");
     }
 
     typedef ptr_vector<monomial> monomial_vector;
@@ -1848,6 +1852,7 @@ namespace polynomial {
         unsigned_vector          m_degree2pos;
         bool                     m_use_sparse_gcd;
         bool                     m_use_prs_gcd;
+        bool                     m_use_modular_psc;
 
         // Debugging method: check if the coefficients of p are in the numeral_manager.
         bool consistent_coeffs(polynomial const * p) {
@@ -2323,6 +2328,7 @@ namespace polynomial {
             inc_ref(m_unit_poly);
             m_use_sparse_gcd = true;
             m_use_prs_gcd = false;
+            m_use_modular_psc = false;
         }
 
         imp(reslimit& lim, manager & w, unsynch_mpz_manager & m, monomial_manager * mm):
@@ -5384,6 +5390,10 @@ namespace polynomial {
                 return;
             }
             
+            if (m_use_modular_psc && !m().modular() && degree(A, x) > 0 && degree(B, x) > 0 &&
+                modular_resultant(A, B, x, result))
+                return;
+            
             // decompose A and B into
             //   A = iA*cA*ppA
             //   B = iB*cB*ppB
@@ -5405,7 +5415,22 @@ namespace polynomial {
             // 
             TRACE("resultant", tout << "resultant(A, B, x) after normalization\nA: " << A << "\nB: " << B << "\nx: " << x << "\n";
                   tout << "t: " << t << "\n";);
+            resultant_core(A, B, x, result);
+            result = mul(t, result);
+        }
+
+        /**
+           \brief Store in result the resultant of p and q with respect to x using the
+           subresultant PRS. It does not extract the content of p and q, and is also used
+           to compute the resultant in Z_p[X1, ..., Xn].
 
+           \pre p and q contain x
+        */
+        void resultant_core(polynomial const * p, polynomial const * q, var x, polynomial_ref & result) {
+            polynomial_ref A(pm());
+            polynomial_ref B(pm());
+            A = const_cast<polynomial*>(p);
+            B = const_cast<polynomial*>(q);
             int s = 1;
             unsigned degA = degree(A, x);
             unsigned degB = degree(B, x);
@@ -5459,8 +5484,8 @@ namespace polynomial {
                             new_h = exact_div(new_h, h);
                     }
                     h = new_h;
-                    // result <- s*t*h
-                    result = mul(t, h);
+                    // result <- s*h
+                    result = h;
                     if (s < 0)
                         result = neg(result);
                     return;
@@ -5468,6 +5493,146 @@ namespace polynomial {
             }
         }
 
+        /**
+           \brief Store in r the 1-norm of p, i.e., the sum of the absolute values of its coefficients.
+        */
+        void norm1(polynomial const * p, numeral & r) {
+            scoped_numeral a(m_manager);
+            m_manager.reset(r);
+            unsigned sz = p->size();
+            for (unsigned i = 0; i < sz; i++) {
+                m_manager.set(a, p->a(i));
+                m_manager.abs(a);
+                m_manager.add(r, a, r);
+            }
+        }
+
+        /**
+           \brief Store in r a bound on the absolute value of the coefficients of the
+           principal subresultant coefficients (and the resultant) of p and q with respect to x.
+
+           psc_j(p, q) is the determinant of a submatrix of the Sylvester matrix of p and q.
+           By expanding the determinant, we have that ||psc_j||_1 <= ||p||_1^deg(q) * ||q||_1^deg(p).
+        */
+        void psc_coeff_bound(polynomial const * p, polynomial const * q, var x, numeral & r) {
+            scoped_numeral n_p(m_manager), n_q(m_manager);
+            norm1(p, n_p);
+            norm1(q, n_q);
+            m_manager.power(n_p, degree(q, x), n_p);
+            m_manager.power(n_q, degree(p, x), n_q);
+            m_manager.mul(n_p, n_q, r);
+        }
+
+        /**
+           \brief Multi-modular computation of the principal subresultant coefficients of p and q
+           with respect to x (or only the resultant when res_only is true).
+           
+           The psc's are computed in Z_p for the primes in g_big_primes, and the images are
+           combined using the Chinese remainder theorem. The method stops as soon as the product 
+           of the primes is big enough for reconstructing coefficients bounded by psc_coeff_bound.
+           Primes where the leading coefficient of p or q vanishes are skipped.
+
+           Return false if there are not enough primes for reconstructing the result. 
+           
+           If res_only is false, then S contains the result of psc_chain. 
+           Otherwise, S contains only the resultant.
+
+           \pre deg(p, x) >= deg(q, x) > 0
+        */
+        bool modular_psc(polynomial const * p, polynomial const * q, var x, bool res_only, polynomial_ref_vector & S) {
+            SASSERT(!m().modular());
+            unsigned deg_p = degree(p, x);
+            unsigned deg_q = degree(q, x);
+            SASSERT(deg_p >= deg_q && deg_q > 0);
+            scoped_numeral max_bound(m());
+            psc_coeff_bound(p, q, x, max_bound);
+            m().mul2k(max_bound, 1);
+            // all primes in g_big_primes are > 2^15
+            if (m().log2(max_bound) >= NUM_BIG_PRIMES * 15) {
+                TRACE("mpsc", tout << "not enough primes for bound: " << max_bound << "\n";);
+                return false;
+            }
+            TRACE("mpsc", tout << "p: "; p->display(tout, m_manager); tout << "\nq: "; q->display(tout, m_manager); 
+                  tout << "\nbound: " << max_bound << "\n";);
+            unsigned num_images = res_only ? 1 : deg_q;
+            polynomial_ref_vector C_star(pm()), images(pm());
+            polynomial_ref p_Zp(pm()), q_Zp(pm());
+            polynomial_ref_vector S_Zp(pm());
+            unsigned_vector idxs;
+            scoped_numeral bound(m()), b(m()), prime(m());
+            bool first = true;
+            for (unsigned i = 0; i < NUM_BIG_PRIMES; i++) {
+                checkpoint();
+                m().set(prime, g_big_primes[i]);
+                images.reset();
+                {
+                    scoped_set_zp setZp(m_wrapper, prime);
+                    p_Zp = normalize(p);
+                    q_Zp = normalize(q);
+                    if (degree(p_Zp, x) < deg_p || degree(q_Zp, x) < deg_q) {
+                        TRACE("mpsc", tout << "bad prime: " << prime << "\n";);
+                        continue;
+                    }
+                    if (res_only) {
+                        polynomial_ref r(pm());
+                        resultant_core(p_Zp, q_Zp, x, r);
+                        images.push_back(r);
+                    }
+                    else {
+                        S_Zp.reset();
+                        idxs.reset();
+                        psc_chain_optimized_core(p_Zp, q_Zp, x, S_Zp, &idxs);
+                        for (unsigned j = 0; j < num_images; j++)
+                            images.push_back(mk_zero());
+                        for (unsigned j = 0; j < S_Zp.size(); j++)
+                            images.set(idxs[j], S_Zp.get(j));
+                    }
+                }
+                if (first) {
+                    C_star.append(images);
+                    m().set(bound, prime);
+                    first = false;
+                }
+                else {
+                    polynomial_ref r(pm());
+                    for (unsigned j = 0; j < num_images; j++) {
+                        m().set(b, bound);
+                        CRA_combine_images(images.get(j), prime, C_star.get(j), b, r);
+                        C_star.set(j, r);
+                    }
+                    m().set(bound, b);
+                }
+                if (m().gt(bound, max_bound)) {
+                    S.reset();
+                    for (unsigned j = 0; j < num_images; j++) {
+                        if (res_only || !is_zero(C_star.get(j)))
+                            S.push_back(C_star.get(j));
+                    }
+                    if (S.empty())
+                        S.push_back(mk_zero());
+                    TRACE("mpsc", tout << "num primes: " << i + 1 << "\n"; for (unsigned j = 0; j < S.size(); j++) tout << S.get(j) << "\n";);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool modular_resultant(polynomial const * p, polynomial const * q, var x, polynomial_ref & result) {
+            polynomial_ref_vector S(pm());
+            int s = 1;
+            if (degree(p, x) < degree(q, x)) {
+                std::swap(p, q);
+                if (degree(p, x) % 2 == 1 && degree(q, x) % 2 == 1)
+                    s = -1;
+            }
+            if (!modular_psc(p, q, x, true, S))
+                return false;
+            result = S.get(0);
+            if (s < 0)
+                result = neg(result);
+            return true;
+        }
+
         /**
            \brief Return the discriminant of p with respect to x.
 
@@ -5752,7 +5917,7 @@ namespace polynomial {
                 S_e_1 = neg(S_e_1);
         } 
 
-        void psc_chain_optimized_core(polynomial const * P, polynomial const * Q, var x, polynomial_ref_vector & S) {
+        void psc_chain_optimized_core(polynomial const * P, polynomial const * Q, var x, polynomial_ref_vector & S, unsigned_vector * idxs = 0) {
             TRACE("psc_chain_classic", tout << "P: "; P->display(tout, m_manager); tout << "\nQ: "; Q->display(tout, m_manager); tout << "\n";);
             unsigned degP = degree(P, x);
             unsigned degQ = degree(Q, x);
@@ -5776,8 +5941,10 @@ namespace polynomial {
                 TRACE("psc_chain_classic", tout << "A: " << A << "\nB: " << B << "\ns: " << s << "\nd: " << d << ", e: " << e << "\n";);
                 // B is S_{d-1}
                 ps = coeff(B, x, d-1);
-                if (!is_zero(ps))
+                if (!is_zero(ps)) {
                     S.push_back(ps);
+                    if (idxs) idxs->push_back(d-1);
+                }
                 unsigned delta = d - e;
                 if (delta > 1) {
                     // C <- S_e
@@ -5787,8 +5954,10 @@ namespace polynomial {
 
                     // C is S_e
                     ps = coeff(C, x, e);
-                    if (!is_zero(ps))
+                    if (!is_zero(ps)) {
                         S.push_back(ps);
+                        if (idxs) idxs->push_back(e);
+                    }
                 }
                 else {
                     SASSERT(delta == 0 || delta == 1);
@@ -5902,6 +6071,10 @@ namespace polynomial {
             // psc_chain1(A, B, x, S);
             // psc_chain2(A, B, x, S);
             // psc_chain_classic(A, B, x, S);
+            if (m_use_modular_psc && !m().modular()) {
+                if (degree(A, x) >= degree(B, x) ? modular_psc(A, B, x, false, S) : modular_psc(B, A, x, false, S))
+                    return;
+            }
             psc_chain_optimized(A, B, x, S);
         }
 
@@ -6919,6 +7092,10 @@ namespace polynomial {
         return m_imp->m().set_zp(p);
     }
 
+    void manager::set_use_modular_psc(bool f) {
+        m_imp->m_use_modular_psc = f;
+    }
+
     small_object_allocator & manager::allocator() const {
         return m_imp->mm().allocator();
     }
@@ -88,8 +88,9 @@ namespace polynomial {
         unsigned m_max_p;              //!< factor in GF_p using primes p <= m_max_p (default UINT_MAX)
         unsigned m_p_trials;           //!< Number of different finite factorizations: G_p1 ... G_pk, where k < m_p_trials
         unsigned m_max_search_size;    //!< Threshold on the search space. 
+        unsigned m_lattice_min_factors; //!< Use lattice reduction to recombine the lifted factors when there are at least this many (0 to disable).
         factor_params();
-        factor_params(unsigned max_p, unsigned p_trials, unsigned max_search_size);
+        factor_params(unsigned max_p, unsigned p_trials, unsigned max_search_size, unsigned lattice_min_factors = 8);
         void updt_params(params_ref const & p);
         /*
           REG_MODULE_PARAMS('factor', polynomial::factor_params::get_param_descrs')
@@ -219,6 +220,12 @@ namespace polynomial {
         void set_zp(numeral const & p);
         void set_zp(uint64 p);
 
+        /**
+           \brief When f is true, resultants and principal subresultant coefficients 
+           are computed using a multi-modular algorithm.
+        */
+        void set_use_modular_psc(bool f);
+
         /**
            \brief Abstract event handler.
         */
@@ -33,21 +33,38 @@ namespace polynomial {
         bool operator()(polynomial const * p1, polynomial const * p2) const { return m.eq(p1, p2); }
     };
 
-    struct psc_chain_entry {
-        polynomial const * m_p;
-        polynomial const * m_q;
-        var                m_x;
+    /**
+       \brief Entries of the psc_chain and factor caches. 
+       They are also stored in a doubly linked list sorted by last use (most recently used first).
+    */
+    struct cache_entry {
+        cache_entry *      m_prev;
+        cache_entry *      m_next;
         unsigned           m_hash;
         unsigned           m_result_sz;
         polynomial **      m_result;
+        bool               m_psc;
+
+        cache_entry(unsigned h, bool psc):
+            m_prev(0),
+            m_next(0),
+            m_hash(h),
+            m_result_sz(0),
+            m_result(0),
+            m_psc(psc) {
+        }
+    };
+
+    struct psc_chain_entry : public cache_entry {
+        polynomial const * m_p;
+        polynomial const * m_q;
+        var                m_x;
         
         psc_chain_entry(polynomial const * p, polynomial const * q, var x, unsigned h):
+            cache_entry(h, true),
             m_p(p),
             m_q(q),
-            m_x(x),
-            m_hash(h),
-            m_result_sz(0),
-            m_result(0) {
+            m_x(x) {
         }
         
         struct hash_proc { unsigned operator()(psc_chain_entry const * entry) const { return entry->m_hash; } };
@@ -59,17 +76,12 @@ namespace polynomial {
         };
     };
 
-    struct factor_entry {
+    struct factor_entry : public cache_entry {
         polynomial const * m_p;
-        unsigned           m_hash;
-        unsigned           m_result_sz;
-        polynomial **      m_result;
         
         factor_entry(polynomial const * p, unsigned h):
-            m_p(p),
-            m_hash(h),
-            m_result_sz(0),
-            m_result(0) {
+            cache_entry(h, false),
+            m_p(p) {
         }
         
         struct hash_proc { unsigned operator()(factor_entry const * entry) const { return entry->m_hash; } };
@@ -86,6 +98,16 @@ namespace polynomial {
     typedef chashtable<factor_entry*, factor_entry::hash_proc, factor_entry::eq_proc> factor_cache;
     
     struct cache::imp { 
+        struct stats {
+            unsigned m_psc_chain_hits;
+            unsigned m_psc_chain_misses;
+            unsigned m_factor_hits;
+            unsigned m_factor_misses;
+            unsigned m_evictions;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
         manager &                m;
         polynomial_table         m_poly_table;
         psc_chain_cache          m_psc_chain_cache;
@@ -93,8 +115,22 @@ namespace polynomial {
         polynomial_ref_vector    m_cached_polys;
         svector<char>            m_in_cache;
         small_object_allocator & m_allocator;
+        // LRU list of psc_chain and factor entries
+        cache_entry *            m_lru_head;
+        cache_entry *            m_lru_tail;
+        unsigned                 m_num_entries;
+        unsigned                 m_max_entries; // 0 means unbounded
+        stats                    m_stats;
 
-        imp(manager & _m):m(_m), m_poly_table(poly_hash_proc(m), poly_eq_proc(m)), m_cached_polys(m), m_allocator(m.allocator()) {
+        imp(manager & _m, unsigned max_entries):
+            m(_m), 
+            m_poly_table(poly_hash_proc(m), poly_eq_proc(m)), 
+            m_cached_polys(m), 
+            m_allocator(m.allocator()),
+            m_lru_head(0),
+            m_lru_tail(0),
+            m_num_entries(0),
+            m_max_entries(max_entries) {
         }
         
         ~imp() {
@@ -102,24 +138,88 @@ namespace polynomial {
             reset_factor_cache();
         }
 
+        void lru_del(cache_entry * e) {
+            if (e->m_prev) e->m_prev->m_next = e->m_next; else m_lru_head = e->m_next;
+            if (e->m_next) e->m_next->m_prev = e->m_prev; else m_lru_tail = e->m_prev;
+            e->m_prev = 0;
+            e->m_next = 0;
+            m_num_entries--;
+        }
+
+        void lru_push_front(cache_entry * e) {
+            SASSERT(e->m_prev == 0 && e->m_next == 0);
+            e->m_next = m_lru_head;
+            if (m_lru_head) m_lru_head->m_prev = e; else m_lru_tail = e;
+            m_lru_head = e;
+            m_num_entries++;
+        }
+
+        void touch(cache_entry * e) {
+            if (m_lru_head == e)
+                return;
+            lru_del(e);
+            lru_push_front(e);
+        }
+
+        /**
+           \brief The result polynomials of an entry are kept alive by the entry itself.
+        */
+        void set_result(cache_entry * e, unsigned sz, polynomial * const * rs) {
+            e->m_result_sz = sz;
+            e->m_result    = sz == 0 ? 0 : static_cast<polynomial**>(m_allocator.allocate(sizeof(polynomial*)*sz));
+            for (unsigned i = 0; i < sz; i++) {
+                e->m_result[i] = rs[i];
+                m.inc_ref(rs[i]);
+            }
+        }
+
+        void del_result(cache_entry * e) {
+            for (unsigned i = 0; i < e->m_result_sz; i++)
+                m.dec_ref(e->m_result[i]);
+            if (e->m_result_sz != 0)
+                m_allocator.deallocate(sizeof(polynomial*)*e->m_result_sz, e->m_result);
+        }
+
         void del_psc_chain_entry(psc_chain_entry * entry) {
-            if (entry->m_result_sz != 0)
-                m_allocator.deallocate(sizeof(polynomial*)*entry->m_result_sz, entry->m_result);
+            del_result(entry);
             entry->~psc_chain_entry();
             m_allocator.deallocate(sizeof(psc_chain_entry), entry);
         }
 
         void del_factor_entry(factor_entry * entry) {
-            if (entry->m_result_sz != 0)
-                m_allocator.deallocate(sizeof(polynomial*)*entry->m_result_sz, entry->m_result);
+            del_result(entry);
             entry->~factor_entry();
             m_allocator.deallocate(sizeof(factor_entry), entry);
         }
 
+        /**
+           \brief Evict least recently used entries until there is room for a new entry.
+        */
+        void make_room() {
+            if (m_max_entries == 0)
+                return;
+            while (m_num_entries >= m_max_entries && m_lru_tail != 0) {
+                cache_entry * e = m_lru_tail;
+                lru_del(e);
+                m_stats.m_evictions++;
+                if (e->m_psc) {
+                    psc_chain_entry * pe = static_cast<psc_chain_entry*>(e);
+                    m_psc_chain_cache.erase(pe);
+                    del_psc_chain_entry(pe);
+                }
+                else {
+                    factor_entry * fe = static_cast<factor_entry*>(e);
+                    m_factor_cache.erase(fe);
+                    del_factor_entry(fe);
+                }
+            }
+        }
+
         void reset_psc_chain_cache() {
             psc_chain_cache::iterator it  = m_psc_chain_cache.begin();
             psc_chain_cache::iterator end = m_psc_chain_cache.end();
             for (; it != end; ++it) {
+                lru_del(*it);
                 del_psc_chain_entry(*it);
             }
             m_psc_chain_cache.reset();
@@ -129,6 +229,7 @@ namespace polynomial {
             factor_cache::iterator it  = m_factor_cache.begin();
             factor_cache::iterator end = m_factor_cache.end();
             for (; it != end; ++it) {
+                lru_del(*it);
                 del_factor_entry(*it);
             }
             m_factor_cache.reset();
@@ -151,26 +252,24 @@ namespace polynomial {
             p = mk_unique(p);
             q = mk_unique(q);
             unsigned h = hash_u_u(pid(p), pid(q));
-            psc_chain_entry * entry = new (m_allocator.allocate(sizeof(psc_chain_entry))) psc_chain_entry(p, q, x, h);
-            psc_chain_entry * old_entry = m_psc_chain_cache.insert_if_not_there(entry); 
-            if (entry != old_entry) {
-                entry->~psc_chain_entry();
-                m_allocator.deallocate(sizeof(psc_chain_entry), entry);
+            psc_chain_entry key(p, q, x, h);
+            psc_chain_entry * old_entry = 0;
+            if (m_psc_chain_cache.find(&key, old_entry)) {
+                m_stats.m_psc_chain_hits++;
+                touch(old_entry);
                 S.reset();
                 for (unsigned i = 0; i < old_entry->m_result_sz; i++) {
                     S.push_back(old_entry->m_result[i]);
                 }
             }
             else {
+                m_stats.m_psc_chain_misses++;
                 m.psc_chain(p, q, x, S);
-                unsigned sz = S.size();
-                entry->m_result_sz = sz;
-                entry->m_result    = static_cast<polynomial**>(m_allocator.allocate(sizeof(polynomial*)*sz));
-                for (unsigned i = 0; i < sz; i++) {
-                    polynomial * h = mk_unique(S.get(i));
-                    S.set(i, h);
-                    entry->m_result[i] = h;
-                }
+                make_room();
+                psc_chain_entry * entry = new (m_allocator.allocate(sizeof(psc_chain_entry))) psc_chain_entry(p, q, x, h);
+                set_result(entry, S.size(), S.c_ptr());
+                m_psc_chain_cache.insert(entry);
+                lru_push_front(entry);
             }
         }
 
@@ -178,33 +277,46 @@ namespace polynomial {
             distinct_factors.reset();
             p = mk_unique(p);
             unsigned h = hash_u(pid(p));
-            factor_entry * entry = new (m_allocator.allocate(sizeof(factor_entry))) factor_entry(p, h);
-            factor_entry * old_entry = m_factor_cache.insert_if_not_there(entry); 
-            if (entry != old_entry) {
-                entry->~factor_entry();
-                m_allocator.deallocate(sizeof(factor_entry), entry);
-                distinct_factors.reset();
+            factor_entry key(p, h);
+            factor_entry * old_entry = 0;
+            if (m_factor_cache.find(&key, old_entry)) {
+                m_stats.m_factor_hits++;
+                touch(old_entry);
                 for (unsigned i = 0; i < old_entry->m_result_sz; i++) {
                     distinct_factors.push_back(old_entry->m_result[i]);
                 }
             }
             else {
+                m_stats.m_factor_misses++;
                 factors fs(m);
                 m.factor(p, fs);
                 unsigned sz = fs.distinct_factors();
-                entry->m_result_sz = sz;
-                entry->m_result    = static_cast<polynomial**>(m_allocator.allocate(sizeof(polynomial*)*sz));
                 for (unsigned i = 0; i < sz; i++) {
-                    polynomial * h = mk_unique(fs[i]);
-                    distinct_factors.push_back(h);
-                    entry->m_result[i] = h;
+                    distinct_factors.push_back(mk_unique(fs[i]));
                 }
+                make_room();
+                factor_entry * entry = new (m_allocator.allocate(sizeof(factor_entry))) factor_entry(p, h);
+                set_result(entry, sz, distinct_factors.c_ptr());
+                m_factor_cache.insert(entry);
+                lru_push_front(entry);
             }
         }
+
+        void collect_statistics(statistics & st) const {
+            st.update("poly cache psc hits", m_stats.m_psc_chain_hits);
+            st.update("poly cache psc misses", m_stats.m_psc_chain_misses);
+            st.update("poly cache factor hits", m_stats.m_factor_hits);
+            st.update("poly cache factor misses", m_stats.m_factor_misses);
+            st.update("poly cache evictions", m_stats.m_evictions);
+            unsigned lookups = m_stats.m_psc_chain_hits + m_stats.m_psc_chain_misses + m_stats.m_factor_hits + m_stats.m_factor_misses;
+            if (lookups > 0)
+                st.update("poly cache hit rate", 
+                          static_cast<double>(m_stats.m_psc_chain_hits + m_stats.m_factor_hits) / static_cast<double>(lookups));
+        }
     };
 
-    cache::cache(manager & m) {
-        m_imp = alloc(imp, m);
+    cache::cache(manager & m, unsigned max_entries) {
+        m_imp = alloc(imp, m, max_entries);
     }
 
     cache::~cache() {
@@ -229,7 +341,27 @@ namespace polynomial {
     
     void cache::reset() {
         manager & _m = m();
+        unsigned max_entries = m_imp->m_max_entries;
+        imp::stats st = m_imp->m_stats;
         dealloc(m_imp);
-        m_imp = alloc(imp, _m);
+        m_imp = alloc(imp, _m, max_entries);
+        m_imp->m_stats = st;
+    }
+
+    void cache::set_max_entries(unsigned max_entries) {
+        m_imp->m_max_entries = max_entries;
+        m_imp->make_room();
+    }
+
+    unsigned cache::num_entries() const {
+        return m_imp->m_num_entries;
+    }
+
+    void cache::collect_statistics(statistics & st) const {
+        m_imp->collect_statistics(st);
+    }
+
+    void cache::reset_statistics() {
+        m_imp->m_stats.reset();
     }
 };
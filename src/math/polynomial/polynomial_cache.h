@@ -20,17 +20,21 @@ Notes:
 #define POLYNOMIAL_CACHE_H_
 
 #include"polynomial.h"
+#include"statistics.h"
 
 namespace polynomial {
 
     /**
-       \brief Functor for creating unique polynomials and caching results of operations
+       \brief Functor for creating unique polynomials and caching results of operations.
+
+       The results of psc_chain and factor are kept in a cache bounded by max_entries
+       (0 means unbounded), and the least recently used entries are evicted first.
     */
     class cache {
         struct imp;
         imp * m_imp;
     public:
-        cache(manager & m);
+        cache(manager & m, unsigned max_entries = 0);
         ~cache();
         manager & m() const;
         manager & pm() const { return m(); }
@@ -38,6 +42,10 @@ namespace polynomial {
         void psc_chain(polynomial const * p, polynomial const * q, var x, polynomial_ref_vector & S);
         void factor(polynomial const * p, polynomial_ref_vector & distinct_factors);
         void reset();
+        void set_max_entries(unsigned max_entries);
+        unsigned num_entries() const;
+        void collect_statistics(statistics & st) const;
+        void reset_statistics();
     };
 };
 
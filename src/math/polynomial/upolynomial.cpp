@@ -26,6 +26,8 @@ Notes:
 #include"polynomial_primes.h"
 #include"buffer.h"
 #include"cooperate.h"
+#include"z3_omp.h"
+#include"scoped_ptr_vector.h"
 
 namespace upolynomial {
 
@@ -2352,6 +2354,257 @@ namespace upolynomial {
         drs_isolate_roots(p1.size(), p1.c_ptr(), neg_k, pos_k, bqm, roots, lowers, uppers);
     }
 
+    // Frames for implementing vca_isolate_0_1_roots.
+    // The polynomial associated with a frame is 2^{k*n} * p((x + c)/2^k) where p is the input polynomial, 
+    // and its roots in (0, 1) are the roots of p in (c/2^k, (c+1)/2^k).
+    // The coefficients are stored in a separate stack, the numerators c in another one.
+    struct manager::vca_frame {
+        unsigned    m_size;   // size of the polynomial associated with this frame
+        unsigned    m_k;      // the frame represents an interval of width 1/2^k
+        vca_frame(unsigned sz, unsigned k):m_size(sz), m_k(k) {}
+    };
+
+    // Isolate the roots of p in the interval (0, 1), where p is the polynomial associated with the interval (c/2^k, (c+1)/2^k).
+    // The result is given with respect to the coordinates of the interval (0, 1) at depth 0.
+    void manager::vca_isolate_0_1_roots(unsigned sz, numeral const * p, numeral const & c, unsigned k, 
+                                        mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers) {
+        TRACE("upolynomial", tout << "vca isolating (0,1) roots of:\n"; display(tout, sz, p); tout << "\nc: " << m().to_string(c) << ", k: " << k << "\n";);
+        scoped_numeral_vector p_stack(m());
+        scoped_numeral_vector c_stack(m());
+        svector<vca_frame>    frame_stack;
+        scoped_numeral_vector q(m());
+        scoped_numeral_vector r(m());
+        scoped_numeral        curr_c(m());
+        for (unsigned i = 0; i < sz; i++) {
+            p_stack.push_back(numeral());
+            m().set(p_stack.back(), p[i]);
+        }
+        c_stack.push_back(numeral());
+        m().set(c_stack.back(), c);
+        frame_stack.push_back(vca_frame(sz, k));
+        while (!frame_stack.empty()) {
+            checkpoint();
+            // move the top frame to (q, curr_c, k)
+            vca_frame fr = frame_stack.back();
+            frame_stack.pop_back();
+            k = fr.m_k;
+            q.reset();
+            for (unsigned i = p_stack.size() - fr.m_size; i < p_stack.size(); i++) {
+                q.push_back(numeral());
+                swap(q.back(), p_stack[i]);
+            }
+            for (unsigned i = 0; i < fr.m_size; i++) {
+                m().del(p_stack.back());
+                p_stack.pop_back();
+            }
+            swap(curr_c, c_stack.back());
+            m().del(c_stack.back());
+            c_stack.pop_back();
+            
+            if (m().is_zero(q[0])) {
+                // the left end-point c/2^k is a root
+                TRACE("upolynomial", tout << "found root " << m().to_string(curr_c) << "/2^" << k << "\n";);
+                roots.push_back(mpbq());
+                bqm.set(roots.back(), curr_c, k);
+                // p is square free, then q/x does not have zero roots
+                for (unsigned i = 0; i + 1 < q.size(); i++)
+                    swap(q[i], q[i+1]);
+                m().del(q.back());
+                q.pop_back();
+            }
+            if (q.size() <= 1)
+                continue;
+            // cheap test: no sign variation implies there are no positive roots
+            if (sign_changes(q.size(), q.c_ptr()) == 0)
+                continue;
+            unsigned num_vars = descartes_bound_0_1(q.size(), q.c_ptr());
+            if (num_vars == 0)
+                continue;
+            if (num_vars == 1) {
+                TRACE("upolynomial", tout << "isolating interval (" << m().to_string(curr_c) << ", " << m().to_string(curr_c) << "+1)/2^" << k << "\n";);
+                lowers.push_back(mpbq());
+                uppers.push_back(mpbq());
+                bqm.set(lowers.back(), curr_c, k);
+                m().inc(curr_c);
+                bqm.set(uppers.back(), curr_c, k);
+                continue;
+            }
+            // bisect: left child 2^n * q(x/2), right child is the left one translated by 1.
+            compose_2n_p_x_div_2(q.size(), q.c_ptr());
+            normalize(q);
+            set(q.size(), q.c_ptr(), r);
+            translate(r.size(), r.c_ptr());
+            normalize(r);
+            m().mul2k(curr_c, 1);
+            // the right child is pushed first, the left one is processed first
+            for (unsigned i = 0; i < r.size(); i++) {
+                p_stack.push_back(numeral());
+                swap(p_stack.back(), r[i]);
+            }
+            c_stack.push_back(numeral());
+            m().add(curr_c, numeral(1), c_stack.back());
+            frame_stack.push_back(vca_frame(r.size(), k + 1));
+            for (unsigned i = 0; i < q.size(); i++) {
+                p_stack.push_back(numeral());
+                swap(p_stack.back(), q[i]);
+            }
+            c_stack.push_back(numeral());
+            swap(c_stack.back(), curr_c);
+            frame_stack.push_back(vca_frame(q.size(), k + 1));
+        }
+    }
+
+    // Isolate roots in an interval (-2^neg_k, 2^pos_k) using the Vincent-Collins-Akritas method.
+    void manager::vca_isolate_roots(unsigned sz, numeral * p, unsigned neg_k, unsigned pos_k,
+                                    mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers) {
+        scoped_numeral_vector aux_p(m());
+        scoped_numeral zero(m());
+        set(sz, p, aux_p);
+        pos_k = std::max(neg_k, pos_k);
+        compose_p_2k_x(sz, aux_p.c_ptr(), pos_k);
+        unsigned old_roots_sz  = roots.size();
+        unsigned old_lowers_sz = lowers.size();
+        vca_isolate_0_1_roots(sz, aux_p.c_ptr(), zero, 0, bqm, roots, lowers, uppers);
+        adjust_pos(bqm, roots,  old_roots_sz,  pos_k);
+        adjust_pos(bqm, lowers, old_lowers_sz, pos_k);
+        adjust_pos(bqm, uppers, old_lowers_sz, pos_k);
+
+        p_minus_x(sz, p);
+        compose_p_2k_x(sz, p, neg_k);
+        old_roots_sz  = roots.size();
+        old_lowers_sz = lowers.size();
+        vca_isolate_0_1_roots(sz, p, zero, 0, bqm, roots, lowers, uppers);
+        adjust_neg(bqm, roots,  old_roots_sz,  neg_k);
+        adjust_neg(bqm, lowers, old_lowers_sz, neg_k);
+        adjust_neg(bqm, uppers, old_lowers_sz, neg_k);
+        swap_lowers_uppers(old_lowers_sz, lowers, uppers);
+    }
+
+    void manager::vca_isolate_roots(unsigned sz, numeral const * p, mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers) {
+        SASSERT(lowers.size() == uppers.size());
+        SASSERT(!has_zero_roots(sz, p));
+        scoped_numeral_vector p1(m());
+        set(sz, p, p1);
+        normalize(p1);
+        unsigned pos_k = knuth_positive_root_upper_bound(sz, p);
+        unsigned neg_k = knuth_negative_root_upper_bound(sz, p);
+        vca_isolate_roots(p1.size(), p1.c_ptr(), neg_k, pos_k, bqm, roots, lowers, uppers);
+    }
+
+    // Slice (c/2^k, (c+1)/2^k) of the positive or negative half of the root bound interval.
+    // Tasks own their managers, so that they can be processed in parallel.
+    struct manager::par_isolation_task {
+        unsynch_mpq_manager   m_qm;
+        reslimit              m_limit;
+        manager               m_upm;
+        mpbq_manager          m_bqm;
+        scoped_numeral_vector m_p;
+        scoped_mpbq_vector    m_roots;
+        scoped_mpbq_vector    m_lowers;
+        scoped_mpbq_vector    m_uppers;
+        unsigned              m_c;
+        bool                  m_neg;
+        par_isolation_task(unsigned c, bool neg):
+            m_upm(m_limit, m_qm),
+            m_bqm(m_qm),
+            m_p(m_upm.m()),
+            m_roots(m_bqm),
+            m_lowers(m_bqm),
+            m_uppers(m_bqm),
+            m_c(c),
+            m_neg(neg) {
+        }
+
+        void operator()(unsigned k) {
+            // m_p := 2^{k*n} * m_p((x + c)/2^k)
+            scoped_numeral c(m_upm.m());
+            m_upm.m().set(c, m_c);
+            m_upm.compose_2kn_p_x_div_2k(m_p.size(), m_p.c_ptr(), k);
+            m_upm.translate_z(m_p.size(), m_p.c_ptr(), c);
+            m_upm.normalize(m_p);
+            m_upm.vca_isolate_0_1_roots(m_p.size(), m_p.c_ptr(), c, k, m_bqm, m_roots, m_lowers, m_uppers);
+        }
+    };
+
+    static void copy_scaled(mpbq_manager & bqm, mpbq_vector const & src, mpbq_vector & dst, unsigned k, bool neg) {
+        for (unsigned i = 0; i < src.size(); i++) {
+            dst.push_back(mpbq());
+            bqm.set(dst.back(), src[i]);
+            bqm.mul2k(dst.back(), k);
+            if (neg)
+                bqm.neg(dst.back());
+        }
+    }
+
+    void manager::par_isolate_roots(unsigned sz, numeral const * p, unsigned num_threads, 
+                                    mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers) {
+        SASSERT(lowers.size() == uppers.size());
+        SASSERT(!has_zero_roots(sz, p));
+#ifdef _NO_OMP_
+        num_threads = 1;
+#else
+        if (omp_in_parallel())
+            num_threads = 1;
+#endif
+        if (num_threads <= 1) {
+            vca_isolate_roots(sz, p, bqm, roots, lowers, uppers);
+            return;
+        }
+        scoped_numeral_vector pos_p(m());
+        scoped_numeral_vector neg_p(m());
+        set(sz, p, pos_p);
+        normalize(pos_p);
+        set(pos_p.size(), pos_p.c_ptr(), neg_p);
+        unsigned pos_k = knuth_positive_root_upper_bound(sz, p);
+        unsigned neg_k = knuth_negative_root_upper_bound(sz, p);
+        pos_k = std::max(neg_k, pos_k);
+        compose_p_2k_x(pos_p.size(), pos_p.c_ptr(), pos_k);
+        p_minus_x(neg_p.size(), neg_p.c_ptr());
+        compose_p_2k_x(neg_p.size(), neg_p.c_ptr(), neg_k);
+
+        // each half is split into 2^k slices, there are at least two tasks per thread.
+        unsigned k = log2(num_threads) + 1;
+        unsigned num_slices = 1u << k;
+        scoped_ptr_vector<par_isolation_task> tasks;
+        for (unsigned i = 0; i < 2 * num_slices; i++) {
+            bool neg = i >= num_slices;
+            par_isolation_task * t = alloc(par_isolation_task, i % num_slices, neg);
+            numeral_vector const & q = neg ? neg_p : pos_p;
+            t->m_upm.set(q.size(), q.c_ptr(), t->m_p);
+            tasks.push_back(t);
+            m_limit.push_child(&(t->m_limit));
+        }
+        TRACE("upolynomial", tout << "parallel root isolation, threads: " << num_threads << ", tasks: " << tasks.size() << "\n";);
+
+        svector<bool> failed;
+        failed.resize(tasks.size(), false);
+        #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+        for (int i = 0; i < static_cast<int>(tasks.size()); i++) {
+            try {
+                (*tasks[i])(k);
+            }
+            catch (z3_exception &) {
+                failed[i] = true;
+            }
+        }
+
+        for (unsigned i = 0; i < tasks.size(); i++) {
+            m_limit.pop_child();
+        }
+        for (unsigned i = 0; i < tasks.size(); i++) {
+            if (failed[i])
+                throw upolynomial_exception("canceled");
+        }
+        for (unsigned i = 0; i < tasks.size(); i++) {
+            par_isolation_task const & t = *tasks[i];
+            unsigned s = t.m_neg ? neg_k : pos_k;
+            copy_scaled(bqm, t.m_roots, roots, s, t.m_neg);
+            // (l, u) is mapped to (-u, -l) in the negative half.
+            copy_scaled(bqm, t.m_neg ? t.m_uppers : t.m_lowers, lowers, s, t.m_neg);
+            copy_scaled(bqm, t.m_neg ? t.m_lowers : t.m_uppers, uppers, s, t.m_neg);
+        }
+    }
+
     // Frame for root isolation in sturm_isolate_roots.
     // It stores (lower, upper, num. sign variations at lower, num. sign variations at upper)
     struct ss_frame {
@@ -564,6 +564,12 @@ namespace upolynomial {
         void drs_isolate_roots(unsigned sz, numeral * p, numeral & U, mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers);
         void drs_isolate_roots(unsigned sz, numeral const * p, mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers);
         void sqf_nz_isolate_roots(unsigned sz, numeral const * p, mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers);
+        struct vca_frame;
+        void vca_isolate_0_1_roots(unsigned sz, numeral const * p, numeral const & c, unsigned k, 
+                                   mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers);
+        void vca_isolate_roots(unsigned sz, numeral * p, unsigned neg_k, unsigned pos_k,
+                               mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers);
+        struct par_isolation_task;
         void sturm_seq_core(upolynomial_sequence & seq);
         enum location { PLUS_INF, MINUS_INF, ZERO, MPBQ };
         template<location loc>
@@ -829,6 +835,31 @@ namespace upolynomial {
 
         void sturm_isolate_roots(unsigned sz, numeral const * p, mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers);
 
+        /**
+           \brief Isolate the roots of a square free polynomial p that does not have zero roots
+           using the Vincent-Collins-Akritas bisection method.
+           
+           Each node of the search is the polynomial 2^{k*n} * p((x + c)/2^k) whose roots in (0, 1) are
+           the roots of p in (c/2^k, (c+1)/2^k). Nodes whose coefficients have no sign variation are
+           discarded before the Taylor shift used by the Descartes test, and roots at the bisection points
+           are detected by a zero constant coefficient.
+
+           \see sqf_isolate_roots for the format of the result.
+        */
+        void vca_isolate_roots(unsigned sz, numeral const * p, mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers);
+
+        /**
+           \brief Parallel version of vca_isolate_roots.
+           The root bound interval is split into slices of equal size that are isolated by up to num_threads
+           workers. Each worker uses its own numeral, upolynomial and mpbq managers, the result is copied
+           into bqm. The isolation is sequential if num_threads <= 1 or the method is invoked from a
+           parallel region.
+
+           \pre p is square free and does not have zero roots.
+        */
+        void par_isolate_roots(unsigned sz, numeral const * p, unsigned num_threads, 
+                               mpbq_manager & bqm, mpbq_vector & roots, mpbq_vector & lowers, mpbq_vector & uppers);
+
         /**
            \brief Compute the sturm sequence for p1 and p2.
         */
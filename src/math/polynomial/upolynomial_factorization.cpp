@@ -20,12 +20,15 @@ Notes:
    [2] Donald Ervin Knuth. The Art of Computer Programming, volume 2: Seminumerical Algorithms. Addison Wesley, third 
        edition, 1997.
    [3] Henri Cohen. A Course in Computational Algebraic Number Theory. Springer Verlag, 1993.
+   [4] Mark van Hoeij. Factoring Polynomials and the Knapsack Problem. Journal of Number Theory, 
+       95(2):167-189, 2002.
 
 --*/
 #include"trace.h"
 #include"util.h"
 #include"upolynomial_factorization_int.h"
 #include"prime_generator.h"
+#include"mpz_matrix.h"
 
 using namespace std;
 
@@ -1010,6 +1013,245 @@ static unsigned mignotte_bound(z_manager & upm, numeral_vector const & f, numera
     return e;
 }
 
+// get a bound 2^b on the coefficients of f*G'/G for the factors G of f, used by the lattice recombination.
+// 
+// if f = G*H, then f*G'/G = H*G', and using the Mignotte bound |G|_1 <= 2^deg(G) |f|_2 for the factors of f
+// we get |H*G'|_oo <= |H|_1 * deg(G) * |G|_1 <= n * 2^n * |f|_2^2, where n = deg(f)
+
+static unsigned log_derivative_bound(z_manager & upm, numeral_vector const & f) {
+    z_numeral_manager & nm = upm.zm();
+    scoped_mpz f_norm(nm);
+    for (unsigned i = 0; i < f.size(); ++ i) {
+        if (!nm.is_zero(f[i])) {
+            nm.addmul(f_norm, f[i], f[i], f_norm);
+        }
+    }
+    unsigned n = upm.degree(f);
+    return n + log2(n) + 1 + nm.log2(f_norm) + 1;
+}
+
+// get the smallest e that is a power of 2 (as in mignotte_bound) such that p^e >= 2^bits
+
+static unsigned lift_exponent(z_numeral_manager & nm, numeral const & p, unsigned bits) {
+    scoped_mpz bound(nm), tmp(nm);
+    nm.set(bound, 1);
+    nm.mul2k(bound, bits);
+    nm.set(tmp, p);
+    unsigned e;
+    for (e = 1; nm.lt(tmp, bound); e *= 2) {
+        nm.mul(tmp, tmp, tmp);
+    }
+    return e;
+}
+
+/**
+   \brief Check the candidate factors obtained by grouping the factors of f modulo p^e. 
+   The factor zpe_fs[i] is in the group group[i]. The group of largest degree is not 
+   checked, the quotient is used instead.
+
+   Return false if some candidate does not divide f. In this case, fs is not modified.
+*/
+static bool lattice_trial_division(z_manager & upm, numeral_vector const & f, zp_factors const & zpe_fs, 
+                                   unsigned_vector const & group, unsigned num_groups, factors & fs, unsigned k) {
+    numeral_manager & nm = upm.m();
+    zp_manager & zpe_upm = zpe_fs.upm();
+    zp_numeral_manager & zpe_nm = zpe_upm.m();
+    
+    unsigned_vector degrees;
+    degrees.resize(num_groups, 0);
+    for (unsigned i = 0; i < group.size(); ++ i) {
+        degrees[group[i]] += zpe_fs.get_degree(i) * (zpe_fs[i].size() - 1);
+    }
+    unsigned largest = 0;
+    for (unsigned g = 1; g < num_groups; ++ g) {
+        if (degrees[g] > degrees[largest]) {
+            largest = g;
+        }
+    }
+
+    factors candidates(upm);
+    scoped_numeral_vector remaining(nm), trial_factor(nm), trial_factor_quo(nm);
+    scoped_numeral lc(nm), trial_factor_cont(nm);
+    upm.set(f.size(), f.c_ptr(), remaining);
+    for (unsigned g = 0; g < num_groups; ++ g) {
+        if (g == largest) {
+            continue;
+        }
+        upm.checkpoint();
+        // trial_factor = lc(remaining) * \prod_{group[i] = g} zpe_fs[i] (mod p^e)
+        zpe_nm.set(lc, remaining.back());
+        trial_factor.reset();
+        trial_factor.push_back(lc);
+        for (unsigned i = 0; i < group.size(); ++ i) {
+            if (group[i] == g) {
+                zpe_upm.mul(trial_factor, zpe_fs[i], trial_factor_quo);
+                trial_factor.swap(trial_factor_quo);
+            }
+        }
+        upm.get_primitive_and_content(trial_factor, trial_factor, trial_factor_cont);
+        if (!upm.exact_div(remaining, trial_factor, trial_factor_quo)) {
+            TRACE("polynomial::factorization::bughunt", 
+                  tout << "lattice candidate is not a factor: "; upm.display(tout, trial_factor); tout << endl;);
+            return false;
+        }
+        remaining.swap(trial_factor_quo);
+        candidates.push_back(trial_factor, 1);
+    }
+    if (remaining.size() > 1) {
+        candidates.push_back(remaining, 1);
+    }
+
+    for (unsigned i = 0; i < candidates.distinct_factors(); ++ i) {
+        fs.push_back(candidates[i], k);
+    }
+    return true;
+}
+
+/**
+   \brief Recombine the factors of f modulo p^e using lattice reduction [4], instead of 
+   searching through all the combinations of factors.
+
+   Let g_1, ..., g_r be the monic factors of f modulo p^e, and T_i = f*g_i'/g_i (mod p^e).
+   If G is a factor of f, then G = c*\prod_{i in S} g_i (mod p^e) for some set S, and 
+   \sum_{i in S} T_i = f*G'/G (mod p^e), whose coefficients are bounded by 2^s (see log_derivative_bound).
+   So, after dropping the s least significant bits of the coefficients of the T_i, the 0-1 vector
+   of S is a short vector of a knapsack lattice.
+
+   The rows of the matrix M (initially the identity) span a lattice containing the 0-1 vectors 
+   of all factors of f. One coefficient of the T_i at a time, M is refined using LLL, keeping
+   only the part of the reduced basis that may contain short vectors. The factors g_i with 
+   identical columns in M belong to the same factor of f. So, when all the candidates obtained 
+   by grouping them divide f, they are irreducible.
+
+   Return false if the method failed. In this case, fs is not modified.
+*/
+static bool lattice_recombine(z_manager & upm, numeral_vector const & f, zp_factors const & zpe_fs, unsigned s, 
+                              factors & fs, unsigned k) {
+    z_numeral_manager & nm = upm.zm();
+    zp_manager & zpe_upm = zpe_fs.upm();
+    zp_numeral_manager & zpe_nm = zpe_upm.m();
+    unsigned r = zpe_fs.distinct_factors();
+    unsigned n = upm.degree(f);
+    SASSERT(r > 1 && n > 1);
+
+    small_object_allocator allocator("lattice_recombine");
+    mpz_matrix_manager mm(nm, allocator);
+    
+    // T(i, j) is the j-th coefficient of f*g_i'/g_i (mod p^e) without the s least significant bits
+    scoped_mpz_matrix T(mm);
+    mm.mk(r, n, T);
+    scoped_mpz_vector f_pe(nm), g_prime(nm), tmp(nm), q(nm);
+    to_zp_manager(zpe_upm, f, f_pe);
+    for (unsigned i = 0; i < r; ++ i) {
+        SASSERT(zpe_fs.get_degree(i) == 1);
+        zpe_upm.derivative(zpe_fs[i], g_prime);
+        zpe_upm.mul(f_pe, g_prime, tmp);
+        zpe_upm.div(tmp.size(), tmp.c_ptr(), zpe_fs[i].size(), zpe_fs[i].c_ptr(), q);
+        SASSERT(q.size() <= n);
+        for (unsigned j = 0; j < q.size(); ++ j) {
+            nm.machine_div2k(q[j], s, T(i, j));
+        }
+    }
+    scoped_mpz P(nm), half_P(nm);
+    nm.machine_div2k(zpe_nm.p(), s, P);
+    nm.machine_div2k(P, 1, half_P);
+
+    scoped_mpz_matrix M(mm);
+    mm.mk(r, r, M);
+    for (unsigned i = 0; i < r; ++ i) {
+        M.set(i, i, 1);
+    }
+    unsigned t = r;
+
+    // For the vector of a factor of f, the knapsack coordinate is at most 1 + 3r (the coefficient of 
+    // f*G'/G, the truncation errors, and the wrap arounds modulo p^e), so the squared norm is 
+    // at most r + (3r + 1)^2.
+    scoped_mpz bound(nm), tmp_bound(nm);
+    nm.set(bound, r + (3*r + 1)*(3*r + 1));
+
+    unsigned_vector group;
+    scoped_mpz_vector d(nm);
+    // the leading and trailing coefficients carry the most information, so we use them first
+    for (unsigned c = 0; c < n; ++ c) {
+        upm.checkpoint();
+        unsigned j = c % 2 == 0 ? n - 1 - c/2 : c/2;
+
+        // the knapsack lattice: [M_i | \sum_l M(i, l)*T(l, j) (mod P)] for i < t, and [0 | P]
+        scoped_mpz_matrix A(mm);
+        mm.mk(t + 1, r + 1, A);
+        for (unsigned i = 0; i < t; ++ i) {
+            for (unsigned l = 0; l < r; ++ l) {
+                nm.set(A(i, l), M(i, l));
+                nm.addmul(A(i, r), M(i, l), T(l, j), A(i, r));
+            }
+            nm.mod(A(i, r), P, A(i, r));
+            if (nm.gt(A(i, r), half_P)) {
+                nm.sub(A(i, r), P, A(i, r));
+            }
+        }
+        nm.set(A(t, r), P);
+        
+        d.resize(t + 2);
+        if (!mm.lll(A, d.c_ptr())) {
+            return false;
+        }
+
+        // if the Gram-Schmidt vectors b*_i for i >= new_t are longer than the bound, then all 
+        // vectors within the bound are in the span of the first new_t vectors
+        unsigned new_t = t + 1;
+        while (new_t > 0) {
+            nm.mul(bound, d[new_t - 1], tmp_bound);
+            if (!nm.gt(d[new_t], tmp_bound)) {
+                break;
+            }
+            new_t --;
+        }
+        if (new_t == 0) {
+            return false;
+        }
+        
+        scoped_mpz_matrix new_M(mm);
+        mm.mk(new_t, r, new_M);
+        for (unsigned i = 0; i < new_t; ++ i) {
+            for (unsigned l = 0; l < r; ++ l) {
+                nm.set(new_M(i, l), A(i, l));
+            }
+        }
+        M.swap(new_M);
+        t = new_t;
+
+        // group the factors with identical columns
+        group.reset();
+        unsigned num_groups = 0;
+        for (unsigned i = 0; i < r; ++ i) {
+            unsigned g = num_groups;
+            for (unsigned i2 = 0; i2 < i && g == num_groups; ++ i2) {
+                bool same = true;
+                for (unsigned l = 0; l < t && same; ++ l) {
+                    same = nm.eq(M(l, i), M(l, i2));
+                }
+                if (same) {
+                    g = group[i2];
+                }
+            }
+            if (g == num_groups) {
+                num_groups ++;
+            }
+            group.push_back(g);
+        }
+        TRACE("polynomial::factorization::bughunt", 
+              tout << "lattice recombination, coefficient " << j << ", dimension " << t << ", groups " << num_groups << endl;);
+
+        if (num_groups == t && lattice_trial_division(upm, f, zpe_fs, group, num_groups, fs, k)) {
+#ifndef _EXTERNAL_RELEASE 
+            IF_VERBOSE(FACTOR_VERBOSE_LVL, verbose_stream() << "(polynomial-factorization :lattice-coefficients " << (c + 1) << ")" << std::endl;);
+#endif
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
    \brief Given f from Z[x] that is square free, it factors it.
    This method also assumes f is primitive.
@@ -1158,6 +1400,15 @@ bool factor_square_free(z_manager & upm, numeral_vector const & f, factors & fs,
     // get a bound on B for the factors of f_pp with degree less or equal to deg(f)/2
     // and then choose e to be smallest such that p^e > 2*lc(f)*B, we use the mignotte
     unsigned e = mignotte_bound(upm, f_pp, zp_fs_p);
+
+    // with many factors, we recombine them using lattice reduction, which needs more precision
+    unsigned num_zp_factors = zp_fs.distinct_factors();
+    bool use_lattice = params.m_lattice_min_factors > 0 && num_zp_factors >= params.m_lattice_min_factors;
+    unsigned log_bound = 0;
+    if (use_lattice) {
+        log_bound = log_derivative_bound(upm, f_pp);
+        e = std::max(e, lift_exponent(upm.zm(), zp_fs_p, log_bound + 3*num_zp_factors + 64));
+    }
     TRACE("polynomial::factorization::bughunt", 
           tout << "out p = " << nm.to_string(zp_fs_p) << ", and we'll work p^e for e = " << e << endl;
           );
@@ -1176,6 +1427,10 @@ bool factor_square_free(z_manager & upm, numeral_vector const & f, factors & fs,
     IF_VERBOSE(FACTOR_VERBOSE_LVL, verbose_stream() << "(polynomial-factorization :num-candidate-factors " << zpe_fs.distinct_factors() << ")" << std::endl;);
 #endif
     
+    if (use_lattice && lattice_recombine(upm, f_pp, zpe_fs, log_bound, fs, k)) {
+        return true;
+    }
+    
     // the leading coefficient of f_pp mod p^e
     scoped_numeral f_pp_lc(nm);
     zpe_nm.set(f_pp_lc, f_pp.back());
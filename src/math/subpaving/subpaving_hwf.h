@@ -34,6 +34,7 @@ public:
     static void round_to_minus_inf(numeral_manager & m) { m.round_to_minus_inf(); }
     static void round_to_plus_inf(numeral_manager & m)  { m.round_to_plus_inf(); }
     static void set_rounding(numeral_manager & m, bool to_plus_inf)  { m.set_rounding(to_plus_inf); }
+    static bool to_dinterval(numeral_manager & m, hwf const & a, dinterval & r) { double d = m.m().to_double(a); r = dinterval(d, d); return true; }
     config_hwf(f2n<hwf_manager> & m):m_manager(m) {}
     f2n<hwf_manager> & m() const { return const_cast<f2n<hwf_manager> &>(m_manager); }
 };
@@ -35,6 +35,7 @@ public:
     static void round_to_minus_inf(numeral_manager & m) { m.round_to_minus_inf(); }
     static void round_to_plus_inf(numeral_manager & m)  { m.round_to_plus_inf(); }
     static void set_rounding(numeral_manager & m, bool to_plus_inf)  { m.set_rounding(to_plus_inf); }
+    static bool to_dinterval(numeral_manager & m, mpf const & a, dinterval & r) { return false; }
     config_mpf(f2n<mpf_manager> & m):m_manager(m) {}
     f2n<mpf_manager> & m() const { return const_cast<f2n<mpf_manager> &>(m_manager); }
 };
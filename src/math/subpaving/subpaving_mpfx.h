@@ -31,6 +31,7 @@ struct config_mpfx {
     static void round_to_minus_inf(numeral_manager & m) { m.round_to_minus_inf(); }
     static void round_to_plus_inf(numeral_manager & m) { m.round_to_plus_inf(); }
     static void set_rounding(numeral_manager & m, bool to_plus_inf) { m.set_rounding(to_plus_inf); }
+    static bool to_dinterval(numeral_manager & m, mpfx const & a, dinterval & r) { return false; }
 
     numeral_manager & m_manager;
 
@@ -31,6 +31,7 @@ struct config_mpq {
     static void round_to_minus_inf(numeral_manager & m) {}
     static void round_to_plus_inf(numeral_manager & m) {}
     static void set_rounding(numeral_manager & m, bool to_plus_info) {}
+    static bool to_dinterval(numeral_manager & m, mpq const & a, dinterval & r) { dinterval_set(m, a, r); return true; }
     numeral_manager & m_manager;
     config_mpq(numeral_manager & m):m_manager(m) {}
     numeral_manager & m() const { return m_manager; }
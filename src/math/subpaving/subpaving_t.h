@@ -25,6 +25,7 @@ Revision History:
 #include"chashtable.h"
 #include"parray.h"
 #include"interval.h"
+#include"double_interval.h"
 #include"scoped_numeral_vector.h"
 #include"subpaving_types.h"
 #include"params.h"
@@ -152,6 +153,7 @@ public:
         uint64        m_timestamp;
         bound *       m_prev;
         justification m_jst;
+        dinterval     m_approx;    //!< enclosure of m_val, used by the approximate filter.
         void set_timestamp(uint64 ts) { m_timestamp = ts; }
     public:
         var x() const { return static_cast<var>(m_x); }
@@ -340,8 +342,10 @@ public:
         unsigned    m_size;
         numeral     m_c;
         numeral *   m_as;
+        dinterval * m_approx_as; //!< enclosures of m_as, used by the approximate filter.
+        dinterval   m_approx_c;
         var *       m_xs;
-        static unsigned get_obj_size(unsigned sz) { return sizeof(polynomial) + sz*sizeof(numeral) + sz*sizeof(var); }
+        static unsigned get_obj_size(unsigned sz) { return sizeof(polynomial) + sz*sizeof(numeral) + sz*sizeof(dinterval) + sz*sizeof(var); }
     public:
         polynomial():definition(constraint::POLYNOMIAL) {}
         unsigned size() const { return m_size; }
@@ -514,6 +518,8 @@ private:
     unsigned                  m_max_depth;       //!< Maximum depth
     unsigned                  m_max_nodes;       //!< Maximum number of nodes in the tree
     unsigned long long        m_max_memory;      // in bytes
+    bool                      m_approx_filter;   //!< Use hardware doubles to skip propagations that cannot produce relevant bounds.
+    bool                      m_approx_supported; //!< True if C::to_dinterval can convert numerals.
     
     // Counters
     unsigned                  m_num_nodes;
@@ -523,10 +529,13 @@ private:
     unsigned                  m_num_mk_bounds;
     unsigned                  m_num_splits;
     unsigned                  m_num_visited;
+    unsigned                  m_num_approx_filtered;
     
     // Temporary
     numeral                   m_tmp1, m_tmp2, m_tmp3;
     interval                  m_i_tmp1, m_i_tmp2, m_i_tmp3;
+    svector<dinterval>        m_approx_lowers, m_approx_uppers, m_approx_tmp1, m_approx_tmp2;
+    svector<bool>             m_approx_skip;
 
 
     friend class node;
@@ -689,6 +698,16 @@ private:
     // Propagate a new bound for y using the polynomial associated with x. x may be equal to y.
     void propagate_polynomial(var x, node * n, var y);
 
+    /**
+       \brief Compute enclosures of the bounds that propagate_polynomial(x, n, y) would deduce,
+       for y = x and every variable y of get_polynomial(x), using one batch of hardware double operations.
+       Store in m_approx_skip[0] (y = x) and m_approx_skip[i+1] (y = get_polynomial(x)->x(i)) whether
+       the deduced bounds are certainly irrelevant.
+       Return false if the filter could not be applied.
+    */
+    bool approx_filter_polynomial(var x, node * n);
+    bool approx_irrelevant(var y, dinterval const & k, bool lower, node * n) const;
+
     /**
        \brief Propagate new bounds at node n using clause c.
     */
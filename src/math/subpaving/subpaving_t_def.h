@@ -433,6 +433,8 @@ context_t<C>::context_t(reslimit& lim, C const & c, params_ref const & p, small_
     m_var_selector  = alloc(round_robing_var_selector<C>, this);
     m_node_splitter = alloc(midpoint_node_splitter<C>, this);
     m_num_nodes     = 0;
+    dinterval d;
+    m_approx_supported = C::to_dinterval(nm(), m_tmp1, d);
     updt_params(p);
     reset_statistics();
 }
@@ -501,6 +503,8 @@ void context_t<C>::updt_params(params_ref const & p) {
         prec = 1;
     nm().set(m_nth_root_prec, static_cast<int>(prec));
     nm().inv(m_nth_root_prec);
+
+    m_approx_filter = m_approx_supported && p.get_bool("approx_filter", true);
 }
 
 template<typename C>
@@ -510,6 +514,7 @@ void context_t<C>::collect_param_descrs(param_descrs & d) {
     d.insert("epsilon", CPK_UINT, "(default: 20) value k s.t. a new lower (upper) bound for x is propagated only new-lower(x) > lower(k) + 1/k * max(min(upper(x) - lower(x), |lower|), 1) (new-upper(x) < upper(x) - 1/k * max(min(upper(x) - lower(x), |lower|), 1)). If k = 0, then this restriction is ignored.");
     d.insert("max_bound", CPK_UINT, "(default 10) value k s.t. a new upper (lower) bound for x is propagated only if upper(x) > -10^k or lower(x) = -oo (lower(x) < 10^k or upper(x) = oo)");
     d.insert("nth_root_precision", CPK_UINT, "(default 8192) value k s.t. 1/k is the precision for computing the nth root in the subpaving module.");
+    d.insert("approx_filter", CPK_BOOL, "(default: true) use hardware doubles with outward rounding to skip the propagations that cannot produce new bounds.");
 }
 
 template<typename C>
@@ -519,6 +524,7 @@ void context_t<C>::display_params(std::ostream & out) const {
     out << "epsilon    " << nm().to_rational_string(m_epsilon) << "\n";
     out << "max_bound  " << nm().to_rational_string(m_max_bound) << "\n";
     out << "max_memory " << m_max_memory << "\n";
+    out << "approx_filter " << m_approx_filter << "\n";
 }
 
 template<typename C>
@@ -553,6 +559,8 @@ typename context_t<C>::bound * context_t<C>::mk_bound(var x, numeral const & val
     else {
         nm().set(r->m_val, val);
     }
+    if (m_approx_supported)
+        C::to_dinterval(nm(), r->m_val, r->m_approx);
     r->m_lower     = lower;
     r->m_open      = open;
     r->m_mark      = false;
@@ -750,7 +758,8 @@ var context_t<C>::mk_sum(numeral const & c, unsigned sz, numeral const * as, var
     p->m_size        = sz;
     nm().set(p->m_c, c);
     p->m_as          = reinterpret_cast<numeral*>(static_cast<char*>(mem) + sizeof(polynomial));
-    p->m_xs          = reinterpret_cast<var*>(reinterpret_cast<char*>(p->m_as) + sizeof(numeral)*sz);
+    p->m_approx_as   = reinterpret_cast<dinterval*>(reinterpret_cast<char*>(p->m_as) + sizeof(numeral)*sz);
+    p->m_xs          = reinterpret_cast<var*>(reinterpret_cast<char*>(p->m_approx_as) + sizeof(dinterval)*sz);
     memcpy(p->m_xs, xs, sizeof(var)*sz);
     std::sort(p->m_xs, p->m_xs+sz);
     for (unsigned i = 0; i < sz; i++) {
@@ -758,7 +767,11 @@ var context_t<C>::mk_sum(numeral const & c, unsigned sz, numeral const * as, var
         new (curr) numeral();
         var x = p->m_xs[i];
         nm().swap(m_num_buffer[x], *curr);
+        if (m_approx_supported)
+            C::to_dinterval(nm(), *curr, p->m_approx_as[i]);
     }
+    if (m_approx_supported)
+        C::to_dinterval(nm(), p->m_c, p->m_approx_c);
     TRACE("subpaving_mk_sum", tout << "new variable is integer: " << is_int(p) << "\n";);
     var new_var      = mk_var(is_int(p));
     for (unsigned i = 0; i < sz; i++) {
@@ -1423,6 +1436,17 @@ void context_t<C>::propagate_polynomial(var x, node * n, var y) {
             else
                 im().add(r, av, r);
         }
+        // x = c + r
+        if (!nm().is_zero(p->c())) {
+            if (!r.m_l_inf) {
+                C::round_to_minus_inf(nm());
+                nm().add(r.m_l_val, p->c(), r.m_l_val);
+            }
+            if (!r.m_u_inf) {
+                C::round_to_plus_inf(nm());
+                nm().add(r.m_u_val, p->c(), r.m_u_val);
+            }
+        }
         // r contains the deduced bounds for x == y
     }
     else {
@@ -1441,6 +1465,17 @@ void context_t<C>::propagate_polynomial(var x, node * n, var y) {
                 TRACE("propagate_polynomial_bug", tout << "a: "; nm().display(tout, a); tout << "\n";);
             }
         }
+        // a*y = r - c
+        if (!nm().is_zero(p->c())) {
+            if (!r.m_l_inf) {
+                C::round_to_minus_inf(nm());
+                nm().sub(r.m_l_val, p->c(), r.m_l_val);
+            }
+            if (!r.m_u_inf) {
+                C::round_to_plus_inf(nm());
+                nm().sub(r.m_u_val, p->c(), r.m_u_val);
+            }
+        }
         TRACE("propagate_polynomial_bug", tout << "r before mul 1/a: "; im().display(tout, r); tout << "\n";);
         im().div(r, a, r);
         TRACE("propagate_polynomial_bug", tout << "r after mul 1/a:  "; im().display(tout, r); tout << "\n";);
@@ -1462,6 +1497,144 @@ void context_t<C>::propagate_polynomial(var x, node * n, var y) {
     }
 }
 
+template<typename C>
+bool context_t<C>::approx_irrelevant(var y, dinterval const & k, bool lower, node * n) const {
+    // k is an enclosure of the new bound for y.
+    // The new bound is irrelevant if it is certainly weaker than the current one,
+    // even after integer normalization (which may increase it by less than 1).
+    if (!k.is_finite())
+        return false;
+    if (lower) {
+        bound * curr = n->lower(y);
+        if (curr == 0)
+            return false;
+        double u = k.upper();
+        if (is_int(y))
+            u += 1.0;
+        return u < curr->m_approx.lower();
+    }
+    else {
+        bound * curr = n->upper(y);
+        if (curr == 0)
+            return false;
+        double neg_l = k.m_neg_l;
+        if (is_int(y))
+            neg_l += 1.0;
+        return curr->m_approx.upper() < -neg_l;
+    }
+}
+
+template<typename C>
+bool context_t<C>::approx_filter_polynomial(var x, node * n) {
+    SASSERT(m_approx_filter);
+    SASSERT(is_polynomial(x));
+    polynomial * p = get_polynomial(x);
+    unsigned sz    = p->size();
+    if (!p->m_approx_c.is_finite())
+        return false;
+    m_approx_lowers.reserve(sz);
+    m_approx_uppers.reserve(sz);
+    m_approx_tmp1.reserve(sz);
+    m_approx_tmp2.reserve(sz);
+    m_approx_skip.reset();
+    m_approx_skip.resize(sz + 1, false);
+    dinterval zero(0.0, 0.0);
+    // number of terms a_i*z_i without lower (upper) bound, and the position of the last one.
+    unsigned num_l_inf = 0, num_u_inf = 0;
+    unsigned l_inf_idx = UINT_MAX, u_inf_idx = UINT_MAX;
+    for (unsigned i = 0; i < sz; i++) {
+        var z = p->x(i);
+        if (!p->m_approx_as[i].is_finite())
+            return false;
+        bool pos = nm().is_pos(p->a(i));
+        bound * l = pos ? n->lower(z) : n->upper(z);
+        bound * u = pos ? n->upper(z) : n->lower(z);
+        if (l == 0) {
+            m_approx_lowers[i] = zero;
+            num_l_inf++;
+            l_inf_idx = i;
+        }
+        else if (l->m_approx.is_finite()) {
+            m_approx_lowers[i] = l->m_approx;
+        }
+        else {
+            return false;
+        }
+        if (u == 0) {
+            m_approx_uppers[i] = zero;
+            num_u_inf++;
+            u_inf_idx = i;
+        }
+        else if (u->m_approx.is_finite()) {
+            m_approx_uppers[i] = u->m_approx;
+        }
+        else {
+            return false;
+        }
+    }
+    bound * x_l = n->lower(x);
+    bound * x_u = n->upper(x);
+    if ((x_l != 0 && !x_l->m_approx.is_finite()) || (x_u != 0 && !x_u->m_approx.is_finite()))
+        return false;
+
+    dinterval_round_up scope;
+    dinterval * ls = m_approx_lowers.c_ptr();
+    dinterval * us = m_approx_uppers.c_ptr();
+    dinterval * tl = m_approx_tmp1.c_ptr();
+    dinterval * tu = m_approx_tmp2.c_ptr();
+    // tl[i] (tu[i]) is an enclosure of the lower (upper) bound of a_i*z_i
+    dinterval_mul(sz, p->m_approx_as, ls, tl);
+    dinterval_mul(sz, p->m_approx_as, us, tu);
+    dinterval sl, su, k;
+    dinterval_sum(sz, tl, sl);
+    dinterval_sum(sz, tu, su);
+
+    // y == x: x = c + sum a_i*z_i
+    dinterval_add(p->m_approx_c, sl, k);
+    bool irr_l = num_l_inf > 0 || approx_irrelevant(x, k, true, n);
+    dinterval_add(p->m_approx_c, su, k);
+    bool irr_u = num_u_inf > 0 || approx_irrelevant(x, k, false, n);
+    m_approx_skip[0] = irr_l && irr_u;
+
+    // y == z_j: a_j*z_j = x - c - sum_{i != j} a_i*z_i
+    // ls[j] := lower(x) - c - sum tu + tu[j]
+    // us[j] := upper(x) - c - sum tl + tl[j]
+    dinterval r;
+    dinterval_sub(x_l ? x_l->m_approx : zero, p->m_approx_c, r);
+    dinterval_sub(r, su, r);
+    dinterval_add(sz, r, tu, ls);
+    dinterval_sub(x_u ? x_u->m_approx : zero, p->m_approx_c, r);
+    dinterval_sub(r, sl, r);
+    dinterval_add(sz, r, tl, us);
+    for (unsigned j = 0; j < sz; j++) {
+        var y = p->x(j);
+        bool has_l = x_l != 0 && (num_u_inf == 0 || (num_u_inf == 1 && u_inf_idx == j));
+        bool has_u = x_u != 0 && (num_l_inf == 0 || (num_l_inf == 1 && l_inf_idx == j));
+        if (nm().is_neg(p->a(j)))
+            std::swap(has_l, has_u);
+        if (has_l) {
+            dinterval & e = nm().is_pos(p->a(j)) ? ls[j] : us[j];
+            if (!e.is_finite())
+                continue;
+            dinterval_div(e, p->m_approx_as[j], k);
+            if (!approx_irrelevant(y, k, true, n))
+                continue;
+        }
+        if (has_u) {
+            dinterval & e = nm().is_pos(p->a(j)) ? us[j] : ls[j];
+            if (!e.is_finite())
+                continue;
+            dinterval_div(e, p->m_approx_as[j], k);
+            if (!approx_irrelevant(y, k, false, n))
+                continue;
+        }
+        m_approx_skip[j+1] = true;
+    }
+    TRACE("subpaving_approx_filter", display(tout, x); tout << " skip:";
+          for (unsigned i = 0; i <= sz; i++) tout << " " << m_approx_skip[i]; tout << "\n";);
+    return true;
+}
+
 template<typename C>
 void context_t<C>::propagate_polynomial(var x, node * n) {
     TRACE("propagate_polynomial", tout << "propagate_polynomial: "; display(tout, x); tout << "\n";);
@@ -1483,14 +1656,36 @@ void context_t<C>::propagate_polynomial(var x, node * n) {
     }
     TRACE("propagate_polynomial", tout << "unbounded_var: "; display(tout, unbounded_var); tout << "\n";);
     
+    // The filter is computed using the bounds at this point. It is not used anymore after a new bound is created.
+    bool filter = m_approx_filter && approx_filter_polynomial(x, n);
+    unsigned num_mk_bounds = m_num_mk_bounds;
     if (unbounded_var != null_var) {
+        if (filter) {
+            unsigned idx = 0;
+            if (unbounded_var != x) {
+                while (p->x(idx) != unbounded_var)
+                    idx++;
+                idx++;
+            }
+            if (m_approx_skip[idx]) {
+                m_num_approx_filtered++;
+                return;
+            }
+        }
         propagate_polynomial(x, n, unbounded_var);
     }
     else {
-        propagate_polynomial(x, n, x);
+        if (filter && m_approx_skip[0])
+            m_num_approx_filtered++;
+        else
+            propagate_polynomial(x, n, x);
         for (unsigned i = 0; i < sz; i++) {
             if (inconsistent(n))
                 return;
+            if (filter && m_num_mk_bounds == num_mk_bounds && m_approx_skip[i+1]) {
+                m_num_approx_filtered++;
+                continue;
+            }
             propagate_polynomial(x, n, p->x(i));
         }
     }
@@ -1513,9 +1708,6 @@ void context_t<C>::propagate_monomial(var x, node * n) {
             found_zero = true;
         }
         if (m->degree(i) % 2 == 0) {
-            if (is_upper_zero(y, n)) {
-                found_zero = true;
-            }
             continue; // elements with even power always produce a lower bound
         }
         if (is_unbounded(y, n)) {
@@ -1618,11 +1810,18 @@ void context_t<C>::propagate_monomial_downward(var x, node * n, unsigned j) {
                 continue;
             y.set_constant(n, m->x(i));
             im().power(y, m->degree(i), yk); 
-            if (first)
+            if (first) {
                 im().set(d, yk);
-            else
-                im().mul(d, yk, r);
+                first = false;
+            }
+            else {
+                im().mul(d, yk, d);
+            }
         }
+        // the power of an open interval (-a, 0) may be approximated by [0, a^k),
+        // so d may contain zero even if no factor does.
+        if (im().contains_zero(d))
+            return;
         interval & aux  = m_i_tmp2;    
         aux.set_constant(n, x);
         im().div(aux, d, r);
@@ -1872,6 +2071,7 @@ void context_t<C>::reset_statistics() {
     m_num_mk_bounds = 0;
     m_num_splits    = 0;
     m_num_visited   = 0;
+    m_num_approx_filtered = 0;
 }
 
 template<typename C>
@@ -1881,6 +2081,7 @@ void context_t<C>::collect_statistics(statistics & st) const {
     st.update("splits",     m_num_splits);
     st.update("nodes",      m_num_nodes);
     st.update("visited",    m_num_visited);
+    st.update("approx filtered", m_num_approx_filtered);
 }
 
 // -----------------------------------
@@ -0,0 +1,420 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    compiled_model_evaluator.cpp
+
+Abstract:
+
+    Evaluate a fixed set of expressions in many models.
+
+Author:
+
+Revision History:
+
+--*/
+#include"compiled_model_evaluator.h"
+#include"model.h"
+#include"model_evaluator.h"
+#include"ast_pp.h"
+#include"heap.h"
+
+struct compiled_model_evaluator::imp {
+    enum instr_kind {
+        INSTR_CONST,     // uninterpreted constant
+        INSTR_APP,       // application of an interpreted function symbol
+        INSTR_FUNC_APP,  // application that depends on the interpretation of a function symbol
+        INSTR_OPAQUE     // quantifier or variable, evaluated at every run
+    };
+
+    struct instr {
+        unsigned m_kind;
+        unsigned m_func;   // index in m_funcs for INSTR_FUNC_APP
+        unsigned m_begin;  // the arguments are the slots m_args[m_begin], ..., m_args[m_end - 1]
+        unsigned m_end;
+    };
+
+    struct slot_lt {
+        bool operator()(int s1, int s2) const { return s1 < s2; }
+    };
+
+    struct stats {
+        unsigned m_runs;
+        unsigned m_updates;
+        unsigned m_evals;
+        unsigned m_skipped;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+    ast_manager &            m;
+    params_ref               m_params;
+    bool                     m_completion;
+    expr_ref_vector          m_terms;       // slot -> term
+    obj_map<expr, unsigned>  m_slot;
+    svector<instr>           m_code;        // slot -> instruction
+    unsigned_vector          m_args;
+    expr_ref_vector          m_values;      // slot -> value in the last model
+    svector<bool>            m_changed;     // slot -> value changed in the current run
+    vector<unsigned_vector>  m_parents;     // slot -> instructions using it as an argument
+    obj_map<func_decl, unsigned> m_const2slot;
+    unsigned_vector          m_opaque;
+    unsigned                 m_num_valid;   // slots [0, m_num_valid) have a value
+    unsigned_vector          m_roots;
+    func_decl_ref_vector     m_funcs;       // function symbols the compiled terms depend on
+    obj_map<func_decl, unsigned> m_func2idx;
+    expr_ref_vector          m_func_interps; // interpretation of m_funcs[i] in the last model
+    svector<bool>            m_func_changed;
+    vector<unsigned_vector>  m_func_users;  // function -> instructions depending on its interpretation
+    heap<slot_lt>            m_queue;
+    ptr_vector<expr>         m_todo;
+    ptr_vector<expr>         m_buffer;
+    stats                    m_stats;
+
+    imp(ast_manager & _m, params_ref const & p):
+        m(_m),
+        m_params(p),
+        m_completion(false),
+        m_terms(m),
+        m_values(m),
+        m_num_valid(0),
+        m_funcs(m),
+        m_func_interps(m),
+        m_queue(0) {
+    }
+
+    unsigned mk_func(func_decl * f) {
+        unsigned idx;
+        if (m_func2idx.find(f, idx))
+            return idx;
+        idx = m_funcs.size();
+        m_funcs.push_back(f);
+        m_func2idx.insert(f, idx);
+        m_func_interps.push_back(0);
+        m_func_changed.push_back(true);
+        m_func_users.push_back(unsigned_vector());
+        return idx;
+    }
+
+    // Return the uninterpreted function symbol the value of t depends on, or 0.
+    // This is the declaration itself (f(t_1, ..., t_n)) or a parameter (e.g., as-array).
+    func_decl * get_func(app * t) const {
+        func_decl * d = t->get_decl();
+        if (d->get_family_id() == null_family_id)
+            return d;
+        for (unsigned i = 0; i < d->get_num_parameters(); i++) {
+            parameter const & p = d->get_parameter(i);
+            if (p.is_ast() && is_func_decl(p.get_ast()) && to_func_decl(p.get_ast())->get_family_id() == null_family_id)
+                return to_func_decl(p.get_ast());
+        }
+        return 0;
+    }
+
+    void mk_instr(expr * t) {
+        unsigned slot = m_terms.size();
+        instr i;
+        i.m_func  = UINT_MAX;
+        i.m_begin = m_args.size();
+        if (is_app(t) && to_app(t)->get_num_args() == 0 && to_app(t)->get_family_id() == null_family_id) {
+            i.m_kind = INSTR_CONST;
+            m_const2slot.insert(to_app(t)->get_decl(), slot);
+        }
+        else if (is_app(t)) {
+            app * a = to_app(t);
+            for (unsigned j = 0; j < a->get_num_args(); j++) {
+                unsigned arg = m_slot.find(a->get_arg(j));
+                m_args.push_back(arg);
+                m_parents[arg].push_back(slot);
+            }
+            func_decl * f = get_func(a);
+            if (f != 0) {
+                i.m_kind = INSTR_FUNC_APP;
+                i.m_func = mk_func(f);
+                m_func_users[i.m_func].push_back(slot);
+            }
+            else {
+                i.m_kind = INSTR_APP;
+            }
+        }
+        else {
+            i.m_kind = INSTR_OPAQUE;
+            m_opaque.push_back(slot);
+        }
+        i.m_end = m_args.size();
+        m_slot.insert(t, slot);
+        m_terms.push_back(t);
+        m_code.push_back(i);
+        m_values.push_back(0);
+        m_changed.push_back(true);
+        m_parents.push_back(unsigned_vector());
+    }
+
+    unsigned compile(expr * root) {
+        SASSERT(m_todo.empty());
+        m_todo.push_back(root);
+        while (!m_todo.empty()) {
+            expr * t = m_todo.back();
+            if (m_slot.contains(t)) {
+                m_todo.pop_back();
+                continue;
+            }
+            bool visited = true;
+            if (is_app(t)) {
+                app * a = to_app(t);
+                for (unsigned j = 0; j < a->get_num_args(); j++) {
+                    expr * arg = a->get_arg(j);
+                    if (!m_slot.contains(arg)) {
+                        m_todo.push_back(arg);
+                        visited = false;
+                    }
+                }
+            }
+            if (!visited)
+                continue;
+            m_todo.pop_back();
+            mk_instr(t);
+        }
+        m_roots.push_back(m_slot.find(root));
+        TRACE("compiled_model_evaluator", tout << "compiled " << mk_pp(root, m) << "\nnum instructions: " << m_code.size() << "\n";);
+        return m_roots.size() - 1;
+    }
+
+    void update_func(model & md, unsigned i) {
+        func_interp * fi = md.get_func_interp(m_funcs.get(i));
+        expr * interp    = fi == 0 ? 0 : fi->get_interp();
+        // partial interpretations have no expression, they are considered modified.
+        m_func_changed[i] = interp == 0 || interp != m_func_interps.get(i);
+        m_func_interps.set(i, interp);
+    }
+
+    void update_funcs(model & md) {
+        for (unsigned i = 0; i < m_funcs.size(); i++)
+            update_func(md, i);
+    }
+
+    bool args_changed(instr const & i) const {
+        for (unsigned j = i.m_begin; j < i.m_end; j++)
+            if (m_changed[m_args[j]])
+                return true;
+        return false;
+    }
+
+    void eval(model_evaluator & ev, unsigned slot, expr_ref & r) {
+        instr const & i = m_code[slot];
+        expr * t        = m_terms.get(slot);
+        if (i.m_kind == INSTR_OPAQUE || i.m_begin == i.m_end) {
+            ev(t, r);
+            return;
+        }
+        m_buffer.reset();
+        for (unsigned j = i.m_begin; j < i.m_end; j++)
+            m_buffer.push_back(m_values.get(m_args[j]));
+        app_ref n(m.mk_app(to_app(t)->get_decl(), m_buffer.size(), m_buffer.c_ptr()), m);
+        ev(n, r);
+    }
+
+    void operator()(model & md) {
+        m_stats.m_runs++;
+        model_evaluator ev(md, m_params);
+        ev.set_model_completion(m_completion);
+        update_funcs(md);
+        expr_ref r(m);
+        for (unsigned slot = 0; slot < m_code.size(); slot++) {
+            instr const & i = m_code[slot];
+            bool recompute  = slot >= m_num_valid;
+            switch (i.m_kind) {
+            case INSTR_CONST: {
+                expr * v = md.get_const_interp(to_app(m_terms.get(slot))->get_decl());
+                if (v == 0) {
+                    recompute = true;
+                }
+                else {
+                    m_changed[slot] = recompute || v != m_values.get(slot);
+                    m_values.set(slot, v);
+                    continue;
+                }
+                break;
+            }
+            case INSTR_APP:
+                recompute = recompute || args_changed(i);
+                break;
+            case INSTR_FUNC_APP:
+                recompute = recompute || m_func_changed[i.m_func] || args_changed(i);
+                break;
+            default:
+                recompute = true;
+                break;
+            }
+            if (!recompute) {
+                m_changed[slot] = false;
+                m_stats.m_skipped++;
+                continue;
+            }
+            m_stats.m_evals++;
+            eval(ev, slot, r);
+            m_changed[slot] = slot >= m_num_valid || r.get() != m_values.get(slot);
+            m_values.set(slot, r);
+        }
+        m_num_valid = m_code.size();
+    }
+
+    void enqueue(unsigned slot) {
+        if (!m_queue.contains(slot))
+            m_queue.insert(slot);
+    }
+
+    // Evaluate the instructions that (transitively) depend on the given declarations.
+    // The queue returns the smallest slot first, so arguments are evaluated before their parents.
+    void update(model & md, unsigned num_decls, func_decl * const * decls) {
+        if (m_num_valid < m_code.size()) {
+            (*this)(md);
+            return;
+        }
+        m_stats.m_updates++;
+        model_evaluator ev(md, m_params);
+        ev.set_model_completion(m_completion);
+        m_queue.reset();
+        m_queue.set_bounds(m_code.size());
+        for (unsigned i = 0; i < num_decls; i++) {
+            unsigned idx;
+            if (m_const2slot.find(decls[i], idx)) {
+                enqueue(idx);
+            }
+            else if (m_func2idx.find(decls[i], idx)) {
+                update_func(md, idx);
+                unsigned_vector const & users = m_func_users[idx];
+                for (unsigned j = 0; j < users.size(); j++)
+                    enqueue(users[j]);
+            }
+        }
+        for (unsigned i = 0; i < m_opaque.size(); i++)
+            enqueue(m_opaque[i]);
+        expr_ref r(m);
+        while (!m_queue.empty()) {
+            unsigned slot = m_queue.erase_min();
+            m_stats.m_evals++;
+            expr * v = 0;
+            if (m_code[slot].m_kind == INSTR_CONST)
+                v = md.get_const_interp(to_app(m_terms.get(slot))->get_decl());
+            if (v != 0)
+                r = v;
+            else
+                eval(ev, slot, r);
+            if (r.get() == m_values.get(slot))
+                continue;
+            m_values.set(slot, r);
+            unsigned_vector const & parents = m_parents[slot];
+            for (unsigned j = 0; j < parents.size(); j++)
+                enqueue(parents[j]);
+        }
+    }
+
+    void invalidate() {
+        m_num_valid = 0;
+    }
+
+    void reset() {
+        m_terms.reset();
+        m_slot.reset();
+        m_code.reset();
+        m_args.reset();
+        m_values.reset();
+        m_changed.reset();
+        m_parents.reset();
+        m_const2slot.reset();
+        m_opaque.reset();
+        m_num_valid = 0;
+        m_roots.reset();
+        m_funcs.reset();
+        m_func2idx.reset();
+        m_func_interps.reset();
+        m_func_changed.reset();
+        m_func_users.reset();
+    }
+};
+
+compiled_model_evaluator::compiled_model_evaluator(ast_manager & m, params_ref const & p) {
+    m_imp = alloc(imp, m, p);
+}
+
+compiled_model_evaluator::~compiled_model_evaluator() {
+    dealloc(m_imp);
+}
+
+ast_manager & compiled_model_evaluator::m() const {
+    return m_imp->m;
+}
+
+void compiled_model_evaluator::updt_params(params_ref const & p) {
+    m_imp->m_params = p;
+    m_imp->invalidate();
+}
+
+void compiled_model_evaluator::set_model_completion(bool f) {
+    if (m_imp->m_completion != f) {
+        m_imp->m_completion = f;
+        m_imp->invalidate();
+    }
+}
+
+unsigned compiled_model_evaluator::compile(expr * t) {
+    return m_imp->compile(t);
+}
+
+unsigned compiled_model_evaluator::get_num_roots() const {
+    return m_imp->m_roots.size();
+}
+
+expr * compiled_model_evaluator::get_root(unsigned idx) const {
+    return m_imp->m_terms.get(m_imp->m_roots[idx]);
+}
+
+unsigned compiled_model_evaluator::get_num_instructions() const {
+    return m_imp->m_code.size();
+}
+
+void compiled_model_evaluator::operator()(model & md) {
+    try {
+        m_imp->operator()(md);
+    }
+    catch (...) {
+        // slots may be partially updated, the next evaluation must recompute them.
+        m_imp->invalidate();
+        throw;
+    }
+}
+
+expr * compiled_model_evaluator::get_value(unsigned idx) const {
+    SASSERT(m_imp->m_roots[idx] < m_imp->m_num_valid);
+    return m_imp->m_values.get(m_imp->m_roots[idx]);
+}
+
+void compiled_model_evaluator::update(model & md, unsigned num_decls, func_decl * const * decls) {
+    try {
+        m_imp->update(md, num_decls, decls);
+    }
+    catch (...) {
+        m_imp->invalidate();
+        throw;
+    }
+}
+
+void compiled_model_evaluator::invalidate() {
+    m_imp->invalidate();
+}
+
+void compiled_model_evaluator::reset() {
+    m_imp->reset();
+}
+
+void compiled_model_evaluator::collect_statistics(statistics & st) const {
+    st.update("compiled eval runs", m_imp->m_stats.m_runs);
+    st.update("compiled eval updates", m_imp->m_stats.m_updates);
+    st.update("compiled eval steps", m_imp->m_stats.m_evals);
+    st.update("compiled eval skipped", m_imp->m_stats.m_skipped);
+}
+
+void compiled_model_evaluator::reset_statistics() {
+    m_imp->m_stats.reset();
+}
@@ -0,0 +1,104 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    compiled_model_evaluator.h
+
+Abstract:
+
+    Evaluate a fixed set of expressions in many models.
+
+    The expressions are compiled once into a tape of instructions,
+    one per subterm, in topological order (arguments before parents).
+    Every instruction has a slot that keeps the value of its subterm
+    in the last evaluated model. When a new model is given, only the
+    instructions that depend on constants (or functions) whose
+    interpretation changed are evaluated again, and an instruction is
+    evaluated by applying its declaration to the values of its
+    arguments (model_evaluator is used for this single step).
+
+    Quantifiers and free variables are not compiled, they are
+    evaluated with model_evaluator every time.
+
+    The evaluator also keeps, for every slot, the instructions using it.
+    After a few symbols are updated in a model, update() evaluates only
+    the cone of the instructions depending on them.
+
+    Remark: the interpretation of a function symbol (arity > 0) is
+    compared using func_interp::get_interp. A func_interp that is
+    updated in place after an evaluation is not detected by operator();
+    update() (with the function) or invalidate() must be used in this case.
+
+Author:
+
+Revision History:
+
+--*/
+#ifndef COMPILED_MODEL_EVALUATOR_H_
+#define COMPILED_MODEL_EVALUATOR_H_
+
+#include"ast.h"
+#include"params.h"
+#include"statistics.h"
+
+class model;
+
+class compiled_model_evaluator {
+    struct imp;
+    imp *  m_imp;
+public:
+    compiled_model_evaluator(ast_manager & m, params_ref const & p = params_ref());
+    ~compiled_model_evaluator();
+
+    ast_manager & m() const;
+
+    void updt_params(params_ref const & p);
+    void set_model_completion(bool f);
+
+    /**
+       \brief Add t to the set of compiled expressions, and return its index.
+    */
+    unsigned compile(expr * t);
+
+    unsigned get_num_roots() const;
+    expr * get_root(unsigned idx) const;
+
+    /**
+       \brief Number of instructions of the tape.
+    */
+    unsigned get_num_instructions() const;
+
+    /**
+       \brief Evaluate the compiled expressions in the given model.
+       The values are available using get_value.
+    */
+    void operator()(model & md);
+
+    /**
+       \brief Update the values after the interpretations of the given constants
+       and functions were modified in md (e.g., using model::register_decl).
+       The interpretations of the other symbols must be the ones of the last
+       evaluation. Only the instructions that depend on the modified symbols
+       are evaluated again, in topological order.
+    */
+    void update(model & md, unsigned num_decls, func_decl * const * decls);
+    void update(model & md, func_decl * d) { update(md, 1, &d); }
+
+    /**
+       \brief Value of the compiled expression idx in the last evaluated model.
+    */
+    expr * get_value(unsigned idx) const;
+
+    /**
+       \brief Force the next evaluation to recompute all instructions.
+    */
+    void invalidate();
+
+    void reset();
+
+    void collect_statistics(statistics & st) const;
+    void reset_statistics();
+};
+
+#endif
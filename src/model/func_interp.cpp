@@ -73,7 +73,8 @@ func_interp::func_interp(ast_manager & m, unsigned arity):
     m_arity(arity),
     m_else(0),
     m_args_are_values(true),
-    m_interp(0) {
+    m_interp(0),
+    m_index_valid(false) {
 }
 
 func_interp::~func_interp() {
@@ -130,12 +131,69 @@ bool func_interp::is_constant() const {
     return true;
 }
 
+unsigned func_interp::hash_args(unsigned arity, expr * const * args) {
+    unsigned h = arity;
+    for (unsigned i = 0; i < arity; i++)
+        h = combine_hash(h, args[i]->get_id());
+    return h;
+}
+
+void func_interp::add_to_index(unsigned idx) const {
+    SASSERT(idx == m_index_prev.size());
+    unsigned h    = hash_args(m_arity, m_entries[idx]->get_args());
+    unsigned prev = UINT_MAX;
+    m_index.find(h, prev);
+    m_index_prev.push_back(prev);
+    m_index.insert(h, idx);
+}
+
+void func_interp::build_index() const {
+    SASSERT(!m_index_valid);
+    m_index.reset();
+    m_index_prev.reset();
+    for (unsigned i = 0; i < m_entries.size(); i++)
+        add_to_index(i);
+    m_index_valid = true;
+}
+
+void func_interp::reset_index() {
+    if (m_index_valid) {
+        m_index.finalize();
+        m_index_prev.finalize();
+        m_index_valid = false;
+    }
+}
+
 /**
    \brief Return a func_entry e such that m().are_equal(e.m_args[i], args[i]) for all i in [0, m_arity).
    If such entry does not exist then return 0, and store set
    args_are_values to true if for all entries e e.args_are_values() is true.
+
+   When all arguments are unique values, m().are_equal(e.m_args[i], args[i]) implies
+   e.m_args[i] == args[i]. In this case, and if there are many entries, the entry is
+   found using the hash index.
 */
 func_entry * func_interp::get_entry(expr * const * args) const {
+    if (m_entries.size() >= INDEX_THRESHOLD) {
+        bool unique_values = true;
+        for (unsigned i = 0; unique_values && i < m_arity; i++)
+            unique_values = m().is_unique_value(args[i]);
+        if (unique_values) {
+            if (!m_index_valid)
+                build_index();
+            unsigned idx;
+            if (!m_index.find(hash_args(m_arity, args), idx))
+                return 0;
+            // return the first matching entry, as the linear search below
+            func_entry * r = 0;
+            for (; idx != UINT_MAX; idx = m_index_prev[idx]) {
+                func_entry * curr = m_entries[idx];
+                if (curr->eq_args(m(), m_arity, args))
+                    r = curr;
+            }
+            return r;
+        }
+    }
     ptr_vector<func_entry>::const_iterator it  = m_entries.begin();
     ptr_vector<func_entry>::const_iterator end = m_entries.end();
     for (; it != end; ++it) {
@@ -175,6 +233,8 @@ void func_interp::insert_new_entry(expr * const * args, expr * r) {
     if (!new_entry->args_are_values())
         m_args_are_values = false;
     m_entries.push_back(new_entry);
+    if (m_index_valid)
+        add_to_index(m_entries.size() - 1);
 }
 
 bool func_interp::eval_else(expr * const * args, expr_ref & result) const {
@@ -238,6 +298,7 @@ void func_interp::compress() {
     }
     if (j < sz) {
         reset_interp_cache();
+        reset_index();
         m_entries.shrink(j);
     }
 }
@@ -32,6 +32,7 @@ Revision History:
 
 #include"ast.h"
 #include"ast_translation.h"
+#include"map.h"
 
 class func_interp;
 
@@ -72,6 +73,20 @@ class func_interp {
     
     expr *                 m_interp; //!< cache for representing the whole interpretation as a single expression (it uses ite terms).
 
+    // Hash index over the arguments of the entries. It is built by get_entry when the
+    // number of entries reaches INDEX_THRESHOLD. m_index maps the hash of the arguments
+    // to the position of the last entry with this hash, and m_index_prev[i] is the position
+    // of the previous entry with the same hash as entry i (UINT_MAX if there is none).
+    static const unsigned  INDEX_THRESHOLD = 16;
+    mutable u_map<unsigned> m_index;
+    mutable unsigned_vector m_index_prev;
+    mutable bool           m_index_valid;
+
+    static unsigned hash_args(unsigned arity, expr * const * args);
+    void add_to_index(unsigned idx) const;
+    void build_index() const;
+    void reset_index();
+
     void reset_interp_cache();
 
     expr * get_interp_core() const;
@@ -231,7 +231,6 @@ namespace nlsat {
            \brief Wrapper for psc chain computation
         */
         void psc_chain(polynomial_ref & p, polynomial_ref & q, unsigned x, polynomial_ref_vector & result) {
-            // TODO caching
             SASSERT(max_var(p) == max_var(q));
             SASSERT(max_var(p) == x);
             m_cache.psc_chain(p, q, x, result);
@@ -0,0 +1,418 @@
+/*++
+Copyright (c) 2012 Microsoft Corporation
+
+Module Name:
+
+    nlsat_icp.cpp
+
+Abstract:
+
+    Interval constraint propagation pre-phase for nlsat.
+
+Author:
+
+Revision History:
+
+--*/
+#include"nlsat_icp.h"
+#include"subpaving_mpff.h"
+#include"map.h"
+#include"nlsat_params.hpp"
+
+namespace nlsat {
+
+    struct icp::imp {
+        // Bounds are kept as mpff numerals. Rational bounds may grow without
+        // limit during propagation, and rounding is sound since the
+        // subpaving rounds bounds outwards.
+        typedef subpaving::context_mpff context;
+        typedef context::ineq          ineq;
+        typedef context::node          node;
+        typedef subpaving::power       power;
+        typedef subpaving::var         svar;
+
+        reslimit &               m_limit;
+        pmanager &               m_pm;
+        atom_vector const &      m_atoms;
+        unsynch_mpq_manager &    m_qm;
+        mpff_manager             m_fm;
+        params_ref               m_params;
+        scoped_ptr<context>      m_ctx;
+        u_map<svar>              m_poly2var;
+        u_map<svar>              m_mono2var;
+        ptr_vector<ineq>         m_ineqs;
+        svector<power>           m_pws;
+        scoped_mpq_vector        m_lowers;
+        scoped_mpq_vector        m_uppers;
+        svector<char>            m_lower_kind; // 0 - none, 1 - closed, 2 - open
+        svector<char>            m_upper_kind;
+        scoped_mpq_vector        m_points;
+        unsigned                 m_num_vars;
+        unsigned                 m_max_points;
+
+        // statistics
+        unsigned                 m_num_runs;
+        unsigned                 m_num_encoded;
+        unsigned                 m_num_ignored;
+        unsigned                 m_num_leaves;
+        unsigned                 m_num_failures;
+
+        imp(reslimit & lim, unsynch_mpq_manager & qm, pmanager & pm, atom_vector const & atoms):
+            m_limit(lim),
+            m_pm(pm),
+            m_atoms(atoms),
+            m_qm(qm),
+            m_lowers(m_qm),
+            m_uppers(m_qm),
+            m_points(m_qm),
+            m_num_vars(0),
+            m_max_points(16) {
+            reset_statistics();
+        }
+
+        void reset_statistics() {
+            m_num_runs     = 0;
+            m_num_encoded  = 0;
+            m_num_ignored  = 0;
+            m_num_leaves   = 0;
+            m_num_failures = 0;
+        }
+
+        void collect_statistics(statistics & st) const {
+            st.update("nlsat icp runs", m_num_runs);
+            st.update("nlsat icp encoded clauses", m_num_encoded);
+            st.update("nlsat icp ignored clauses", m_num_ignored);
+            st.update("nlsat icp leaves", m_num_leaves);
+            st.update("nlsat icp failures", m_num_failures);
+        }
+
+        void updt_params(params_ref const & _p) {
+            nlsat_params p(_p);
+            m_params.set_uint("max_nodes", p.icp_max_nodes());
+            m_params.set_uint("max_depth", p.icp_max_depth());
+            m_max_points = p.icp_max_models();
+        }
+
+        svar mk_monomial(polynomial::monomial * m) {
+            unsigned sz = m_pm.size(m);
+            SASSERT(sz > 0);
+            if (sz == 1 && m_pm.degree(m, 0) == 1)
+                return m_pm.get_var(m, 0);
+            svar r;
+            if (m_mono2var.find(m_pm.id(m), r))
+                return r;
+            m_pws.reset();
+            for (unsigned i = 0; i < sz; i++)
+                m_pws.push_back(power(m_pm.get_var(m, i), m_pm.degree(m, i)));
+            r = m_ctx->mk_monomial(m_pws.size(), m_pws.c_ptr());
+            m_mono2var.insert(m_pm.id(m), r);
+            return r;
+        }
+
+        // Store a in o. Return false if a cannot be represented precisely.
+        bool int2mpff(mpz const & a, mpff & o) {
+            try {
+                scoped_mpz b(m_qm);
+                m_fm.set(o, m_qm, a);
+                m_fm.to_mpz(o, m_qm, b);
+                return m_qm.eq(a, b);
+            }
+            catch (mpff_manager::exception) {
+                return false;
+            }
+        }
+
+        // Return a subpaving variable y s.t. y = p, or null_var if p is a constant
+        // or one of its coefficients cannot be represented precisely.
+        svar mk_poly(poly * p) {
+            svar r;
+            if (m_poly2var.find(m_pm.id(p), r))
+                return r;
+            unsigned sz = m_pm.size(p);
+            _scoped_numeral<mpff_manager> c(m_fm);
+            _scoped_numeral_vector<mpff_manager> as(m_fm);
+            svector<svar> xs;
+            for (unsigned i = 0; i < sz; i++) {
+                polynomial::monomial * m = m_pm.get_monomial(p, i);
+                if (m_pm.size(m) == 0) {
+                    if (!int2mpff(m_pm.coeff(p, i), c))
+                        return subpaving::null_var;
+                    continue;
+                }
+                as.push_back(mpff());
+                if (!int2mpff(m_pm.coeff(p, i), as.back()))
+                    return subpaving::null_var;
+                xs.push_back(mk_monomial(m));
+            }
+            if (xs.empty())
+                return subpaving::null_var;
+            if (xs.size() == 1 && m_fm.is_one(as[0]) && m_fm.is_zero(c))
+                r = xs[0];
+            else
+                r = m_ctx->mk_sum(c, xs.size(), as.c_ptr(), xs.c_ptr());
+            m_poly2var.insert(m_pm.id(p), r);
+            return r;
+        }
+
+        // Return a subpaving variable y s.t. y is the product of the factors of a.
+        svar mk_product(ineq_atom const * a) {
+            if (a->size() == 1 && !a->is_even(0))
+                return mk_poly(a->p(0));
+            // m_pws is used by mk_poly
+            svector<power> pws;
+            for (unsigned i = 0; i < a->size(); i++) {
+                svar y = mk_poly(a->p(i));
+                if (y == subpaving::null_var)
+                    return y;
+                pws.push_back(power(y, a->is_even(i) ? 2 : 1));
+            }
+            return m_ctx->mk_monomial(pws.size(), pws.c_ptr());
+        }
+
+        void push_ineq(svar y, bool lower, bool open) {
+            _scoped_numeral<mpff_manager> zero(m_fm);
+            ineq * i = m_ctx->mk_ineq(y, zero, lower, open);
+            m_ctx->inc_ref(i);
+            m_ineqs.push_back(i);
+        }
+
+        void reset_ineqs() {
+            for (unsigned i = 0; i < m_ineqs.size(); i++)
+                m_ctx->dec_ref(m_ineqs[i]);
+            m_ineqs.reset();
+        }
+
+        // Append the inequalities for l to m_ineqs. Return false if l cannot be encoded.
+        bool encode(literal l, bool unit) {
+            atom * a = m_atoms.get(l.var(), 0);
+            if (a == 0 || !a->is_ineq_atom())
+                return false;
+            svar y = mk_product(to_ineq_atom(a));
+            if (y == subpaving::null_var)
+                return false;
+            switch (a->get_kind()) {
+            case atom::LT: 
+                push_ineq(y, l.sign(), !l.sign());  // y < 0 or y >= 0
+                return true;
+            case atom::GT: 
+                push_ineq(y, !l.sign(), !l.sign()); // y > 0 or y <= 0
+                return true;
+            case atom::EQ:
+                if (l.sign() || !unit)
+                    return false;
+                push_ineq(y, true, false);
+                push_ineq(y, false, false);
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        void encode(clause const & c) {
+            SASSERT(m_ineqs.empty());
+            unsigned sz = c.size();
+            for (unsigned i = 0; i < sz; i++) {
+                if (c[i] == true_literal || !encode(c[i], sz == 1)) {
+                    reset_ineqs();
+                    m_num_ignored++;
+                    return;
+                }
+            }
+            if (sz == 1) {
+                for (unsigned i = 0; i < m_ineqs.size(); i++)
+                    m_ctx->add_clause(1, m_ineqs.c_ptr() + i);
+            }
+            else {
+                m_ctx->add_clause(m_ineqs.size(), m_ineqs.c_ptr());
+            }
+            reset_ineqs();
+            m_num_encoded++;
+        }
+
+        void reset() {
+            m_poly2var.reset();
+            m_mono2var.reset();
+            m_lowers.reset();
+            m_uppers.reset();
+            m_lower_kind.reset();
+            m_upper_kind.reset();
+            m_points.reset();
+            m_ctx = 0;
+        }
+
+        // Store in r the weakest lower (upper) bound of x in the given leaves.
+        // Return 0 if x is unbounded in some leaf, 1 if the bound is closed, and 2 if it is open.
+        char mk_hull(ptr_vector<node> const & leaves, var x, bool lower, mpq & r) {
+            bool open = false;
+            scoped_mpq v(m_qm);
+            for (unsigned j = 0; j < leaves.size(); j++) {
+                context::bound * b = lower ? leaves[j]->lower(x) : leaves[j]->upper(x);
+                if (b == 0)
+                    return 0;
+                m_fm.to_mpq(b->value(), m_qm, v);
+                if (j == 0 || (lower ? m_qm.lt(v, r) : m_qm.gt(v, r))) {
+                    m_qm.set(r, v);
+                    open = b->is_open();
+                }
+                else if (m_qm.eq(v, r) && !b->is_open()) {
+                    open = false;
+                }
+            }
+            return open ? 2 : 1;
+        }
+
+        void mk_hull(ptr_vector<node> const & leaves) {
+            for (unsigned x = 0; x < m_num_vars; x++) {
+                m_lowers.push_back(mpq());
+                m_uppers.push_back(mpq());
+                m_lower_kind.push_back(mk_hull(leaves, x, true, m_lowers.back()));
+                m_upper_kind.push_back(mk_hull(leaves, x, false, m_uppers.back()));
+            }
+        }
+
+        // Store a point of the box n in m_points.
+        void mk_point(node * n, svector<bool> const & is_int) {
+            scoped_mpq v(m_qm), w(m_qm);
+            for (unsigned x = 0; x < m_num_vars; x++) {
+                context::bound * l = n->lower(x);
+                context::bound * u = n->upper(x);
+                if (l != 0 && u != 0) {
+                    m_fm.to_mpq(l->value(), m_qm, v);
+                    m_fm.to_mpq(u->value(), m_qm, w);
+                    m_qm.add(v, w, v);
+                    m_qm.div(v, mpq(2), v);
+                }
+                else if (l != 0) {
+                    m_fm.to_mpq(l->value(), m_qm, v);
+                    if (l->is_open())
+                        m_qm.inc(v);
+                }
+                else if (u != 0) {
+                    m_fm.to_mpq(u->value(), m_qm, v);
+                    if (u->is_open())
+                        m_qm.dec(v);
+                }
+                else {
+                    m_qm.reset(v);
+                }
+                if (is_int[x] && !m_qm.is_int(v)) {
+                    if (l != 0)
+                        m_qm.ceil(v, v);
+                    else
+                        m_qm.floor(v, v);
+                }
+                m_points.push_back(mpq());
+                m_qm.set(m_points.back(), v);
+            }
+        }
+
+        lbool operator()(unsigned num_vars, svector<bool> const & is_int, clause_vector const & cs) {
+            reset();
+            m_num_runs++;
+            m_num_vars = num_vars;
+            m_ctx = alloc(context, m_limit, subpaving::config_mpff(m_fm), m_params, 0);
+            for (unsigned x = 0; x < num_vars; x++)
+                m_ctx->mk_var(is_int[x]);
+            try {
+                for (unsigned i = 0; i < cs.size(); i++)
+                    encode(*(cs[i]));
+                (*m_ctx)();
+            }
+            catch (subpaving::exception) {
+                TRACE("nlsat_icp", tout << "subpaving failed\n";);
+                m_num_failures++;
+                reset_ineqs();
+                reset();
+                return l_undef;
+            }
+            catch (mpff_manager::exception) {
+                TRACE("nlsat_icp", tout << "mpff failure\n";);
+                m_num_failures++;
+                reset_ineqs();
+                reset();
+                return l_undef;
+            }
+            if (m_ctx->arith_failed()) {
+                TRACE("nlsat_icp", tout << "arithmetic failure in subpaving\n";);
+                m_num_failures++;
+                reset();
+                return l_undef;
+            }
+            ptr_vector<node> leaves;
+            m_ctx->collect_leaves(leaves);
+            m_num_leaves += leaves.size();
+            TRACE("nlsat_icp", tout << "feasible leaves: " << leaves.size() << "\n"; m_ctx->display_bounds(tout););
+            if (leaves.empty())
+                return l_false;
+            mk_hull(leaves);
+            for (unsigned i = 0; i < leaves.size() && i < m_max_points; i++)
+                mk_point(leaves[i], is_int);
+            return l_undef;
+        }
+
+        bool lower(var x, mpq & k, bool & open) const {
+            if (x >= m_lower_kind.size() || m_lower_kind[x] == 0)
+                return false;
+            m_qm.set(k, m_lowers[x]);
+            open = m_lower_kind[x] == 2;
+            return true;
+        }
+
+        bool upper(var x, mpq & k, bool & open) const {
+            if (x >= m_upper_kind.size() || m_upper_kind[x] == 0)
+                return false;
+            m_qm.set(k, m_uppers[x]);
+            open = m_upper_kind[x] == 2;
+            return true;
+        }
+
+        unsigned num_points() const {
+            return m_num_vars == 0 ? 0 : m_points.size() / m_num_vars;
+        }
+
+        mpq const & point(unsigned i, var x) const {
+            return m_points[i * m_num_vars + x];
+        }
+    };
+
+    icp::icp(reslimit & lim, unsynch_mpq_manager & qm, pmanager & pm, atom_vector const & atoms) {
+        m_imp = alloc(imp, lim, qm, pm, atoms);
+    }
+
+    icp::~icp() {
+        dealloc(m_imp);
+    }
+
+    void icp::updt_params(params_ref const & p) {
+        m_imp->updt_params(p);
+    }
+
+    lbool icp::operator()(unsigned num_vars, svector<bool> const & is_int, clause_vector const & cs) {
+        return (*m_imp)(num_vars, is_int, cs);
+    }
+
+    bool icp::lower(var x, mpq & k, bool & open) const {
+        return m_imp->lower(x, k, open);
+    }
+
+    bool icp::upper(var x, mpq & k, bool & open) const {
+        return m_imp->upper(x, k, open);
+    }
+
+    unsigned icp::num_points() const {
+        return m_imp->num_points();
+    }
+
+    mpq const & icp::point(unsigned i, var x) const {
+        return m_imp->point(i, x);
+    }
+
+    void icp::collect_statistics(statistics & st) const {
+        m_imp->collect_statistics(st);
+    }
+
+    void icp::reset_statistics() {
+        m_imp->reset_statistics();
+    }
+
+};
@@ -0,0 +1,76 @@
+/*++
+Copyright (c) 2012 Microsoft Corporation
+
+Module Name:
+
+    nlsat_icp.h
+
+Abstract:
+
+    Interval constraint propagation pre-phase for nlsat.
+    The clauses of the solver are encoded as a subpaving problem,
+    the variable domains are contracted, and the leaves of the
+    subpaving tree are used to detect infeasibility and to produce
+    candidate models.
+
+Author:
+
+Revision History:
+
+--*/
+#ifndef NLSAT_ICP_H_
+#define NLSAT_ICP_H_
+
+#include"nlsat_types.h"
+#include"nlsat_clause.h"
+#include"params.h"
+#include"statistics.h"
+#include"rlimit.h"
+
+namespace nlsat {
+
+    class icp {
+        struct imp;
+        imp *  m_imp;
+    public:
+        icp(reslimit & lim, unsynch_mpq_manager & qm, pmanager & pm, atom_vector const & atoms);
+        ~icp();
+
+        void updt_params(params_ref const & p);
+
+        /**
+           \brief Run interval constraint propagation on the given clauses.
+
+           A clause is encoded only if all its literals are of the form p > 0, p < 0, p >= 0, p <= 0,
+           or if it is a unit clause p = 0. Other clauses are ignored, so the encoding is an
+           over-approximation of the clauses.
+
+           Return l_false if the clauses are infeasible, and l_undef otherwise.
+           In the latter case, lower/upper return the hull of the bounds in the
+           feasible leaves, and point returns candidate models taken from these leaves.
+        */
+        lbool operator()(unsigned num_vars, svector<bool> const & is_int, clause_vector const & cs);
+
+        /**
+           \brief Return true if x has a lower bound (k, open) after the last execution.
+        */
+        bool lower(var x, mpq & k, bool & open) const;
+        bool upper(var x, mpq & k, bool & open) const;
+
+        /**
+           \brief Number of candidate models produced by the last execution.
+        */
+        unsigned num_points() const;
+
+        /**
+           \brief Value of x in the i-th candidate model.
+        */
+        mpq const & point(unsigned i, var x) const;
+
+        void collect_statistics(statistics & st) const;
+        void reset_statistics();
+    };
+
+};
+
+#endif
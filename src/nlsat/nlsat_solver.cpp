@@ -24,6 +24,7 @@ Revision History:
 #include"nlsat_justification.h"
 #include"nlsat_evaluator.h"
 #include"nlsat_explain.h"
+#include"nlsat_icp.h"
 #include"algebraic_numbers.h"
 #include"z3_exception.h"
 #include"chashtable.h"
@@ -119,6 +120,13 @@ namespace nlsat {
         perm_display_var_proc  m_display_var;
 
         explain                m_explain;
+        icp                    m_icp;
+        unsigned               m_icp_num_clauses; // number of clauses when icp was executed
+        bool                   m_icp_assignment;  // true if m_assignment contains a model produced by icp
+
+        // user scopes: the clauses created in a scope depend on the assumption m_scope_values[lvl].
+        svector<assumption>    m_scope_values;
+        ptr_vector<assumption_manager::dependency> m_scope_deps;
 
         bool_var               m_bk;       // current Boolean variable we are processing
         var                    m_xk;       // current arith variable we are processing
@@ -151,6 +159,7 @@ namespace nlsat {
         bool                   m_random_order;
         unsigned               m_random_seed;
         unsigned               m_max_conflicts;
+        bool                   m_use_icp;
 
         // statistics
         unsigned               m_conflicts;
@@ -158,6 +167,9 @@ namespace nlsat {
         unsigned               m_decisions;
         unsigned               m_stages;
         unsigned               m_irrational_assignments; // number of irrational witnesses
+        unsigned               m_icp_conflicts;
+        unsigned               m_icp_models;
+        unsigned               m_icp_bounds;
 
         imp(solver & s, reslimit& rlim, params_ref const & p):
             m_solver(s),
@@ -173,6 +185,9 @@ namespace nlsat {
             m_num_bool_vars(0),
             m_display_var(m_perm),
             m_explain(s, m_assignment, m_cache, m_atoms, m_var2eq, m_evaluator),
+            m_icp(rlim, m_qm, m_pm, m_atoms),
+            m_icp_num_clauses(0),
+            m_icp_assignment(false),
             m_scope_lvl(0),
             m_lemma(s),
             m_lazy_clause(s),
@@ -188,6 +203,7 @@ namespace nlsat {
             m_lazy_clause.reset();
             undo_until_size(0);
             del_clauses();
+            del_scopes(0);
             del_unref_atoms();
         }
 
@@ -213,6 +229,10 @@ namespace nlsat {
             m_explain.set_simplify_cores(m_simplify_cores);
             m_explain.set_minimize_cores(min_cores);
             m_explain.set_factor(p.factor());
+            m_pm.set_use_modular_psc(p.modular_psc());
+            m_cache.set_max_entries(p.projection_cache_size());
+            m_use_icp        = p.icp();
+            m_icp.updt_params(p.p);
             m_am.updt_params(p.p);
         }
 
@@ -657,6 +677,8 @@ namespace nlsat {
             _assumption_set as = 0;
             if (a != 0)
                 as = m_asm.mk_leaf(a);
+            if (!m_scope_deps.empty())
+                as = m_asm.mk_join(as, m_scope_deps.back());
             mk_clause(num_lits, lits, false, as);
         }
 
@@ -1183,10 +1205,207 @@ namespace nlsat {
             }
         }
 
+        // -----------------------
+        //
+        // Interval constraint propagation
+        //
+        // -----------------------
+
+        void reset_icp_assignment() {
+            if (!m_icp_assignment)
+                return;
+            for (var x = 0; x < num_vars(); x++)
+                m_assignment.reset(x);
+            m_icp_assignment = false;
+        }
+
+        /**
+           \brief Return true if every clause is satisfied by the i-th candidate model produced by icp.
+           If that is the case, the model is stored in m_assignment.
+        */
+        bool check_icp_model(unsigned i) {
+            scoped_anum v(m_am);
+            for (var x = 0; x < num_vars(); x++) {
+                m_am.set(v, m_icp.point(i, x));
+                m_assignment.set(x, v);
+            }
+            m_icp_assignment = true;
+            for (unsigned j = 0; j < m_clauses.size(); j++) {
+                clause const & c = *(m_clauses[j]);
+                bool sat = false;
+                for (unsigned k = 0; !sat && k < c.size(); k++) {
+                    literal l = c[k];
+                    if (l == true_literal)
+                        sat = true;
+                    else if (m_atoms[l.var()] != 0)
+                        sat = m_evaluator.eval(m_atoms[l.var()], l.sign());
+                }
+                if (!sat) {
+                    reset_icp_assignment();
+                    return false;
+                }
+            }
+            TRACE("nlsat_icp", tout << "icp model\n"; display_assignment(tout););
+            return true;
+        }
+
+        // Add the unit clause q*x - p >= 0, q*x - p > 0, q*x - p <= 0 or q*x - p < 0 for the bound k = p/q.
+        void mk_icp_bound(var x, mpq const & k, bool lower, bool open, _assumption_set as) {
+            scoped_mpz a(m_qm), c(m_qm);
+            m_qm.set(a, k.denominator());
+            m_qm.set(c, k.numerator());
+            m_qm.neg(c);
+            polynomial_ref p(m_pm);
+            p = m_pm.mk_linear(1, &a.get(), &x, c.get());
+            poly * ps[1]  = { p.get() };
+            bool is_even[1] = { false };
+            literal l;
+            if (lower)
+                l = open ? mk_ineq_literal(atom::GT, 1, ps, is_even) : ~mk_ineq_literal(atom::LT, 1, ps, is_even);
+            else
+                l = open ? mk_ineq_literal(atom::LT, 1, ps, is_even) : ~mk_ineq_literal(atom::GT, 1, ps, is_even);
+            TRACE("nlsat_icp", tout << "icp bound: "; display(tout, l); tout << "\n";);
+            mk_clause(1, &l, false, as);
+            m_icp_bounds++;
+        }
+
+        /**
+           \brief Interval constraint propagation pre-phase.
+           Return l_false if icp showed the clauses are infeasible, l_true if it found a model, 
+           and l_undef otherwise. In the last case, the contracted bounds are added as unit clauses.
+        */
+        lbool run_icp() {
+            // icp is only used before the search starts
+            if (!m_trail.empty() || m_clauses.size() == m_icp_num_clauses)
+                return l_undef;
+            // the result depends on all clauses.
+            _assumption_set as = 0;
+            for (unsigned i = 0; i < m_clauses.size(); i++)
+                as = m_asm.mk_join(as, static_cast<_assumption_set>(m_clauses[i]->assumptions()));
+            lbool r = m_icp(num_vars(), m_is_int, m_clauses);
+            if (r == l_false) {
+                TRACE("nlsat_icp", tout << "icp: infeasible\n";);
+                m_icp_conflicts++;
+                m_lemma_assumptions = as;
+                return l_false;
+            }
+            for (unsigned i = 0; i < m_icp.num_points(); i++) {
+                if (check_icp_model(i)) {
+                    m_icp_models++;
+                    return l_true;
+                }
+            }
+            scoped_mpq k(m_qm);
+            bool open;
+            for (var x = 0; x < num_vars(); x++) {
+                if (m_icp.lower(x, k, open))
+                    mk_icp_bound(x, k, true, open, as);
+                if (m_icp.upper(x, k, open))
+                    mk_icp_bound(x, k, false, open, as);
+            }
+            m_icp_num_clauses = m_clauses.size();
+            return l_undef;
+        }
+
+        // -----------------------
+        //
+        // User scopes
+        //
+        // -----------------------
+
+        /**
+           \brief Undo the assignment produced by the last call to check.
+        */
+        void reset_search() {
+            undo_until_size(0);
+            SASSERT(m_xk == null_var || m_trail.empty());
+            m_xk = null_var;
+            for (var x = 0; x < num_vars(); x++)
+                m_assignment.reset(x);
+            m_icp_assignment = false;
+        }
+
+        void push() {
+            reset_search();
+            assumption v = m_allocator.allocate(sizeof(unsigned));
+            _assumption_set d = m_asm.mk_leaf(v);
+            inc_ref(d);
+            m_scope_values.push_back(v);
+            m_scope_deps.push_back(d);
+        }
+
+        /**
+           \brief Return true if a depends on a scope at level >= lvl.
+        */
+        bool depends_on_scopes(_assumption_set a, unsigned lvl) {
+            if (a == 0)
+                return false;
+            for (unsigned i = lvl; i < m_scope_values.size(); i++) {
+                if (m_asm.contains(a, m_scope_values[i]))
+                    return true;
+            }
+            return false;
+        }
+
+        void del_scoped_clauses(clause_vector & cs, unsigned lvl) {
+            unsigned j  = 0;
+            unsigned sz = cs.size();
+            for (unsigned i = 0; i < sz; i++) {
+                clause * c = cs[i];
+                if (depends_on_scopes(static_cast<_assumption_set>(c->assumptions()), lvl))
+                    del_clause(c);
+                else
+                    cs[j++] = c;
+            }
+            cs.shrink(j);
+        }
+
+        void del_scopes(unsigned lvl) {
+            for (unsigned i = lvl; i < m_scope_values.size(); i++) {
+                dec_ref(m_scope_deps[i]);
+                m_allocator.deallocate(sizeof(unsigned), m_scope_values[i]);
+            }
+            m_scope_values.shrink(lvl);
+            m_scope_deps.shrink(lvl);
+        }
+
+        /**
+           \brief Remove the clauses created in the last num_scopes scopes, and the
+           learned clauses that depend on them. Other learned clauses, atoms and
+           polynomials are preserved.
+        */
+        void pop(unsigned num_scopes) {
+            SASSERT(num_scopes <= m_scope_values.size());
+            reset_search();
+            m_lemma_assumptions = 0;
+            unsigned new_lvl = m_scope_values.size() - num_scopes;
+            del_scoped_clauses(m_clauses, new_lvl);
+            del_scoped_clauses(m_learned, new_lvl);
+            del_scopes(new_lvl);
+            m_icp_num_clauses = 0;
+        }
+
+        void get_core(vector<assumption, false> & deps) {
+            deps.reset();
+            if (m_lemma_assumptions.get() == 0)
+                return;
+            vector<assumption, false> vs;
+            m_asm.linearize(m_lemma_assumptions.get(), vs);
+            for (unsigned i = 0; i < vs.size(); i++) {
+                if (!m_scope_values.contains(vs[i]))
+                    deps.push_back(vs[i]);
+            }
+        }
+
         lbool check() {
             TRACE("nlsat_smt2", display_smt2(tout););
             TRACE("nlsat_fd", tout << "is_full_dimensional: " << is_full_dimensional() << "\n";);
-            m_xk = null_var;
+            reset_search();
+            if (m_use_icp) {
+                lbool r = run_icp();
+                if (r != l_undef)
+                    return r;
+            }
             m_explain.set_full_dimensional(is_full_dimensional());
             if (m_random_order) {
                 shuffle_vars();
@@ -1670,6 +1889,11 @@ namespace nlsat {
             st.update("nlsat decisions", m_decisions);
             st.update("nlsat stages", m_stages);
             st.update("nlsat irrational assignments", m_irrational_assignments);
+            st.update("nlsat icp conflicts", m_icp_conflicts);
+            st.update("nlsat icp models", m_icp_models);
+            st.update("nlsat icp bounds", m_icp_bounds);
+            m_icp.collect_statistics(st);
+            m_cache.collect_statistics(st);
         }
 
         void reset_statistics() {
@@ -1678,6 +1902,11 @@ namespace nlsat {
             m_decisions              = 0;
             m_stages                 = 0;
             m_irrational_assignments = 0;
+            m_icp_conflicts          = 0;
+            m_icp_models             = 0;
+            m_icp_bounds             = 0;
+            m_icp.reset_statistics();
+            m_cache.reset_statistics();
         }
 
         // -----------------------
@@ -2562,6 +2791,10 @@ namespace nlsat {
         return m_imp->check();
     }
 
+    void solver::updt_params(params_ref const & p) {
+        m_imp->updt_params(p);
+    }
+
     void solver::collect_param_descrs(param_descrs & d) {
         algebraic_numbers::manager::collect_param_descrs(d);
         nlsat_params::collect_param_descrs(d);
@@ -2623,6 +2856,22 @@ namespace nlsat {
         return m_imp->mk_clause(num_lits, lits, a);
     }
 
+    void solver::push() {
+        m_imp->push();
+    }
+
+    void solver::pop(unsigned num_scopes) {
+        m_imp->pop(num_scopes);
+    }
+
+    unsigned solver::num_scopes() const {
+        return m_imp->m_scope_values.size();
+    }
+
+    void solver::get_core(vector<assumption, false> & deps) {
+        m_imp->get_core(deps);
+    }
+
     void solver::display(std::ostream & out) const {
         m_imp->display(out);
     }
@@ -2661,7 +2910,7 @@ namespace nlsat {
         return m_imp->reset_statistics();
     }
 
-    void solver::collect_statistics(statistics & st) {
+    void solver::collect_statistics(statistics & st) const {
         return m_imp->collect_statistics(st);
     }
 
@@ -128,6 +128,24 @@ namespace nlsat {
 
         bool is_int(var x) const;
 
+        // -----------------------
+        //
+        // Scopes
+        //
+        // -----------------------
+
+        /**
+           \brief Create a backtracking point. The clauses created after push are
+           removed by the matching pop.
+
+           Variables, atoms, polynomials and the caches of the polynomial manager
+           are preserved across scopes. Learned clauses are preserved by pop
+           unless they were derived from clauses of the popped scopes.
+        */
+        void push();
+        void pop(unsigned num_scopes);
+        unsigned num_scopes() const;
+
         // -----------------------
         //
         // Search
@@ -135,6 +153,12 @@ namespace nlsat {
         // -----------------------
         lbool check();
 
+        /**
+           \brief Store in deps the assumptions of the clauses used to derive
+           the last conflict. Only meaningful after check() returns l_false.
+        */
+        void get_core(vector<assumption, false> & deps);
+
         // -----------------------
         //
         // Model
@@ -154,7 +178,7 @@ namespace nlsat {
         void updt_params(params_ref const & p);
         static void collect_param_descrs(param_descrs & d);
 
-        void collect_statistics(statistics & st);
+        void collect_statistics(statistics & st) const;
         void reset_statistics();
         void display_status(std::ostream & out) const;
 
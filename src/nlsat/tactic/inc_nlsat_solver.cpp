@@ -0,0 +1,444 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    inc_nlsat_solver.cpp
+
+Abstract:
+
+    incremental solver based on the nlsat core.
+
+    Assertions are preprocessed with tactics that do not eliminate
+    variables, and then compiled into the nlsat engine in the scope
+    where they were asserted. Pop removes the clauses of the popped
+    scopes, but the polynomials, atoms, and learned clauses that do
+    not depend on them are preserved.
+
+    Assumptions are compiled into a temporary scope that is removed
+    after each call to check_sat.
+
+Author:
+
+Notes:
+
+--*/
+#include"solver.h"
+#include"tactical.h"
+#include"nlsat_solver.h"
+#include"goal2nlsat.h"
+#include"expr2var.h"
+#include"model.h"
+#include"arith_decl_plugin.h"
+#include"simplify_tactic.h"
+#include"purify_arith_tactic.h"
+#include"elim_term_ite_tactic.h"
+#include"factor_tactic.h"
+#include"tseitin_cnf_tactic.h"
+#include"algebraic_numbers.h"
+#include"ast_translation.h"
+#include"ast_pp.h"
+#include"z3_exception.h"
+#include"inc_nlsat_solver.h"
+
+class inc_nlsat_solver : public solver {
+    ast_manager&               m;
+    params_ref                 m_params;
+    nlsat::solver              m_solver;
+    goal2nlsat                 m_goal2nlsat;
+    expr2var                   m_a2b;
+    expr2var                   m_t2x;
+    expr_ref_vector            m_fmls;
+    expr_ref_vector            m_asmsf;
+    unsigned_vector            m_fmls_lim;
+    unsigned_vector            m_asms_lim;
+    unsigned_vector            m_fmls_head_lim;
+    unsigned                   m_fmls_head;
+    model_converter_ref        m_mc;
+    model_converter_ref_vector m_mc_lim;
+    tactic_ref                 m_preprocess;
+    expr_dependency_ref_vector m_deps;  // dependencies used as nlsat assumptions.
+    expr_ref_vector            m_core;
+    model_ref                  m_model;
+    std::string                m_unknown;
+    unsigned                   m_num_scopes;
+
+public:
+    inc_nlsat_solver(ast_manager& m, params_ref const& p):
+        m(m),
+        m_params(p),
+        m_solver(m.limit(), p),
+        m_a2b(m),
+        m_t2x(m),
+        m_fmls(m),
+        m_asmsf(m),
+        m_fmls_head(0),
+        m_deps(m),
+        m_core(m),
+        m_unknown("no reason given"),
+        m_num_scopes(0) {
+        params_ref main_p = p;
+        main_p.set_bool("elim_and", true);
+        main_p.set_bool("blast_distinct", true);
+        params_ref purify_p = p;
+        purify_p.set_bool("complete", false);
+        tactic * factor;
+        if (p.get_bool("factor", true))
+            factor = mk_factor_tactic(m, p);
+        else
+            factor = mk_skip_tactic();
+        // Variable eliminating tactics (solve-eqs, elim-uncnstr) are not used,
+        // since the eliminated variables may occur in later assertions.
+        m_preprocess =
+            and_then(using_params(mk_simplify_tactic(m, p), main_p),
+                     using_params(mk_purify_arith_tactic(m, p), purify_p),
+                     mk_elim_term_ite_tactic(m, p),
+                     factor,
+                     using_params(mk_simplify_tactic(m, p), main_p),
+                     mk_tseitin_cnf_core_tactic(m, p),
+                     using_params(mk_simplify_tactic(m, p), main_p));
+    }
+
+    virtual ~inc_nlsat_solver() {}
+
+    virtual solver* translate(ast_manager& dst_m, params_ref const& p) {
+        if (m_num_scopes > 0) {
+            throw default_exception("Cannot translate nlsat solver at non-base level");
+        }
+        ast_translation tr(m, dst_m);
+        inc_nlsat_solver* result = alloc(inc_nlsat_solver, dst_m, p);
+        expr_ref fml(dst_m);
+        for (unsigned i = 0; i < m_fmls.size(); ++i) {
+            fml = tr(m_fmls[i].get());
+            result->m_fmls.push_back(fml);
+        }
+        for (unsigned i = 0; i < m_asmsf.size(); ++i) {
+            fml = tr(m_asmsf[i].get());
+            result->m_asmsf.push_back(fml);
+        }
+        return result;
+    }
+
+    virtual void set_progress_callback(progress_callback * callback) {}
+
+    virtual lbool check_sat(unsigned sz, expr * const * assumptions) {
+        m_model = 0;
+        m_core.reset();
+        m_unknown = "no reason given";
+        lbool r = internalize_formulas();
+        if (r != l_true)
+            return r;
+        model_converter_ref asm_mc;
+        m_solver.push();
+        m_a2b.push();
+        m_t2x.push();
+        try {
+            // the literals tracking assertions are also assumed.
+            ptr_vector<expr> asms;
+            asms.append(m_asmsf.size(), m_asmsf.c_ptr());
+            asms.append(sz, assumptions);
+            r = internalize_assumptions(asms.size(), asms.c_ptr(), asm_mc);
+            if (r == l_true) {
+                r = m_solver.check();
+                switch (r) {
+                case l_true:
+                    if (!extract_model(asm_mc.get()))
+                        r = l_undef;
+                    break;
+                case l_false:
+                    extract_core();
+                    break;
+                default:
+                    m_unknown = "nlsat incomplete";
+                    break;
+                }
+            }
+        }
+        catch (z3_error & ex) {
+            throw ex;
+        }
+        catch (z3_exception & ex) {
+            m_unknown = ex.msg();
+            r = l_undef;
+        }
+        m_solver.pop(1);
+        m_a2b.pop(1);
+        m_t2x.pop(1);
+        m_deps.reset();
+        return r;
+    }
+
+    virtual void push() {
+        internalize_formulas();
+        m_solver.push();
+        m_a2b.push();
+        m_t2x.push();
+        ++m_num_scopes;
+        m_fmls_lim.push_back(m_fmls.size());
+        m_asms_lim.push_back(m_asmsf.size());
+        m_fmls_head_lim.push_back(m_fmls_head);
+        m_mc_lim.push_back(m_mc.get());
+    }
+
+    virtual void pop(unsigned n) {
+        SASSERT(n <= m_num_scopes);
+        m_solver.pop(n);
+        m_a2b.pop(n);
+        m_t2x.pop(n);
+        m_num_scopes -= n;
+        while (n > 0) {
+            m_fmls_head = m_fmls_head_lim.back();
+            m_fmls.resize(m_fmls_lim.back());
+            m_fmls_lim.pop_back();
+            m_fmls_head_lim.pop_back();
+            m_asmsf.resize(m_asms_lim.back());
+            m_asms_lim.pop_back();
+            m_mc = m_mc_lim.back();
+            m_mc_lim.pop_back();
+            --n;
+        }
+    }
+
+    virtual unsigned get_scope_level() const {
+        return m_num_scopes;
+    }
+
+    virtual void assert_expr(expr * t, expr * a) {
+        if (a) {
+            m_asmsf.push_back(a);
+            assert_expr(m.mk_implies(a, t));
+        }
+        else {
+            assert_expr(t);
+        }
+    }
+
+    virtual void assert_expr(expr * t) {
+        TRACE("nlsat", tout << mk_pp(t, m) << "\n";);
+        m_fmls.push_back(t);
+    }
+
+    virtual ast_manager& get_manager() { return m; }
+
+    virtual void set_produce_models(bool f) {}
+
+    virtual void collect_param_descrs(param_descrs & r) {
+        goal2nlsat::collect_param_descrs(r);
+        nlsat::solver::collect_param_descrs(r);
+        algebraic_numbers::manager::collect_param_descrs(r);
+    }
+
+    virtual void updt_params(params_ref const & p) {
+        m_params = p;
+        m_solver.updt_params(p);
+        m_preprocess->updt_params(p);
+    }
+
+    virtual void collect_statistics(statistics & st) const {
+        m_preprocess->collect_statistics(st);
+        m_solver.collect_statistics(st);
+    }
+
+    virtual void get_unsat_core(ptr_vector<expr> & r) {
+        r.reset();
+        r.append(m_core.size(), m_core.c_ptr());
+    }
+
+    virtual void get_model(model_ref & mdl) {
+        mdl = m_model;
+    }
+
+    virtual proof * get_proof() {
+        return 0;
+    }
+
+    virtual std::string reason_unknown() const {
+        return m_unknown;
+    }
+
+    virtual void get_labels(svector<symbol> & r) {
+    }
+
+    virtual unsigned get_num_assertions() const {
+        return m_fmls.size();
+    }
+
+    virtual expr * get_assertion(unsigned idx) const {
+        return m_fmls[idx];
+    }
+
+    virtual unsigned get_num_assumptions() const {
+        return m_asmsf.size();
+    }
+
+    virtual expr * get_assumption(unsigned idx) const {
+        return m_asmsf[idx];
+    }
+
+private:
+
+    lbool internalize_goal(goal_ref & g, model_converter_ref & mc) {
+        goal_ref_buffer     result;
+        proof_converter_ref pc;
+        expr_dependency_ref core(m);
+        mc = 0;
+        m_preprocess->reset();
+        TRACE("nlsat", g->display(tout););
+        try {
+            (*m_preprocess)(g, result, mc, pc, core);
+        }
+        catch (tactic_exception & ex) {
+            IF_VERBOSE(1, verbose_stream() << "exception in tactic " << ex.msg() << "\n";);
+            m_unknown = ex.msg();
+            return l_undef;
+        }
+        if (result.size() != 1) {
+            m_unknown = "preprocessing produced more than one goal";
+            return l_undef;
+        }
+        g = result[0];
+        TRACE("nlsat", g->display_with_dependencies(tout););
+        if (g->inconsistent()) {
+            nlsat::literal l = nlsat::false_literal;
+            expr_dependency * d = g->dep(0);
+            m_deps.push_back(d);
+            m_solver.mk_clause(1, &l, d);
+            return l_true;
+        }
+        for (unsigned i = 0; i < g->size(); ++i) {
+            if (g->dep(i) != 0)
+                m_deps.push_back(g->dep(i));
+        }
+        try {
+            m_goal2nlsat(*g, m_params, m_solver, m_a2b, m_t2x);
+        }
+        catch (tactic_exception & ex) {
+            IF_VERBOSE(1, verbose_stream() << "exception in goal2nlsat " << ex.msg() << "\n";);
+            m_unknown = ex.msg();
+            return l_undef;
+        }
+        return l_true;
+    }
+
+    lbool internalize_formulas() {
+        if (m_fmls_head == m_fmls.size()) {
+            return l_true;
+        }
+        goal_ref g = alloc(goal, m, true, false); // models are enabled.
+        for (unsigned i = m_fmls_head; i < m_fmls.size(); ++i) {
+            g->assert_expr(m_fmls.get(i));
+        }
+        model_converter_ref mc;
+        lbool r;
+        try {
+            r = internalize_goal(g, mc);
+        }
+        catch (z3_error & ex) {
+            throw ex;
+        }
+        catch (z3_exception & ex) {
+            m_unknown = ex.msg();
+            r = l_undef;
+        }
+        if (r == l_true) {
+            m_fmls_head = m_fmls.size();
+            m_mc = concat(m_mc.get(), mc.get());
+        }
+        return r;
+    }
+
+    lbool internalize_assumptions(unsigned sz, expr * const * asms, model_converter_ref & mc) {
+        if (sz == 0) {
+            return l_true;
+        }
+        goal_ref g = alloc(goal, m, true, true); // models and cores are enabled.
+        for (unsigned i = 0; i < sz; ++i) {
+            g->assert_expr(asms[i], m.mk_leaf(asms[i]));
+        }
+        return internalize_goal(g, mc);
+    }
+
+    void extract_core() {
+        vector<nlsat::assumption, false> deps;
+        m_solver.get_core(deps);
+        obj_hashtable<expr> seen;
+        ptr_vector<expr> es;
+        for (unsigned i = 0; i < deps.size(); ++i) {
+            es.reset();
+            m.linearize(static_cast<expr_dependency*>(deps[i]), es);
+            for (unsigned j = 0; j < es.size(); ++j) {
+                if (!seen.contains(es[j])) {
+                    seen.insert(es[j]);
+                    m_core.push_back(es[j]);
+                }
+            }
+        }
+        TRACE("nlsat", tout << "core: " << m_core << "\n";);
+    }
+
+    bool contains_unsupported(expr_ref_vector & b2a, expr_ref_vector & x2t) {
+        for (unsigned x = 0; x < x2t.size(); x++) {
+            if (x2t.get(x) != 0 && !is_uninterp_const(x2t.get(x))) {
+                TRACE("unsupported", tout << "unsupported atom:\n" << mk_pp(x2t.get(x), m) << "\n";);
+                return true;
+            }
+        }
+        for (unsigned b = 0; b < b2a.size(); b++) {
+            expr * a = b2a.get(b);
+            if (a == 0 || is_uninterp_const(a))
+                continue;
+            TRACE("unsupported", tout << "unsupported atom:\n" << mk_pp(a, m) << "\n";);
+            return true;
+        }
+        return false;
+    }
+
+    // Return false if the model cannot be converted to a model of the assertions.
+    bool extract_model(model_converter * asm_mc) {
+        expr_ref_vector x2t(m);
+        expr_ref_vector b2a(m);
+        m_a2b.mk_inv(b2a);
+        m_t2x.mk_inv(x2t);
+        if (contains_unsupported(b2a, x2t)) {
+            m_unknown = "unsupported atoms";
+            return false;
+        }
+        model_ref md = alloc(model, m);
+        arith_util util(m);
+        for (unsigned x = 0; x < x2t.size(); x++) {
+            expr * t = x2t.get(x);
+            if (t == 0)
+                continue;
+            expr * v;
+            try {
+                v = util.mk_numeral(m_solver.value(x), util.is_int(t));
+            }
+            catch (z3_error & ex) {
+                throw ex;
+            }
+            catch (z3_exception &) {
+                m_unknown = "nlsat assigned a non-integer value to an integer variable";
+                return false;
+            }
+            md->register_decl(to_app(t)->get_decl(), v);
+        }
+        for (unsigned b = 0; b < b2a.size(); b++) {
+            expr * a = b2a.get(b);
+            if (a == 0)
+                continue;
+            lbool val = m_solver.bvalue(b);
+            if (val == l_undef)
+                continue; // don't care
+            md->register_decl(to_app(a)->get_decl(), val == l_true ? m.mk_true() : m.mk_false());
+        }
+        model_converter_ref mc = concat(m_mc.get(), asm_mc);
+        if (mc)
+            (*mc)(md);
+        m_model = md;
+        return true;
+    }
+};
+
+solver* mk_inc_nlsat_solver(ast_manager& m, params_ref const& p) {
+    return alloc(inc_nlsat_solver, m, p);
+}
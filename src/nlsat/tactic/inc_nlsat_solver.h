@@ -0,0 +1,24 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    inc_nlsat_solver.h
+
+Abstract:
+
+    incremental solver based on the nlsat core.
+
+Author:
+
+Notes:
+
+--*/
+#ifndef INC_NLSAT_SOLVER_H_
+#define INC_NLSAT_SOLVER_H_
+
+#include"solver.h"
+
+solver* mk_inc_nlsat_solver(ast_manager& m, params_ref const& p);
+
+#endif
@@ -51,6 +51,7 @@ struct qi_params {
     unsigned           m_mbqi_max_iterations;
     bool               m_mbqi_trace;
     unsigned           m_mbqi_force_template;
+    unsigned           m_mbqi_threads;
     const char *       m_mbqi_id;
 
     qi_params(params_ref const & p = params_ref()):
@@ -99,6 +100,7 @@ struct qi_params {
         m_mbqi_max_iterations(1000),
         m_mbqi_trace(false),
 	m_mbqi_force_template(10),
+        m_mbqi_threads(1),
         m_mbqi_id(0)  
     {
         updt_params(p);
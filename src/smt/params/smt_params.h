@@ -26,6 +26,7 @@ Revision History:
 #include"theory_array_params.h"
 #include"theory_bv_params.h"
 #include"theory_pb_params.h"
+#include"theory_fpa_params.h"
 #include"theory_datatype_params.h"
 #include"preprocessor_params.h"
 #include"context_params.h"
@@ -76,6 +77,7 @@ struct smt_params : public preprocessor_params,
                     public theory_array_params, 
                     public theory_bv_params,
                     public theory_pb_params,
+                    public theory_fpa_params,
                     public theory_datatype_params {
     bool             m_display_proof;
     bool             m_display_dot_proof;
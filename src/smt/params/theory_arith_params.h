@@ -99,6 +99,8 @@ struct theory_arith_params {
     unsigned                m_nl_arith_gb_threshold;
     bool                    m_nl_arith_gb_eqs;
     bool                    m_nl_arith_gb_perturbate;
+    bool                    m_nl_arith_gb_f4;
+    unsigned                m_nl_arith_gb_f4_max_degree;
     unsigned                m_nl_arith_max_degree;
     bool                    m_nl_arith_branching;
     unsigned                m_nl_arith_rounds;
@@ -148,6 +150,8 @@ struct theory_arith_params {
         m_nl_arith_gb_threshold(512),
         m_nl_arith_gb_eqs(false),
         m_nl_arith_gb_perturbate(true),
+        m_nl_arith_gb_f4(false),
+        m_nl_arith_gb_f4_max_degree(UINT_MAX),
         m_nl_arith_max_degree(6),
         m_nl_arith_branching(true),
         m_nl_arith_rounds(1024),
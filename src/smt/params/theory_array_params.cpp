@@ -23,6 +23,8 @@ void theory_array_params::updt_params(params_ref const & _p) {
     smt_params_helper p(_p);
     m_array_weak = p.array_weak();
     m_array_extensional = p.array_extensional();
+    m_array_lazy_axioms = p.array_lazy_axioms();
+    m_array_lazy_ext_budget = p.array_lazy_ext_budget();
 }
 
 
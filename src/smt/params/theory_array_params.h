@@ -38,6 +38,8 @@ struct theory_array_params : public array_simplifier_params {
     bool            m_array_always_prop_upward;
     bool            m_array_lazy_ieq;
     unsigned        m_array_lazy_ieq_delay;
+    bool            m_array_lazy_axioms;       // instantiate axiom 2 and extensionality only when violated at final check
+    unsigned        m_array_lazy_ext_budget;   // max. number of extensionality axioms per final check when m_array_lazy_axioms
 
     theory_array_params():
         m_array_mode(AR_FULL),
@@ -48,7 +50,9 @@ struct theory_array_params : public array_simplifier_params {
         m_array_cg(false),
         m_array_always_prop_upward(true), // UPWARDs filter is broken... TODO: fix it
         m_array_lazy_ieq(false),
-        m_array_lazy_ieq_delay(10) {
+        m_array_lazy_ieq_delay(10),
+        m_array_lazy_axioms(false),
+        m_array_lazy_ext_budget(8) {
     }
 
 
@@ -0,0 +1,23 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    theory_fpa_params.cpp
+
+Abstract:
+
+    Parameters for the floating-point theory plugin.
+
+Author:
+
+Revision History:
+
+--*/
+#include"theory_fpa_params.h"
+#include"smt_params_helper.hpp"
+
+void theory_fpa_params::updt_params(params_ref const & _p) {
+    smt_params_helper p(_p);
+    m_fpa_lazy_ops = p.fp_lazy_ops();
+}
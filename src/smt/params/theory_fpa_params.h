@@ -0,0 +1,33 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    theory_fpa_params.h
+
+Abstract:
+
+    Parameters for the floating-point theory plugin.
+
+Author:
+
+Revision History:
+
+--*/
+#ifndef THEORY_FPA_PARAMS_H_
+#define THEORY_FPA_PARAMS_H_
+
+#include"params.h"
+
+struct theory_fpa_params {
+    bool m_fpa_lazy_ops; // abstract fp.mul, fp.div and fp.sqrt and bit-blast them on demand
+    theory_fpa_params(params_ref const & p = params_ref()):
+        m_fpa_lazy_ops(false) {
+        updt_params(p);
+    }
+
+    void updt_params(params_ref const & p);
+};
+
+#endif /* THEORY_FPA_PARAMS_H_ */
+
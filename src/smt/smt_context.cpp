@@ -243,7 +243,11 @@ namespace smt {
     }
 
     context * context::mk_fresh(symbol const * l, smt_params * p) {
-        context * new_ctx = alloc(context, m_manager, p == 0 ? m_fparams : *p);
+        return mk_fresh(m_manager, l, p);
+    }
+
+    context * context::mk_fresh(ast_manager & m, symbol const * l, smt_params * p) {
+        context * new_ctx = alloc(context, m, p == 0 ? m_fparams : *p);
         new_ctx->set_logic(l == 0 ? m_setup.get_logic() : *l);
         copy_plugins(*this, *new_ctx);        
         return new_ctx;
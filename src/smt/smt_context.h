@@ -1347,6 +1347,12 @@ namespace smt {
         */
         context * mk_fresh(symbol const * l = 0,  smt_params * p = 0);
 
+        /**
+           \brief Similar to mk_fresh, but the new context uses the manager m.
+           m must be a copy of get_manager() (i.e., it must have the same plugins).
+        */
+        context * mk_fresh(ast_manager & m, symbol const * l, smt_params * p);
+
         static void copy(context& src, context& dst);
 
         /**
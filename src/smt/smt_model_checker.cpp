@@ -27,6 +27,9 @@ Revision History:
 #include"ast_ll_pp.h"
 #include"model_pp.h"
 #include"ast_smt2_pp.h"
+#include"ast_util.h"
+#include"ast_translation.h"
+#include"z3_omp.h"
 
 namespace smt {
 
@@ -46,6 +49,7 @@ namespace smt {
     model_checker::~model_checker() {
         m_aux_context = 0; // delete aux context before fparams
         m_fparams = 0;
+        reset_par_contexts();
     }
 
     quantifier * model_checker::get_flat_quantifier(quantifier * q) {
@@ -80,13 +84,13 @@ namespace smt {
     }
 
     /**
-       \brief Assert in m_aux_context, the constraint
+       \brief Store in result the constraint
 
          sk = e_1 OR ... OR sk = e_n
 
          where {e_1, ..., e_n} is the universe.
      */
-    void model_checker::restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe) {
+    void model_checker::restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe, expr_ref_vector & result) {
         SASSERT(!universe.empty());
         ptr_buffer<expr> eqs;
         obj_hashtable<expr>::iterator it  = universe.begin();
@@ -95,17 +99,18 @@ namespace smt {
             expr * e = *it;
             eqs.push_back(m_manager.mk_eq(sk, e));
         }
-        m_aux_context->assert_expr(m_manager.mk_or(eqs.size(), eqs.c_ptr()));
+        result.push_back(m_manager.mk_or(eqs.size(), eqs.c_ptr()));
     }
 
 #define PP_DEPTH 8
 
     /**
-       \brief Assert the negation of q after applying the interpretation in m_curr_model to the uninterpreted symbols in q.
+       \brief Store in result the negation of q after applying the interpretation in m_curr_model to the uninterpreted symbols in q,
+       and the constraints restricting the skolem constants to the universe of finite sorts.
 
        The variables are replaced by skolem constants. These constants are stored in sks.
     */
-    void model_checker::assert_neg_q_m(quantifier * q, expr_ref_vector & sks) {
+    void model_checker::mk_neg_q_m(quantifier * q, expr_ref_vector & sks, expr_ref_vector & result) {
         expr_ref tmp(m_manager);
         m_curr_model->eval(q->get_expr(), tmp, true);
         TRACE("model_checker", tout << "q after applying interpretation:\n" << mk_ismt2_pp(tmp, m_manager) << "\n";);        
@@ -119,7 +124,7 @@ namespace smt {
             sks[num_decls - i - 1]        = sk;
             subst_args[num_decls - i - 1] = sk;
             if (m_curr_model->is_finite(s)) {
-                restrict_to_universe(sk, m_curr_model->get_known_universe(s));
+                restrict_to_universe(sk, m_curr_model->get_known_universe(s), result);
             }
         }
 
@@ -129,7 +134,18 @@ namespace smt {
         expr_ref r(m_manager);
         r = m_manager.mk_not(sk_body);
         TRACE("model_checker", tout << "mk_neg_q_m:\n" << mk_ismt2_pp(r, m_manager) << "\n";);
-        m_aux_context->assert_expr(r);
+        result.push_back(r);
+    }
+
+    /**
+       \brief Assert in m_aux_context the formulas produced by mk_neg_q_m.
+    */
+    void model_checker::assert_neg_q_m(quantifier * q, expr_ref_vector & sks) {
+        expr_ref_vector fmls(m_manager);
+        mk_neg_q_m(q, sks, fmls);
+        for (unsigned i = 0; i < fmls.size(); i++) {
+            m_aux_context->assert_expr(fmls.get(i));
+        }
     }
 
     bool model_checker::add_instance(quantifier * q, model * cex, expr_ref_vector & sks, bool use_inv) {
@@ -313,6 +329,97 @@ namespace smt {
         }
     }
 
+    void model_checker::init_par_contexts(unsigned num_threads) {
+        init_aux_context();
+        if (m_par_contexts.size() >= num_threads)
+            return;
+        symbol logic;
+        for (unsigned i = m_par_contexts.size(); i < num_threads; i++) {
+            ast_manager * new_m = alloc(ast_manager, m_manager, !m_manager.proof_mode());
+            m_par_managers.push_back(new_m);
+            m_par_fparams.push_back(alloc(smt_params, *m_fparams));
+            m_par_contexts.push_back(m_aux_context->mk_fresh(*new_m, &logic, m_par_fparams[i]));
+        }
+    }
+
+    void model_checker::reset_par_contexts() {
+        // contexts must be deleted before their managers and parameters
+        m_par_contexts.reset();
+        m_par_fparams.reset();
+        m_par_managers.reset();
+    }
+
+    /**
+       \brief Check the quantifiers qs against m_curr_model using one auxiliary context per thread.
+       Each worker context uses its own ast_manager, and the negated quantifiers are translated into it.
+
+       results[i] is l_false if qs[i] is satisfied by m_curr_model, l_true if there is a counterexample,
+       and l_undef if the worker failed. The formulas are built and translated before the
+       parallel section because m_manager and m_curr_model are not thread safe. Instances are
+       not created here: quantifiers that are not satisfied are checked again by check(q),
+       since the instantiation sets of m_model_finder only exist in m_manager.
+    */
+    void model_checker::par_check(ptr_vector<quantifier> const & qs, svector<lbool> & results) {
+        unsigned num_threads = std::min(m_params.m_mbqi_threads, qs.size());
+        init_par_contexts(num_threads);
+        results.reset();
+        results.resize(qs.size(), l_undef);
+
+        scoped_ptr_vector<expr_ref_vector> fmls;
+        for (unsigned i = 0; i < num_threads; i++) {
+            ast_manager & new_m = *(m_par_managers[i]);
+            ast_translation translator(m_manager, new_m, false);
+            fmls.push_back(alloc(expr_ref_vector, new_m));
+            for (unsigned j = i; j < qs.size(); j += num_threads) {
+                expr_ref_vector sks(m_manager), neg(m_manager);
+                mk_neg_q_m(get_flat_quantifier(qs[j]), sks, neg);
+                expr_ref fml(m_manager);
+                fml = mk_and(neg);
+                fmls[i]->push_back(translator(fml.get()));
+            }
+        }
+
+        svector<bool> failed;
+        failed.resize(num_threads, false);
+        for (unsigned i = 0; i < num_threads; i++) {
+            m_manager.limit().push_child(&(m_par_managers[i]->limit()));
+        }
+
+        #pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(num_threads); i++) {
+            context & ctx = *(m_par_contexts[i]);
+            expr_ref_vector const & fs = *(fmls[i]);
+            try {
+                for (unsigned k = 0, j = i; k < fs.size(); k++, j += num_threads) {
+                    ctx.push();
+                    ctx.assert_expr(fs.get(k));
+                    results[j] = ctx.check();
+                    ctx.pop(1);
+                }
+            }
+            catch (z3_exception &) {
+                failed[i] = true;
+            }
+        }
+
+        for (unsigned i = 0; i < num_threads; i++) {
+            m_manager.limit().pop_child();
+        }
+        
+        // release formulas before a failed worker (and its manager) is discarded.
+        fmls.reset();
+        for (unsigned i = 0; i < num_threads; i++) {
+            if (failed[i]) {
+                // the state of the worker is unknown, they are recreated in the next round.
+                reset_par_contexts();
+                break;
+            }
+        }
+        TRACE("model_checker", tout << "parallel model-checker results:";
+              for (unsigned i = 0; i < results.size(); i++) tout << " " << to_sat_str(results[i]);
+              tout << "\n";);
+    }
+
     struct scoped_set_relevancy {
     };
 
@@ -343,20 +450,33 @@ namespace smt {
         bool found_relevant = false;
         unsigned num_failures = 0;
 
+        ptr_vector<quantifier> qs;
         for (; it != end; ++it) {
             quantifier * q = *it;
 	    if(!m_qm->mbqi_enabled(q)) continue;
             if (m_context->is_relevant(q) && m_context->get_assignment(q) == l_true) {
-                if (m_params.m_mbqi_trace && q->get_qid() != symbol::null) {
-                    verbose_stream() << "(smt.mbqi :checking " << q->get_qid() << ")\n";
-                }
-                found_relevant = true;
-                if (!check(q)) {
-                    if (m_params.m_mbqi_trace || get_verbosity_level() >= 5) {
-                        verbose_stream() << "(smt.mbqi :failed " << q->get_qid() << ")\n";
-                    }
-                    num_failures++;
+                qs.push_back(q);
+            }
+        }
+
+        svector<lbool> par_results;
+        if (m_params.m_mbqi_threads > 1 && qs.size() > 1 && !omp_in_parallel()) {
+            par_check(qs, par_results);
+        }
+
+        for (unsigned i = 0; i < qs.size(); i++) {
+            quantifier * q = qs[i];
+            if (m_params.m_mbqi_trace && q->get_qid() != symbol::null) {
+                verbose_stream() << "(smt.mbqi :checking " << q->get_qid() << ")\n";
+            }
+            found_relevant = true;
+            if (!par_results.empty() && par_results[i] == l_false) 
+                continue; // a worker context showed that q is satisfied by m_curr_model
+            if (!check(q)) {
+                if (m_params.m_mbqi_trace || get_verbosity_level() >= 5) {
+                    verbose_stream() << "(smt.mbqi :failed " << q->get_qid() << ")\n";
                 }
+                num_failures++;
             }
         }
         
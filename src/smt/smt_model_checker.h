@@ -26,6 +26,8 @@ Revision History:
 #include"qi_params.h"
 #include"smt_params.h"
 #include"region.h"
+#include"scoped_ptr_vector.h"
+#include"lbool.h"
 
 class proto_model;
 class model;
@@ -51,14 +53,22 @@ namespace smt {
         unsigned                                    m_iteration_idx;
         proto_model *                               m_curr_model;
         obj_map<expr, expr *>                       m_value2expr;
+        // Worker managers and contexts used to check quantifiers in parallel (see par_check).
+        scoped_ptr_vector<ast_manager>              m_par_managers;
+        scoped_ptr_vector<smt_params>               m_par_fparams;
+        scoped_ptr_vector<context>                  m_par_contexts;
         friend class instantiation_set;
 
         void init_aux_context();
+        void init_par_contexts(unsigned num_threads);
+        void reset_par_contexts();
         expr * get_term_from_ctx(expr * val);
-        void restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe);
+        void restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe, expr_ref_vector & result);
+        void mk_neg_q_m(quantifier * q, expr_ref_vector & sks, expr_ref_vector & result);
         void assert_neg_q_m(quantifier * q, expr_ref_vector & sks);
         bool add_blocking_clause(model * cex, expr_ref_vector & sks);
         bool check(quantifier * q);
+        void par_check(ptr_vector<quantifier> const & qs, svector<lbool> & results);
         
         struct instance {
             quantifier * m_q;
@@ -47,6 +47,7 @@ namespace smt {
         unsigned m_th2core_eqs, m_th2core_diseqs, m_bound_props, m_offset_eqs, m_fixed_eqs, m_offline_eqs;
         unsigned m_max_min; 
         unsigned m_gb_simplify, m_gb_superpose, m_gb_compute_basis, m_gb_num_processed;
+        unsigned m_gb_f4_steps, m_gb_f4_zero_rows;
         unsigned m_nl_branching, m_nl_linear, m_nl_bounds, m_nl_cross_nested;
 
         void reset() { memset(this, 0, sizeof(theory_arith_stats)); }
@@ -2218,6 +2218,7 @@ namespace smt {
         if (m_nl_gb_exhausted)
             return GB_FAIL;
         grobner gb(get_manager(), m_dep_manager);
+        gb.set_f4(m_params.m_nl_arith_gb_f4, m_params.m_nl_arith_gb_f4_max_degree);
         init_grobner(nl_cluster, gb);
         TRACE("non_linear", display(tout););
         bool warn            = false;
@@ -2238,6 +2239,8 @@ namespace smt {
             m_stats.m_gb_simplify      += gb.m_stats.m_simplify;
             m_stats.m_gb_superpose     += gb.m_stats.m_superpose;
             m_stats.m_gb_num_processed += gb.m_stats.m_num_processed;
+            m_stats.m_gb_f4_steps      += gb.m_stats.m_f4_steps;
+            m_stats.m_gb_f4_zero_rows  += gb.m_stats.m_f4_zero_rows;
             m_stats.m_gb_compute_basis++;
             if (!r && !warn) {
                 IF_VERBOSE(3, verbose_stream() << "Grobner basis computation interrupted. Increase threshold using NL_ARITH_GB_THRESHOLD=<limit>\n";);
@@ -40,6 +40,8 @@ namespace smt {
         st.update("gomory cuts", m_stats.m_gomory_cuts);
         st.update("max-min", m_stats.m_max_min);
         st.update("grobner", m_stats.m_gb_compute_basis);
+        st.update("grobner f4 steps", m_stats.m_gb_f4_steps);
+        st.update("grobner f4 zero rows", m_stats.m_gb_f4_zero_rows);
         st.update("pseudo nonlinear", m_stats.m_nl_linear);
         st.update("nonlinear bounds", m_stats.m_nl_bounds);
         st.update("nonlinear horner", m_stats.m_nl_cross_nested);
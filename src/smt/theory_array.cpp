@@ -100,8 +100,11 @@ namespace smt {
         m_trail_stack.push(push_back_trail<theory_array, enode *, false>(d->m_parent_selects));
         ptr_vector<enode>::iterator it  = d->m_stores.begin();
         ptr_vector<enode>::iterator end = d->m_stores.end();
-        for (; it != end; ++it) {
-            instantiate_axiom2a(s, *it);
+        if (!m_params.m_array_lazy_axioms) {
+            // otherwise, axiom 2 is only instantiated at final check (see assert_lazy_axioms)
+            for (; it != end; ++it) {
+                instantiate_axiom2a(s, *it);
+            }
         }
         if (!m_params.m_array_weak && !m_params.m_array_delay_exp_axiom && d->m_prop_upward) {
             it  = d->m_parent_stores.begin();
@@ -203,11 +206,13 @@ namespace smt {
         }
         d->m_stores.push_back(s);
         m_trail_stack.push(push_back_trail<theory_array, enode *, false>(d->m_stores));
-        ptr_vector<enode>::iterator it  = d->m_parent_selects.begin();
-        ptr_vector<enode>::iterator end = d->m_parent_selects.end();
-        for (; it != end; ++it) {
-            SASSERT(is_select(*it));
-            instantiate_axiom2a(*it, s);
+        if (!m_params.m_array_lazy_axioms) {
+            ptr_vector<enode>::iterator it  = d->m_parent_selects.begin();
+            ptr_vector<enode>::iterator end = d->m_parent_selects.end();
+            for (; it != end; ++it) {
+                SASSERT(is_select(*it));
+                instantiate_axiom2a(*it, s);
+            }
         }
         if (m_params.m_array_always_prop_upward || lambda_equiv_class_size >= 1) 
             set_prop_upward(s);
@@ -324,7 +329,13 @@ namespace smt {
             SASSERT(m_var_data[v2]->m_is_array);
             TRACE("ext", tout << "extensionality:\n" << mk_bounded_pp(get_enode(v1)->get_owner(), get_manager(), 5) << "\n" << 
                   mk_bounded_pp(get_enode(v2)->get_owner(), get_manager(), 5) << "\n";);
-            instantiate_extensionality(get_enode(v1), get_enode(v2));
+            if (m_params.m_array_lazy_axioms) {
+                m_lazy_extensionality.push_back(std::make_pair(get_enode(v1), get_enode(v2)));
+                m_trail_stack.push(push_back_trail<theory_array, enode_pair, false>(m_lazy_extensionality));
+            }
+            else {
+                instantiate_extensionality(get_enode(v1), get_enode(v2));
+            }
         }
     }
 
@@ -366,7 +377,10 @@ namespace smt {
     final_check_status theory_array::final_check_eh() {
         m_final_check_idx++;
         final_check_status r;
-        if (m_params.m_array_lazy_ieq) {
+        if (m_params.m_array_lazy_axioms && assert_lazy_axioms() == FC_CONTINUE) {
+            r = FC_CONTINUE;
+        }
+        else if (m_params.m_array_lazy_ieq) {
             // Delay the creation of interface equalities...  The
             // motivation is too give other theories and quantifier
             // instantiation to do something useful during final
@@ -415,6 +429,92 @@ namespace smt {
         return r;
     }
 
+    /**
+       \brief Return true if the instance of axiom 2 for select(A, j) and store(a, i, v), where A = store(a, i, v),
+       is satisfied by the current assignment. That is, i = j or there is a relevant select(a, j) = select(A, j).
+    */
+    bool theory_array::is_axiom2_sat(enode * select, enode * store) {
+        SASSERT(is_select(select));
+        SASSERT(is_store(store));
+        unsigned num_args = select->get_num_args();
+        unsigned i        = 1;
+        for (; i < num_args; i++) 
+            if (store->get_arg(i)->get_root() != select->get_arg(i)->get_root())
+                break;
+        if (i == num_args)
+            return true;
+        context & ctx = get_context();
+        ptr_buffer<enode> args;
+        args.push_back(store->get_arg(0));
+        for (i = 1; i < num_args; i++)
+            args.push_back(select->get_arg(i));
+        enode * sel2 = ctx.get_enode_eq_to(select->get_decl(), args.size(), args.c_ptr());
+        return sel2 != 0 && ctx.is_relevant(sel2) && sel2->get_root() == select->get_root();
+    }
+
+    /**
+       \brief Instantiate axiom 2 for the parent selects and stores of v that are violated by the current assignment.
+       Return true if a new axiom was instantiated.
+    */
+    bool theory_array::instantiate_lazy_axiom2_for(theory_var v) {
+        bool result  = false;
+        var_data * d = m_var_data[v];
+        ptr_vector<enode>::iterator it  = d->m_parent_selects.begin();
+        ptr_vector<enode>::iterator end = d->m_parent_selects.end();
+        for (; it != end; ++it) {
+            enode * select = *it;
+            ptr_vector<enode>::iterator it2  = d->m_stores.begin();
+            ptr_vector<enode>::iterator end2 = d->m_stores.end();
+            for (; it2 != end2; ++it2) {
+                enode * store = *it2;
+                if (is_axiom2_sat(select, store)) {
+                    m_stats.m_num_lazy_sat_checks++;
+                }
+                else if (assert_store_axiom2(store, select)) {
+                    TRACE("array", tout << "lazy axiom 2: #" << select->get_owner_id() << " #" << store->get_owner_id() << "\n";);
+                    m_stats.m_num_lazy_axiom2++;
+                    result = true;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+       \brief Model-based instantiation of axiom 2 and extensionality (m_array_lazy_axioms).
+       Only the instances that are not satisfied by the current assignment are instantiated, and
+       at most m_array_lazy_ext_budget extensionality axioms are created in each final check (0 means no limit).
+    */
+    final_check_status theory_array::assert_lazy_axioms() {
+        final_check_status r = FC_DONE;
+        unsigned num_vars    = get_num_vars();
+        for (unsigned v = 0; v < num_vars; v++) {
+            if (is_root(v) && instantiate_lazy_axiom2_for(v))
+                r = FC_CONTINUE;
+        }
+        if (!m_params.m_array_extensional)
+            return r;
+        unsigned budget = m_params.m_array_lazy_ext_budget;
+        unsigned num_ext = 0;
+        for (unsigned i = 0; i < m_lazy_extensionality.size(); i++) {
+            if (budget > 0 && num_ext >= budget)
+                break;
+            enode * a1 = m_lazy_extensionality[i].first;
+            enode * a2 = m_lazy_extensionality[i].second;
+            if (already_diseq(a1, a2)) {
+                m_stats.m_num_lazy_sat_checks++;
+            }
+            else if (assert_extensionality(a1, a2)) {
+                TRACE("ext", tout << "lazy extensionality: #" << a1->get_owner_id() << " #" << a2->get_owner_id() << "\n";);
+                m_stats.m_num_extensionality++;
+                m_stats.m_num_lazy_extensionality++;
+                num_ext++;
+                r = FC_CONTINUE;
+            }
+        }
+        return r;
+    }
+
     final_check_status theory_array::mk_interface_eqs_at_final_check() {
         unsigned n = mk_interface_eqs();
         m_stats.m_num_eq_splits += n;
@@ -425,6 +525,7 @@ namespace smt {
 
     void theory_array::reset_eh() {
         m_trail_stack.reset();
+        m_lazy_extensionality.reset();
         std::for_each(m_var_data.begin(), m_var_data.end(), delete_proc<var_data>());
         m_var_data.reset();
         theory_array_base::reset_eh();
@@ -475,6 +576,11 @@ namespace smt {
         st.update("array exp ax2", m_stats.m_num_axiom2b);
         st.update("array ext ax", m_stats.m_num_extensionality);
         st.update("array splits", m_stats.m_num_eq_splits);
+        if (m_params.m_array_lazy_axioms) {
+            st.update("array lazy ax2", m_stats.m_num_lazy_axiom2);
+            st.update("array lazy ext ax", m_stats.m_num_lazy_extensionality);
+            st.update("array lazy sat", m_stats.m_num_lazy_sat_checks);
+        }
     }
 
 };
@@ -30,6 +30,7 @@ namespace smt {
         unsigned   m_num_map_axiom, m_num_default_map_axiom;
         unsigned   m_num_select_const_axiom, m_num_default_store_axiom, m_num_default_const_axiom, m_num_default_as_array_axiom;
         unsigned   m_num_select_as_array_axiom;
+        unsigned   m_num_lazy_axiom2, m_num_lazy_extensionality, m_num_lazy_sat_checks;
         void reset() { memset(this, 0, sizeof(theory_array_stats)); }
         theory_array_stats() { reset(); }
     };
@@ -54,6 +55,7 @@ namespace smt {
         th_union_find                   m_find;
         th_trail_stack                  m_trail_stack;
         unsigned                        m_final_check_idx;
+        enode_pair_vector               m_lazy_extensionality; // disequalities whose extensionality axiom was delayed
 
         virtual void init(context * ctx);
         virtual theory_var mk_var(enode * n);
@@ -93,6 +95,10 @@ namespace smt {
         virtual final_check_status assert_delayed_axioms();
         final_check_status mk_interface_eqs_at_final_check();
 
+        bool is_axiom2_sat(enode * select, enode * store);
+        bool instantiate_lazy_axiom2_for(theory_var v);
+        final_check_status assert_lazy_axioms();
+
         static void display_ids(std::ostream & out, unsigned n, enode * const * v);
     public:
         theory_array(ast_manager & m, theory_array_params & params);
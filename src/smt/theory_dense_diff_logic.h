@@ -33,15 +33,25 @@ namespace smt {
     struct theory_dense_diff_logic_statistics {
         unsigned  m_num_assertions;
         unsigned  m_num_propagations;
+        unsigned  m_num_dense_relaxations;
         void reset() {
             m_num_assertions         = 0;
             m_num_propagations       = 0;
+            m_num_dense_relaxations  = 0;
         }
         theory_dense_diff_logic_statistics() {
             reset();
         }
     };
     
+    inline bool dense_small_int(s_integer const & n, int & r) { r = n.get_int(); return true; }
+    inline bool dense_small_int(rational const & n, int & r) {
+        if (!n.is_int32())
+            return false;
+        r = n.get_int32();
+        return true;
+    }
+
     template<typename Ext>
     class theory_dense_diff_logic : public theory, public theory_opt, private Ext {
     public:
@@ -110,6 +120,18 @@ namespace smt {
         
         typedef vector<cell> row;
         typedef vector<row>  matrix;
+
+        // Compact copy of the distances stored in the matrix. It is used by
+        // update_cells to scan rows of machine integers instead of rows of
+        // cells, and it is only maintained while every distance is an
+        // integer whose absolute value is at most small_dist_bound.
+        // Disconnected pairs are represented by null_dist.
+        typedef svector<int> dist_row;
+        typedef vector<dist_row> dist_matrix;
+        enum {
+            null_dist        = 1 << 30,
+            small_dist_bound = 1 << 27
+        };
         
         struct scope {
             unsigned  m_atoms_lim;
@@ -124,6 +146,10 @@ namespace smt {
         atoms                 m_bv2atoms;
         edges                 m_edges;  // list of asserted edges
         matrix                m_matrix;
+        dist_matrix           m_dist;
+        bool                  m_small_dist;     // true if m_dist is in sync with m_matrix
+        svector<int>          m_small_targets;
+        svector<int>          m_small_new_dist;
         svector<bool>         m_is_int;
         vector<cell_trail>    m_cell_trail;
         svector<scope>        m_scopes;
@@ -190,6 +216,10 @@ namespace smt {
         void mk_clause(literal l1, literal l2, literal l3);
         void add_edge(theory_var source, theory_var target, numeral const & offset, literal l);
         void update_cells();
+        bool to_small_dist(numeral const & n, int & r) const;
+        void disable_small_dist();
+        void update_cells_small(int k);
+        void relax_small_cell(theory_var y, theory_var x, int new_dist, edge_id new_edge_id, bool & overflow);
         void propagate_using_cell(theory_var source, theory_var target);
         void get_antecedents(theory_var source, theory_var target, literal_vector & result);
         void assign_literal(literal l, theory_var source, theory_var target);
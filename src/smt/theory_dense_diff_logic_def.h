@@ -34,6 +34,7 @@ namespace smt {
         m_params(p),
         m_autil(m),
         m_arith_eq_adapter(*this, p, m_autil),
+        m_small_dist(true),
         m_non_diff_logic_exprs(false),
         m_var_value_table(DEFAULT_HASHTABLE_INITIAL_CAPACITY, var_value_hash(*this), var_value_eq(*this)) {
         m_edges.push_back(edge());
@@ -67,6 +68,16 @@ namespace smt {
         cell & c    = m_matrix[v][v];
         c.m_edge_id = self_edge_id;
         c.m_distance.reset();
+        if (m_small_dist) {
+            typename dist_matrix::iterator it  = m_dist.begin();
+            typename dist_matrix::iterator end = m_dist.end();
+            for (; it != end; ++it) {
+                it->push_back(null_dist);
+            }
+            m_dist.push_back(dist_row());
+            m_dist.back().resize(v+1, null_dist);
+            m_dist[v][v] = 0;
+        }
         SASSERT(check_vector_sizes());
         get_context().attach_th_var(n, this, v);
         return v;
@@ -326,6 +337,12 @@ namespace smt {
             cell & c       = m_matrix[t.m_source][t.m_target];
             c.m_edge_id    = t.m_old_edge_id;
             c.m_distance   = t.m_old_distance;
+            if (m_small_dist) {
+                int d = null_dist;
+                if (t.m_old_edge_id != null_edge_id)
+                    VERIFY(to_small_dist(t.m_old_distance, d));
+                m_dist[t.m_source][t.m_target] = d;
+            }
         }
         m_cell_trail.shrink(old_size);
     }
@@ -367,6 +384,14 @@ namespace smt {
             for (; it != end; ++it) {
                 it->shrink(old_num_vars);
             }
+            if (m_small_dist) {
+                m_dist.shrink(old_num_vars);
+                typename dist_matrix::iterator it2  = m_dist.begin();
+                typename dist_matrix::iterator end2 = m_dist.end();
+                for (; it2 != end2; ++it2) {
+                    it2->shrink(old_num_vars);
+                }
+            }
         }
     }
         
@@ -415,11 +440,13 @@ namespace smt {
         m_bv2atoms   .reset();
         m_edges      .reset();
         m_matrix     .reset();
+        m_dist       .reset();
         m_is_int     .reset();
         m_f_targets  .reset();
         m_cell_trail .reset();
         m_scopes     .reset();
         m_non_diff_logic_exprs = false;
+        m_small_dist = true;
         m_edges.push_back(edge());
         theory::reset_eh();
     }
@@ -472,6 +499,15 @@ namespace smt {
         theory_var t        = last.m_target;
         numeral const & k   = last.m_offset;
 
+        if (m_small_dist) {
+            int k_small;
+            if (to_small_dist(k, k_small)) {
+                update_cells_small(k_small);
+                return;
+            }
+            disable_small_dist();
+        }
+
         // Compute set F of nodes such that:
         // x in F iff
         //    k + d(t, x) < d(s, x)
@@ -533,6 +569,117 @@ namespace smt {
         CASSERT("ddl", check_matrix());
     }
 
+    template<typename Ext>
+    bool theory_dense_diff_logic<Ext>::to_small_dist(numeral const & n, int & r) const {
+        return
+            n.get_infinitesimal().is_zero() &&
+            dense_small_int(n.get_rational(), r) &&
+            -small_dist_bound <= r && r <= small_dist_bound;
+    }
+
+    template<typename Ext>
+    void theory_dense_diff_logic<Ext>::disable_small_dist() {
+        TRACE("ddl", tout << "disabling compact distance matrix\n";);
+        m_small_dist = false;
+        m_dist.reset();
+    }
+
+    /**
+       \brief Assign the distance d(y, s) + k + d(t, x) to the cell (y, x), where
+       s --k--> t is the last edge. new_dist is the same value computed over
+       the compact distance matrix. Set overflow to true if new_dist does not
+       fit in the bounds of the compact distance matrix.
+    */
+    template<typename Ext>
+    inline void theory_dense_diff_logic<Ext>::relax_small_cell(theory_var y, theory_var x, int new_dist, edge_id new_edge_id, bool & overflow) {
+        edge const & last = m_edges[new_edge_id];
+        cell & y_x = m_matrix[y][x];
+        m_cell_trail.push_back(cell_trail(y, x, y_x.m_edge_id, y_x.m_distance));
+        y_x.m_edge_id  = new_edge_id;
+        y_x.m_distance = m_matrix[y][last.m_source].m_distance;
+        y_x.m_distance += last.m_offset;
+        y_x.m_distance += m_matrix[last.m_target][x].m_distance;
+        m_dist[y][x]   = new_dist;
+        if (new_dist > small_dist_bound || new_dist < -small_dist_bound)
+            overflow = true;
+        if (!y_x.m_occs.empty()) {
+            propagate_using_cell(y, x);
+        }
+    }
+
+    /**
+       \brief Version of update_cells that works on the compact distance matrix.
+       When the set F of improved targets is a large fraction of the nodes,
+       each row y is first scanned with a branch-free loop over contiguous
+       integers (which the compiler vectorizes), and only rows that contain
+       an improvement are updated.
+    */
+    template<typename Ext>
+    void theory_dense_diff_logic<Ext>::update_cells_small(int k) {
+        edge_id new_edge_id = m_edges.size() - 1;
+        edge & last         = m_edges.back();
+        theory_var s        = last.m_source;
+        theory_var t        = last.m_target;
+        int num_vars        = m_dist.size();
+
+        // Compute set F of nodes such that:
+        // x in F iff
+        //    k + d(t, x) < d(s, x)
+        // f_dist[x] is k + d(t, x) for x in F, and null_dist otherwise.
+        svector<int> & targets = m_small_targets;
+        svector<int> & f_dist  = m_small_new_dist;
+        targets.reset();
+        f_dist.reset();
+        f_dist.resize(num_vars, null_dist);
+        int const * t_row = m_dist[t].c_ptr();
+        int const * s_row = m_dist[s].c_ptr();
+        for (int x = 0; x < num_vars; ++x) {
+            int d_t_x = t_row[x];
+            if (d_t_x != null_dist && x != s && k + d_t_x < s_row[x]) {
+                f_dist[x] = k + d_t_x;
+                targets.push_back(x);
+            }
+        }
+
+        // For each node y such that y --> s, and for each node x in F,
+        // check whether d(y, s) + f_dist[x] < d(y, x).
+        // Distances are bounded by small_dist_bound, so the sums below do not overflow.
+        bool dense    = 4 * targets.size() > static_cast<unsigned>(num_vars);
+        bool overflow = false;
+        int const * f = f_dist.c_ptr();
+        for (int y = 0; !targets.empty() && y < num_vars; ++y) {
+            if (y == t)
+                continue;
+            int d_y_s = m_dist[y][s];
+            if (d_y_s == null_dist)
+                continue;
+            int const * y_row = m_dist[y].c_ptr();
+            if (dense) {
+                m_stats.m_num_dense_relaxations++;
+                int improved = 0;
+                for (int x = 0; x < num_vars; ++x)
+                    improved |= (f[x] != null_dist) & (d_y_s + f[x] < y_row[x]);
+                if (!improved)
+                    continue;
+                for (int x = 0; x < num_vars; ++x) {
+                    if (f[x] != null_dist && x != y && d_y_s + f[x] < y_row[x])
+                        relax_small_cell(y, x, d_y_s + f[x], new_edge_id, overflow);
+                }
+            }
+            else {
+                unsigned num_targets = targets.size();
+                for (unsigned i = 0; i < num_targets; ++i) {
+                    int x = targets[i];
+                    if (x != y && d_y_s + f[x] < y_row[x])
+                        relax_small_cell(y, x, d_y_s + f[x], new_edge_id, overflow);
+                }
+            }
+        }
+        if (overflow)
+            disable_small_dist();
+        CASSERT("ddl", check_matrix());
+    }
+
     template<typename Ext>
     void theory_dense_diff_logic<Ext>::assign_literal(literal l, theory_var source, theory_var target) {
         context & ctx = get_context();
@@ -622,6 +769,7 @@ namespace smt {
         for (; it != end; ++it) {
             SASSERT(it->size() == m_matrix.size());
         }
+        SASSERT(!m_small_dist || m_dist.size() == m_matrix.size());
         return true;
     }
 
@@ -648,6 +796,12 @@ namespace smt {
                         SASSERT(c.m_distance == k);
                     }
                 }
+                if (m_small_dist) {
+                    int d = null_dist;
+                    if (c.m_edge_id != null_edge_id)
+                        VERIFY(to_small_dist(c.m_distance, d));
+                    SASSERT(m_dist[i][j] == d);
+                }
             }
         }
         return true;
@@ -700,6 +854,7 @@ namespace smt {
     void theory_dense_diff_logic<Ext>::collect_statistics(::statistics & st) const {
         st.update("dd assertions", m_stats.m_num_assertions);
         st.update("dd propagations", m_stats.m_num_propagations);
+        st.update("dd dense relaxations", m_stats.m_num_dense_relaxations);
         m_arith_eq_adapter.collect_statistics(st);
     }
 
@@ -39,6 +39,24 @@ namespace smt {
         }
     };
 
+    class fpa_abstraction_trail_elem : public trail<theory_fpa> {
+        ast_manager & m;
+        obj_map<expr, app*> & m_abstractions;
+        expr * m_t;
+    public:
+        fpa_abstraction_trail_elem(ast_manager & m, obj_map<expr, app*> & a, expr * t) :
+            m(m), m_abstractions(a), m_t(t) {}
+        virtual ~fpa_abstraction_trail_elem() {}
+        virtual void undo(theory_fpa & th) {
+            app * k = 0;
+            if (m_abstractions.find(m_t, k)) {
+                m_abstractions.remove(m_t);
+                m.dec_ref(k);
+                m.dec_ref(m_t);
+            }
+        }
+    };
+
     void theory_fpa::fpa2bv_converter_wrapped::mk_const(func_decl * f, expr_ref & result) {
         SASSERT(f->get_family_id() == null_family_id);
         SASSERT(f->get_arity() == 0);
@@ -143,7 +161,9 @@ namespace smt {
         m_fpa_util(m_converter.fu()),
         m_bv_util(m_converter.bu()),
         m_arith_util(m_converter.au()),
-        m_is_initialized(false)
+        m_is_initialized(false),
+        m_lazy_ops(false),
+        m_restart_refine(m)
     {
         params_ref p;
         p.set_bool("arith_lhs", true);
@@ -157,6 +177,7 @@ namespace smt {
             dec_ref_map_values(m, m_conversions);
             dec_ref_map_values(m, m_wraps);
             dec_ref_map_values(m, m_unwraps);
+            dec_ref_map_key_values(m, m_abstractions);
         }
         else {
             SASSERT(m_conversions.empty());
@@ -170,6 +191,7 @@ namespace smt {
     void theory_fpa::init(context * ctx) {
         smt::theory::init(ctx);
         m_is_initialized = true;
+        m_lazy_ops = ctx->get_fparams().m_fpa_lazy_ops;
     }
 
     app * theory_fpa::fpa_value_proc::mk_value(model_generator & mg, ptr_vector<expr> & values) {
@@ -332,7 +354,7 @@ namespace smt {
         TRACE("t_fpa_detail", tout << "converting atom: " << mk_ismt2_pp(e, get_manager()) << "\n";);
         expr_ref res(m);
         proof_ref pr(m);
-        m_rw(e, res);
+        m_rw(abstract(e), res);
         m_th_rw(res, res);
         SASSERT(is_app(res));
         SASSERT(m.is_bool(res));
@@ -345,7 +367,7 @@ namespace smt {
 
         expr_ref e_conv(m), res(m);
         proof_ref pr(m);
-        m_rw(e, e_conv);
+        m_rw(abstract(e), e_conv);
 
         if (is_app(e_conv) && to_app(e_conv)->get_family_id() != get_family_id()) {
             if (!m_fpa_util.is_float(e_conv))
@@ -447,7 +469,7 @@ namespace smt {
 
         SASSERT(m_arith_util.is_real(e) || m_bv_util.is_bv(e));
 
-        m_rw(e, res);
+        m_rw(abstract(e), res);
         m_th_rw(res, res);
         return res;
     }
@@ -592,8 +614,9 @@ namespace smt {
         enode * e = (ctx.e_internalized(term)) ? ctx.get_enode(term) :
                                                  ctx.mk_enode(term, false, false, true);
 
+        // term may have been internalized while its arguments were internalized.
         if (is_attached_to_var(e))
-            return false;
+            return true;
 
         attach_new_th_var(e);
 
@@ -816,15 +839,342 @@ namespace smt {
         dec_ref_map_values(m, m_conversions);
         dec_ref_map_values(m, m_wraps);
         dec_ref_map_values(m, m_unwraps);
+        dec_ref_map_key_values(m, m_abstractions);
+        m_abs_terms.reset();
+        m_refined.reset();
+        m_restart_refine.reset();
         theory::reset_eh();
     }
 
     final_check_status theory_fpa::final_check_eh() {
         TRACE("t_fpa", tout << "final_check_eh\n";);
         SASSERT(m_converter.m_extra_assertions.empty());
+        if (m_lazy_ops && !check_abstractions())
+            return FC_CONTINUE;
         return FC_DONE;
     }
 
+    /**
+       \brief The definitions asserted by refine() above the search level
+       are removed on backtracking. Assert them again at the search level,
+       where they are kept until the abstraction itself is removed.
+    */
+    void theory_fpa::restart_eh() {
+        expr_ref_vector ts(get_manager());
+        ts.swap(m_restart_refine);
+        for (unsigned i = 0; i < ts.size(); i++) {
+            app * t = to_app(ts.get(i));
+            if (m_abstractions.contains(t) && !m_refined.contains(t))
+                refine(t);
+        }
+    }
+
+    bool theory_fpa::is_lazy_op(expr * e) const {
+        if (!is_app(e) || to_app(e)->get_family_id() != get_family_id())
+            return false;
+        switch (to_app(e)->get_decl_kind()) {
+        case OP_FPA_MUL:
+        case OP_FPA_DIV:
+        case OP_FPA_SQRT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+       \brief Replace the fp.mul, fp.div and fp.sqrt terms in \c e by
+       abstraction constants. The bit-blasted definition of an
+       abstraction is only asserted by refine() once the candidate
+       model disagrees with the floating-point semantics of the term.
+    */
+    expr_ref theory_fpa::abstract(expr * e) {
+        ast_manager & m = get_manager();
+        expr_ref res(e, m);
+        if (!m_lazy_ops)
+            return res;
+        obj_map<expr, expr*> cache;
+        expr_ref_vector pinned(m);
+        abstract_core(e, cache, pinned);
+        res = cache.find(e);
+        return res;
+    }
+
+    void theory_fpa::abstract_core(expr * e, obj_map<expr, expr*> & cache, expr_ref_vector & pinned) {
+        if (cache.contains(e))
+            return;
+        if (!is_app(e) || to_app(e)->get_num_args() == 0) {
+            cache.insert(e, e);
+            return;
+        }
+        ast_manager & m = get_manager();
+        app * a = to_app(e);
+        ptr_buffer<expr> new_args;
+        bool changed = false;
+        for (unsigned i = 0; i < a->get_num_args(); i++) {
+            expr * arg = a->get_arg(i);
+            abstract_core(arg, cache, pinned);
+            expr * new_arg = cache.find(arg);
+            changed |= new_arg != arg;
+            new_args.push_back(new_arg);
+        }
+        expr * r = a;
+        if (is_lazy_op(a))
+            r = mk_abstraction(a, new_args.c_ptr());
+        else if (changed) {
+            r = m.mk_app(a->get_decl(), new_args.size(), new_args.c_ptr());
+            pinned.push_back(r);
+        }
+        cache.insert(e, r);
+    }
+
+    app * theory_fpa::mk_abstraction(app * t, expr * const * new_args) {
+        ast_manager & m = get_manager();
+        app * k = 0;
+        if (m_abstractions.find(t, k))
+            return k;
+        k = m.mk_fresh_const("fpa", m.get_sort(t));
+        m.inc_ref(t);
+        m.inc_ref(k);
+        m_abstractions.insert(t, k);
+        m_trail_stack.push(fpa_abstraction_trail_elem(m, m_abstractions, t));
+        m_abs_terms.push_back(t);
+        m_trail_stack.push(push_back_trail<theory_fpa, expr*, false>(m_abs_terms));
+        m_stats.m_num_abstractions++;
+        TRACE("t_fpa", tout << "abstracting " << mk_ismt2_pp(t, m) << " by " << mk_ismt2_pp(k, m) << "\n";);
+        // k must have an enode before (bv_wrap k) is internalized, otherwise
+        // the sort constraint of k re-enters the internalization of (bv_wrap k).
+        get_context().internalize(k, false);
+        mk_abstraction_lemmas(t, k, new_args);
+        return k;
+    }
+
+    /**
+       \brief Assert cheap facts about the abstraction \c k of \c t: NaN
+       propagation and the sign of products, quotients and square roots.
+       They are stated over floating-point predicates, which are blasted
+       to a handful of bits. Like the abstraction, they are removed when
+       the scope in which \c k was created is popped.
+    */
+    void theory_fpa::mk_abstraction_lemmas(app * t, app * k, expr * const * new_args) {
+        ast_manager & m = get_manager();
+        fpa_util & fu = m_fpa_util;
+        expr_ref_vector lemmas(m);
+        expr_ref k_nan(fu.mk_is_nan(k), m);
+        // argument 0 is the rounding mode
+        for (unsigned i = 1; i < t->get_num_args(); i++)
+            lemmas.push_back(m.mk_implies(fu.mk_is_nan(new_args[i]), k_nan));
+        switch (t->get_decl_kind()) {
+        case OP_FPA_MUL:
+        case OP_FPA_DIV: {
+            expr_ref sgn(m);
+            sgn = m.mk_not(m.mk_iff(fu.mk_is_negative(new_args[1]), fu.mk_is_negative(new_args[2])));
+            lemmas.push_back(m.mk_or(k_nan, m.mk_iff(fu.mk_is_negative(k), sgn)));
+            break;
+        }
+        case OP_FPA_SQRT: {
+            expr_ref x_neg(m);
+            x_neg = m.mk_and(fu.mk_is_negative(new_args[1]), m.mk_not(fu.mk_is_zero(new_args[1])));
+            lemmas.push_back(m.mk_implies(x_neg, k_nan));
+            lemmas.push_back(m.mk_or(k_nan, fu.mk_is_zero(k), fu.mk_is_positive(k)));
+            break;
+        }
+        default:
+            UNREACHABLE();
+        }
+        for (unsigned i = 0; i < lemmas.size(); i++) {
+            expr_ref c(lemmas.get(i), m);
+            m_th_rw(c);
+            m_stats.m_num_abstraction_lemmas++;
+            assert_cnstr(c);
+        }
+    }
+
+    bool theory_fpa::get_bv_value(expr * e, rational & r) {
+        context & ctx = get_context();
+        family_id bv_fid = m_bv_util.get_family_id();
+        if (!ctx.e_internalized(e) || ctx.get_enode(e)->get_th_var(bv_fid) == null_theory_var)
+            return false;
+        theory_bv * bv_th = static_cast<theory_bv*>(ctx.get_theory(bv_fid));
+        return bv_th->get_fixed_value(to_app(e), r);
+    }
+
+    bool theory_fpa::eval_rm(expr * e, mpf_rounding_mode & rm) {
+        if (m_fpa_util.is_rm_numeral(e, rm))
+            return true;
+        rational r;
+        if (!get_bv_value(wrap(e), r))
+            return false;
+        switch (r.get_unsigned()) {
+        case BV_RM_TIES_TO_EVEN: rm = MPF_ROUND_NEAREST_TEVEN; return true;
+        case BV_RM_TIES_TO_AWAY: rm = MPF_ROUND_NEAREST_TAWAY; return true;
+        case BV_RM_TO_POSITIVE: rm = MPF_ROUND_TOWARD_POSITIVE; return true;
+        case BV_RM_TO_NEGATIVE: rm = MPF_ROUND_TOWARD_NEGATIVE; return true;
+        case BV_RM_TO_ZERO: rm = MPF_ROUND_TOWARD_ZERO; return true;
+        default: return false;
+        }
+    }
+
+    /**
+       \brief Evaluate the (abstracted) floating-point term \c e in the
+       current assignment. Terms with a fixed bit-vector representation
+       are read off the bit assignment, the remaining ones are computed
+       with mpf_manager. Return false if \c e cannot be evaluated.
+    */
+    bool theory_fpa::eval(expr * e, scoped_mpf & r) {
+        ast_manager & m = get_manager();
+        mpf_manager & mpfm = m_fpa_util.fm();
+        if (m_fpa_util.is_numeral(e, r))
+            return true;
+
+        rational bits;
+        if (get_bv_value(wrap(e), bits)) {
+            sort * s = m.get_sort(e);
+            unsigned ebits = m_fpa_util.get_ebits(s);
+            unsigned sbits = m_fpa_util.get_sbits(s);
+            unsynch_mpz_manager & mpzm = mpfm.mpz_manager();
+            scoped_mpz all_z(mpzm), sgn_z(mpzm), exp_z(mpzm), bias(mpzm);
+            mpzm.set(all_z, bits.to_mpq().numerator());
+            mpzm.machine_div2k(all_z, ebits + sbits - 1, sgn_z);
+            mpzm.mod(all_z, mpfm.m_powers2(ebits + sbits - 1), all_z);
+            mpzm.machine_div2k(all_z, sbits - 1, exp_z);
+            mpzm.mod(all_z, mpfm.m_powers2(sbits - 1), all_z);
+            mpzm.power(mpz(2), ebits - 1, bias);
+            mpzm.dec(bias);
+            scoped_mpz exp_u = exp_z - bias;
+            SASSERT(mpzm.is_int64(exp_u));
+            mpfm.set(r, ebits, sbits, mpzm.is_one(sgn_z), all_z, mpzm.get_int64(exp_u));
+            return true;
+        }
+
+        if (!is_app(e) || to_app(e)->get_family_id() != get_family_id())
+            return false;
+
+        app * a = to_app(e);
+        mpf_rounding_mode rm;
+        scoped_mpf x(mpfm), y(mpfm);
+        switch (a->get_decl_kind()) {
+        case OP_FPA_NEG:
+            if (!eval(a->get_arg(0), x)) return false;
+            mpfm.neg(x, r);
+            return true;
+        case OP_FPA_ABS:
+            if (!eval(a->get_arg(0), x)) return false;
+            mpfm.abs(x, r);
+            return true;
+        case OP_FPA_ADD:
+        case OP_FPA_SUB:
+        case OP_FPA_MUL:
+        case OP_FPA_DIV:
+            if (!eval_rm(a->get_arg(0), rm) || !eval(a->get_arg(1), x) || !eval(a->get_arg(2), y))
+                return false;
+            switch (a->get_decl_kind()) {
+            case OP_FPA_ADD: mpfm.add(rm, x, y, r); break;
+            case OP_FPA_SUB: mpfm.sub(rm, x, y, r); break;
+            case OP_FPA_MUL: mpfm.mul(rm, x, y, r); break;
+            default: mpfm.div(rm, x, y, r); break;
+            }
+            return true;
+        case OP_FPA_SQRT:
+            if (!eval_rm(a->get_arg(0), rm) || !eval(a->get_arg(1), x)) return false;
+            mpfm.sqrt(rm, x, r);
+            return true;
+        case OP_FPA_ROUND_TO_INTEGRAL:
+            if (!eval_rm(a->get_arg(0), rm) || !eval(a->get_arg(1), x)) return false;
+            mpfm.round_to_integral(rm, x, r);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void theory_fpa::refine(app * t) {
+        ast_manager & m = get_manager();
+        app * k = m_abstractions.find(t);
+        TRACE("t_fpa", tout << "refining " << mk_ismt2_pp(k, m) << " := " << mk_ismt2_pp(t, m) << "\n";);
+
+        expr_ref_vector new_args(m);
+        for (unsigned i = 0; i < t->get_num_args(); i++)
+            new_args.push_back(abstract(t->get_arg(i)));
+
+        expr_ref def(m), def_conv(m), k_conv(m), c(m);
+        def = m.mk_app(t->get_decl(), new_args.size(), new_args.c_ptr());
+        m_rw(def, def_conv);
+        k_conv = convert(k);
+        m_converter.mk_eq(k_conv, def_conv, c);
+        c = m.mk_and(c, mk_side_conditions());
+        m_th_rw(c);
+        assert_cnstr(c);
+
+        m_refined.insert(t);
+        m_trail_stack.push(insert_obj_trail<theory_fpa, expr>(m_refined, t));
+        m_stats.m_num_refinements++;
+    }
+
+    /**
+       \brief Compare the value of every abstraction constant with the
+       value its term has under the current assignment, and bit-blast
+       the definitions of those that disagree (or cannot be evaluated).
+       Return true if the candidate model satisfies all abstractions.
+    */
+    bool theory_fpa::check_abstractions() {
+        mpf_manager & mpfm = m_fpa_util.fm();
+        m_stats.m_num_lazy_checks++;
+
+        ptr_vector<app> to_refine;
+        for (unsigned i = 0; i < m_abs_terms.size(); i++) {
+            app * t = to_app(m_abs_terms[i]);
+            if (m_refined.contains(t))
+                continue;
+            app * k = m_abstractions.find(t);
+
+            scoped_mpf k_val(mpfm), t_val(mpfm), x(mpfm), y(mpfm);
+            mpf_rounding_mode rm;
+            bool ok = eval(k, k_val) && eval_rm(t->get_arg(0), rm) && eval(abstract(t->get_arg(1)), x);
+            if (ok) {
+                switch (t->get_decl_kind()) {
+                case OP_FPA_MUL:
+                    ok = eval(abstract(t->get_arg(2)), y);
+                    if (ok) mpfm.mul(rm, x, y, t_val);
+                    break;
+                case OP_FPA_DIV:
+                    ok = eval(abstract(t->get_arg(2)), y);
+                    if (ok) mpfm.div(rm, x, y, t_val);
+                    break;
+                case OP_FPA_SQRT:
+                    mpfm.sqrt(rm, x, t_val);
+                    break;
+                default:
+                    UNREACHABLE();
+                }
+            }
+            if (ok) {
+                if (mpfm.is_nan(k_val) && mpfm.is_nan(t_val))
+                    continue;
+                if (!mpfm.is_nan(k_val) && !mpfm.is_nan(t_val) &&
+                    mpfm.eq(k_val, t_val) && mpfm.sgn(k_val) == mpfm.sgn(t_val))
+                    continue;
+            }
+            to_refine.push_back(t);
+        }
+
+        context & ctx = get_context();
+        for (unsigned i = 0; i < to_refine.size(); i++) {
+            refine(to_refine[i]);
+            if (ctx.get_scope_level() > ctx.get_search_level())
+                m_restart_refine.push_back(to_refine[i]);
+        }
+        TRACE("t_fpa", tout << "refined " << to_refine.size() << " of " << m_abs_terms.size() << " abstractions\n";);
+        return to_refine.empty();
+    }
+
+    void theory_fpa::collect_statistics(::statistics & st) const {
+        st.update("fpa abstractions", m_stats.m_num_abstractions);
+        st.update("fpa abstraction lemmas", m_stats.m_num_abstraction_lemmas);
+        st.update("fpa refinements", m_stats.m_num_refinements);
+        st.update("fpa lazy checks", m_stats.m_num_lazy_checks);
+    }
+
     void theory_fpa::init_model(model_generator & mg) {
         TRACE("t_fpa", tout << "initializing model" << std::endl; display(tout););
         m_factory = alloc(fpa_value_factory, get_manager(), get_family_id());
@@ -136,6 +136,15 @@ namespace smt {
             virtual app * mk_value(model_generator & mg, ptr_vector<expr> & values);
         };
 
+        struct stats {
+            unsigned m_num_abstractions;
+            unsigned m_num_abstraction_lemmas;
+            unsigned m_num_refinements;
+            unsigned m_num_lazy_checks;
+            void reset() { memset(this, 0, sizeof(*this)); }
+            stats() { reset(); }
+        };
+
     protected:
         fpa2bv_converter_wrapped  m_converter;
         fpa2bv_rewriter           m_rw;
@@ -149,6 +158,12 @@ namespace smt {
         obj_map<sort, func_decl*> m_unwraps;
         obj_map<expr, expr*>      m_conversions;
         bool                      m_is_initialized;
+        stats                     m_stats;
+        bool                      m_lazy_ops;
+        obj_map<expr, app*>       m_abstractions;    // fp.mul/fp.div/fp.sqrt term -> abstraction constant
+        ptr_vector<expr>          m_abs_terms;       // abstracted terms, in creation order
+        obj_hashtable<expr>       m_refined;         // abstracted terms whose bit-blasted definition was asserted
+        expr_ref_vector           m_restart_refine;  // terms refined above the search level, refined again in restart_eh()
 
         virtual final_check_status final_check_eh();
         virtual bool internalize_atom(app * atom, bool gate_ctx);
@@ -159,6 +174,7 @@ namespace smt {
         virtual void push_scope_eh();
         virtual void pop_scope_eh(unsigned num_scopes);
         virtual void reset_eh();
+        virtual void restart_eh();
         virtual theory* mk_fresh(context* new_ctx);
         virtual char const * get_name() const { return "fpa"; }
 
@@ -168,6 +184,7 @@ namespace smt {
         virtual void relevant_eh(app * n);
         virtual void init_model(model_generator & m);
         virtual void finalize_model(model_generator & mg);
+        virtual void collect_statistics(::statistics & st) const;
 
     public:
         theory_fpa(ast_manager & m);
@@ -187,6 +204,17 @@ namespace smt {
 
         void add_trail(ast * a);
 
+        bool is_lazy_op(expr * e) const;
+        expr_ref abstract(expr * e);
+        void abstract_core(expr * e, obj_map<expr, expr*> & cache, expr_ref_vector & pinned);
+        app * mk_abstraction(app * t, expr * const * new_args);
+        void mk_abstraction_lemmas(app * t, app * k, expr * const * new_args);
+        bool get_bv_value(expr * e, rational & r);
+        bool eval_rm(expr * e, mpf_rounding_mode & rm);
+        bool eval(expr * e, scoped_mpf & r);
+        void refine(app * t);
+        bool check_abstractions();
+
         void attach_new_th_var(enode * n);
         void assert_cnstr(expr * e);
 
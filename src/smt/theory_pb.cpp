@@ -237,6 +237,7 @@ namespace smt {
     {        
         m_learn_complements  = p.m_pb_learn_complements;
         m_conflict_frequency = p.m_pb_conflict_frequency;
+        m_conflict_division  = p.m_pb_conflict_division;
         m_enable_compilation = p.m_pb_enable_compilation;
         m_enable_simplex     = p.m_pb_enable_simplex;
     }
@@ -733,6 +734,8 @@ namespace smt {
         st.update("pb compilations", m_stats.m_num_compiles);
         st.update("pb compiled clauses", m_stats.m_num_compiled_clauses);
         st.update("pb compiled vars", m_stats.m_num_compiled_vars);
+        st.update("pb learned", m_stats.m_num_learned);
+        st.update("pb cuts", m_stats.m_num_cuts);
         m_simplex.collect_statistics(st);
     }
     
@@ -1546,6 +1549,10 @@ namespace smt {
             }
         }
         SASSERT(coeff2.is_pos());
+        if (m_conflict_division && conseq != null_literal && coeff2 > numeral::one() && 
+            process_ineq_cut(c, conseq, coeff1, coeff2)) {
+            return;
+        }
         numeral lc = lcm(coeff1, coeff2);
         numeral g = lc/coeff1;
         SASSERT(g.is_int());
@@ -1568,6 +1575,49 @@ namespace smt {
             m_ineq_literals.push_back(c.lit());
         }
     }
+
+    //
+    // Division based cut:
+    //
+    // . weaken c by removing the literals, other than conseq, that are not false.
+    // . divide the weakened inequality by coeff2 (the coefficient of conseq) 
+    //   and round up, so conseq gets coefficient 1.
+    // . multiply by coeff1 (the coefficient of ~conseq in m_lemma) and add to m_lemma.
+    //
+    // Unlike the lcm based resolution, m_lemma is not scaled, so coefficients
+    // stay bounded. Return false if the weakened inequality is trivial.
+    //
+    bool theory_pb::process_ineq_cut(ineq& c, literal conseq, numeral const& coeff1, numeral const& coeff2) {
+        context& ctx = get_context();
+        numeral k = c.k();
+        for (unsigned i = 0; i < c.size(); ++i) {
+            literal l = c.lit(i);
+            if (l != conseq && ctx.get_assignment(l) != l_false) {
+                k -= c.coeff(i);
+            }
+        }
+        if (!k.is_pos()) {
+            return false;
+        }
+        TRACE("pb", display(tout << "cut with divisor " << coeff2 << " ", c, true););
+        m_stats.m_num_cuts++;
+        m_lemma.m_k += coeff1*ceil(k/coeff2);
+        for (unsigned i = 0; i < c.size(); ++i) {
+            literal l = c.lit(i);
+            if (l == conseq) {
+                process_antecedent(l, coeff1);
+            }
+            else if (ctx.get_assignment(l) == l_false) {
+                process_antecedent(l, coeff1*ceil(c.coeff(i)/coeff2));
+            }
+        }
+
+        SASSERT(ctx.get_assignment(c.lit()) == l_true);
+        if (ctx.get_assign_level(c.lit()) > ctx.get_base_level()) {
+            m_ineq_literals.push_back(c.lit());
+        }
+        return true;
+    }
         
     //
     // modeled after sat_solver/smt_context
@@ -1762,6 +1812,7 @@ namespace smt {
             break;
         default: {
             app_ref tmp = m_lemma.to_expr(false, ctx, get_manager());
+            m_stats.m_num_learned++;
             internalize_atom(tmp, false);
             ctx.mark_as_relevant(tmp.get());
             literal l(ctx.get_bool_var(tmp));
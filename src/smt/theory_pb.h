@@ -99,6 +99,8 @@ namespace smt {
             unsigned m_num_compiles;
             unsigned m_num_compiled_vars;
             unsigned m_num_compiled_clauses;
+            unsigned m_num_learned;
+            unsigned m_num_cuts;
             void reset() { memset(this, 0, sizeof(*this)); }
             stats() { reset(); }
         };
@@ -215,6 +217,7 @@ namespace smt {
         bool                     m_learn_complements;
         bool                     m_enable_compilation;
         bool                     m_enable_simplex;
+        bool                     m_conflict_division;
         rational                 m_max_compiled_coeff;
 
         // internalize_atom:
@@ -280,6 +283,7 @@ namespace smt {
         bool resolve_conflict(ineq& c);
         void process_antecedent(literal l, numeral coeff);
         void process_ineq(ineq& c, literal conseq, numeral coeff);
+        bool process_ineq_cut(ineq& c, literal conseq, numeral const& coeff1, numeral const& coeff2);
         void remove_from_lemma(unsigned idx);
         bool is_proof_justification(justification const& j) const;
 
@@ -16,10 +16,13 @@ Author:
 Notes:
 
 --*/
+#include<algorithm>
 #include"aig.h"
 #include"goal.h"
 #include"ast_smt2_pp.h"
 #include"cooperate.h"
+#include"sat_solver.h"
+#include"statistics.h"
 
 #define USE_TWO_LEVEL_RULES
 #define FIRST_NODE_ID (UINT_MAX/2)
@@ -120,6 +123,16 @@ struct aig_manager::imp {
     bool                     m_default_gate_encoding;
     unsigned long long       m_max_memory;
 
+    struct fraig_stats {
+        unsigned m_sat_calls;
+        unsigned m_cex;
+        unsigned m_merged;
+        unsigned m_rewrites;
+        fraig_stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+    fraig_stats              m_fraig_stats;
+
     void dec_ref_core(aig * n) {
         SASSERT(n->m_ref_count > 0);
         n->m_ref_count--;
@@ -1301,6 +1314,636 @@ struct aig_manager::imp {
         }
     };
 
+    /**
+       \brief Functional reduction (fraiging) of an AIG.
+
+       The AIG is rebuilt bottom-up. Each new node is first simplified using the
+       cuts with at most 4 leaves of the new AIG: a node whose function on one of
+       these cuts is a constant, a literal or the conjunction of two literals is
+       replaced by the corresponding (smaller) AIG.
+
+       Then, the node is compared with the nodes that have the same simulation
+       signature up to complement. Signatures are computed by simulating the
+       input AIG on random 64-bit words (64 patterns in parallel). A candidate
+       equivalence is checked using a SAT solver; if it is refuted, the
+       counterexample is added to the simulation patterns, and the signatures
+       are refined. Proven equivalences are merged.
+    */
+    struct fraig_proc {
+        static const unsigned MAX_CUT_SIZE   = 4;
+        static const unsigned MAX_CUTS       = 8;
+        static const unsigned MAX_CEX_WORDS  = 64;
+        static const unsigned MAX_ATTEMPTS   = 2;
+
+        // truth tables of the leaves of a cut
+        static unsigned var_tt(unsigned i) {
+            static const unsigned tts[4] = { 0xAAAA, 0xCCCC, 0xF0F0, 0xFF00 };
+            return tts[i];
+        }
+
+        struct cut {
+            unsigned m_size;
+            unsigned m_tt;                     // truth table over the leaves (16 bits)
+            aig *    m_leaves[MAX_CUT_SIZE];   // sorted by id
+            bool operator==(cut const & c) const {
+                if (m_size != c.m_size || m_tt != c.m_tt)
+                    return false;
+                for (unsigned i = 0; i < m_size; i++)
+                    if (m_leaves[i] != c.m_leaves[i])
+                        return false;
+                return true;
+            }
+        };
+
+        struct cut_lt {
+            bool operator()(cut const & c1, cut const & c2) const { return c1.m_size < c2.m_size; }
+        };
+
+        struct sig_hash {
+            fraig_proc const * m_owner;
+            sig_hash(fraig_proc const * o = 0):m_owner(o) {}
+            unsigned operator()(unsigned idx) const { return m_owner->sig_hash_core(idx); }
+        };
+
+        struct sig_eq {
+            fraig_proc const * m_owner;
+            sig_eq(fraig_proc const * o = 0):m_owner(o) {}
+            bool operator()(unsigned idx1, unsigned idx2) const { return m_owner->sig_eq_core(idx1, idx2); }
+        };
+
+        typedef chashtable<unsigned, sig_hash, sig_eq> sig_table;
+
+        imp &                     m;
+        bool                      m_rewrite;
+        unsigned                  m_sim_words;
+        random_gen                m_rand;
+        // nodes of the input AIG in topological order, m_nodes[0] is the constant true
+        ptr_vector<aig>           m_nodes;
+        u_map<unsigned>           m_id2idx;
+        unsigned_vector           m_inputs;
+        // m_sim[k][i] is the k-th simulation word of m_nodes[i]
+        vector<svector<uint64> >  m_sim;
+        unsigned                  m_cex_bits;    // number of counterexamples in the last word
+        // m_nodes[i] is equivalent to m_map[i] in the new AIG
+        svector<aig_lit>          m_map;
+        unsigned                  m_num_processed;
+        sig_table                 m_table;
+        // literals of the new AIG that must be kept alive while this object exists
+        svector<aig_lit>          m_saved;
+        // cuts of the nodes in the new AIG, indexed using to_idx
+        svector<cut>              m_cuts;
+        unsigned_vector           m_cut_begin;
+        unsigned_vector           m_cut_end;
+        svector<cut>              m_new_cuts;
+        ptr_vector<aig>           m_todo;
+        bool                      m_use_sat;
+        sat::solver               m_solver;
+        u_map<sat::bool_var>      m_id2var;
+
+        static params_ref mk_sat_params(params_ref const & p) {
+            params_ref sp;
+            sp.set_uint("max_conflicts", p.get_uint("aig_fraig_max_conflicts", 100000));
+            return sp;
+        }
+
+        fraig_proc(imp & _m, params_ref const & p):
+            m(_m),
+            m_rewrite(p.get_bool("aig_fraig_rewrite", true)),
+            m_sim_words(std::max(1u, p.get_uint("aig_fraig_sim_words", 4))),
+            m_rand(p.get_uint("random_seed", 0)),
+            m_cex_bits(0),
+            m_num_processed(0),
+            m_table(sig_hash(this), sig_eq(this)),
+            m_use_sat(p.get_uint("aig_fraig_max_conflicts", 100000) > 0),
+            m_solver(mk_sat_params(p), _m.m().limit(), 0) {
+        }
+
+        ~fraig_proc() {
+            for (unsigned i = 0; i < m_saved.size(); i++)
+                m.dec_ref_core(m_saved[i]);
+            m.process_to_delete();
+        }
+
+        void save(aig_lit const & l) {
+            m.inc_ref(l);
+            m_saved.push_back(l);
+        }
+
+        // -----------------------------------
+        //
+        // Simulation
+        //
+        // -----------------------------------
+
+        bool phase(unsigned idx) const { return (m_sim[0][idx] & 1) != 0; }
+
+        uint64 norm_word(unsigned k, unsigned idx) const {
+            uint64 w = m_sim[k][idx];
+            return phase(idx) ? ~w : w;
+        }
+
+        unsigned sig_hash_core(unsigned idx) const {
+            unsigned h = 0;
+            for (unsigned k = 0; k < m_sim.size(); k++) {
+                uint64 w = norm_word(k, idx);
+                h = hash_u_u(h, static_cast<unsigned>(w ^ (w >> 32)));
+            }
+            return h;
+        }
+
+        bool sig_eq_core(unsigned idx1, unsigned idx2) const {
+            for (unsigned k = 0; k < m_sim.size(); k++)
+                if (norm_word(k, idx1) != norm_word(k, idx2))
+                    return false;
+            return true;
+        }
+
+        uint64 random_word() {
+            uint64 r = 0;
+            for (unsigned i = 0; i < 5; i++)
+                r = (r << 15) ^ static_cast<uint64>(m_rand());
+            return r;
+        }
+
+        static uint64 lit_word(svector<uint64> const & w, unsigned idx, aig_lit const & l) {
+            return l.is_inverted() ? ~w[idx] : w[idx];
+        }
+
+        void simulate(svector<uint64> & w) {
+            unsigned sz = m_nodes.size();
+            for (unsigned i = 0; i < sz; i++) {
+                aig * n = m_nodes[i];
+                if (is_var(n))
+                    continue;
+                aig_lit l = left(n);
+                aig_lit r = right(n);
+                unsigned idx_l = 0, idx_r = 0;
+                m_id2idx.find(id(l), idx_l);
+                m_id2idx.find(id(r), idx_r);
+                w[i] = lit_word(w, idx_l, l) & lit_word(w, idx_r, r);
+            }
+        }
+
+        void add_word() {
+            m_sim.push_back(svector<uint64>());
+            svector<uint64> & w = m_sim.back();
+            w.resize(m_nodes.size(), 0);
+            w[0] = ~static_cast<uint64>(0);
+            for (unsigned i = 0; i < m_inputs.size(); i++)
+                w[m_inputs[i]] = random_word();
+            simulate(w);
+        }
+
+        void rebuild_table() {
+            m_table.reset();
+            for (unsigned i = 0; i < m_num_processed; i++)
+                m_table.insert_if_not_there(i);
+        }
+
+        /**
+           \brief Add the model of the SAT solver to the simulation patterns.
+           Return false if the maximal number of patterns was reached.
+        */
+        bool add_cex() {
+            if (m_sim.size() == m_sim_words || m_cex_bits == 64) {
+                if (m_sim.size() >= m_sim_words + MAX_CEX_WORDS)
+                    return false;
+                add_word();
+                m_cex_bits = 0;
+            }
+            m.m_fraig_stats.m_cex++;
+            sat::model const & mdl = m_solver.get_model();
+            svector<uint64> & w    = m_sim.back();
+            uint64 bit             = static_cast<uint64>(1) << m_cex_bits;
+            for (unsigned i = 0; i < m_inputs.size(); i++) {
+                unsigned idx = m_inputs[i];
+                sat::bool_var v;
+                if (!m_id2var.find(m_nodes[idx]->m_id, v) || v >= mdl.size())
+                    continue; // keep random value
+                if (mdl[v] == l_true)
+                    w[idx] |= bit;
+                else
+                    w[idx] &= ~bit;
+            }
+            m_cex_bits++;
+            simulate(w);
+            rebuild_table();
+            return true;
+        }
+
+        // -----------------------------------
+        //
+        // SAT sweeping
+        //
+        // -----------------------------------
+
+        sat::literal to_lit(aig_lit const & l) {
+            sat::bool_var v = sat::null_bool_var;
+            m_id2var.find(id(l), v);
+            SASSERT(v != sat::null_bool_var);
+            return sat::literal(v, l.is_inverted());
+        }
+
+        void encode(aig * p) {
+            SASSERT(m_todo.empty());
+            m_todo.push_back(p);
+            while (!m_todo.empty()) {
+                aig * n = m_todo.back();
+                if (m_id2var.contains(n->m_id)) {
+                    m_todo.pop_back();
+                    continue;
+                }
+                if (is_var(n)) {
+                    sat::bool_var v = m_solver.mk_var(true);
+                    m_id2var.insert(n->m_id, v);
+                    if (n->m_id == 0) {
+                        sat::literal t(v, false);
+                        m_solver.mk_clause(1, &t);
+                    }
+                    m_todo.pop_back();
+                    continue;
+                }
+                bool visited = true;
+                for (unsigned i = 0; i < 2; i++) {
+                    aig * c = n->m_children[i].ptr();
+                    if (!m_id2var.contains(c->m_id)) {
+                        m_todo.push_back(c);
+                        visited = false;
+                    }
+                }
+                if (!visited)
+                    continue;
+                m_todo.pop_back();
+                sat::bool_var v = m_solver.mk_var(true);
+                m_id2var.insert(n->m_id, v);
+                sat::literal l(v, false);
+                sat::literal a = to_lit(left(n));
+                sat::literal b = to_lit(right(n));
+                m_solver.mk_clause(~l, a);
+                m_solver.mk_clause(~l, b);
+                m_solver.mk_clause(l, ~a, ~b);
+            }
+        }
+
+        /**
+           \brief Return l_true if a and b are equivalent, l_false if the solver found
+           a counterexample (it is stored in the model of the solver), and l_undef if
+           the conflict budget was exhausted.
+        */
+        lbool check_equiv(aig_lit const & a, aig_lit const & b) {
+            encode(a.ptr());
+            encode(b.ptr());
+            sat::literal la = to_lit(a);
+            sat::literal lb = to_lit(b);
+            for (unsigned k = 0; k < 2; k++) {
+                sat::literal asms[2] = { k == 0 ? la : ~la, k == 0 ? ~lb : lb };
+                m.m_fraig_stats.m_sat_calls++;
+                lbool r = m_solver.check(2, asms);
+                // the model of the solver is preserved
+                m_solver.pop_to_base_level();
+                if (r != l_false)
+                    return r == l_true ? l_false : l_undef;
+            }
+            m_solver.mk_clause(~la, lb);
+            m_solver.mk_clause(la, ~lb);
+            return l_true;
+        }
+
+        aig_lit sweep(unsigned i, aig_lit nl) {
+            m_map[i]        = nl;
+            m_num_processed = i + 1;
+            if (!m_use_sat)
+                return nl;
+            for (unsigned attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+                unsigned j = m_table.insert_if_not_there(i);
+                if (j == i)
+                    return nl;
+                aig_lit c = m_map[j];
+                if (phase(i) != phase(j))
+                    c.invert();
+                if (c.ptr() == nl.ptr())
+                    return nl;
+                switch (check_equiv(nl, c)) {
+                case l_true:
+                    TRACE("aig_fraig", tout << "merged "; m.display_ref(tout, nl); tout << " "; m.display_ref(tout, c); tout << "\n";);
+                    m.m_fraig_stats.m_merged++;
+                    m_map[i] = c;
+                    return c;
+                case l_undef:
+                    IF_VERBOSE(10, verbose_stream() << "(aig.fraig :conflict-budget-exhausted)\n";);
+                    m_use_sat = false;
+                    return nl;
+                default:
+                    if (!add_cex())
+                        return nl;
+                    break;
+                }
+            }
+            return nl;
+        }
+
+        // -----------------------------------
+        //
+        // Cut based rewriting
+        //
+        // -----------------------------------
+
+        static bool depends_on(unsigned tt, unsigned i) {
+            unsigned vt = var_tt(i);
+            return ((tt & vt) >> (1u << i)) != (tt & ~vt & 0xFFFF);
+        }
+
+        // Remove the i-th leaf of c. The function must not depend on it.
+        static void remove_leaf(cut & c, unsigned i) {
+            SASSERT(!depends_on(c.m_tt, i));
+            unsigned new_size = c.m_size - 1;
+            unsigned tt = 0;
+            for (unsigned mt = 0; mt < 16; mt++) {
+                unsigned nmt = mt & ((1u << new_size) - 1);
+                unsigned omt = (nmt & ((1u << i) - 1)) | ((nmt >> i) << (i + 1));
+                if ((c.m_tt >> omt) & 1)
+                    tt |= 1u << mt;
+            }
+            for (unsigned k = i; k < new_size; k++)
+                c.m_leaves[k] = c.m_leaves[k+1];
+            c.m_size = new_size;
+            c.m_tt   = tt;
+        }
+
+        static void minimize(cut & c) {
+            unsigned i = c.m_size;
+            while (i > 0) {
+                --i;
+                if (!depends_on(c.m_tt, i))
+                    remove_leaf(c, i);
+            }
+        }
+
+        // Truth table of c over the leaves of r, r must contain the leaves of c.
+        static unsigned expand(cut const & c, cut const & r) {
+            unsigned pos[MAX_CUT_SIZE];
+            unsigned j = 0;
+            for (unsigned i = 0; i < c.m_size; i++) {
+                while (r.m_leaves[j] != c.m_leaves[i])
+                    j++;
+                pos[i] = j;
+            }
+            unsigned tt = 0;
+            for (unsigned mt = 0; mt < 16; mt++) {
+                unsigned cmt = 0;
+                for (unsigned i = 0; i < c.m_size; i++)
+                    if ((mt >> pos[i]) & 1)
+                        cmt |= 1u << i;
+                if ((c.m_tt >> cmt) & 1)
+                    tt |= 1u << mt;
+            }
+            return tt;
+        }
+
+        static bool merge(cut const & c1, bool inv1, cut const & c2, bool inv2, cut & r) {
+            unsigned i = 0, j = 0, k = 0;
+            while (i < c1.m_size || j < c2.m_size) {
+                aig * n;
+                if (j == c2.m_size || (i < c1.m_size && c1.m_leaves[i]->m_id < c2.m_leaves[j]->m_id))
+                    n = c1.m_leaves[i++];
+                else if (i == c1.m_size || c2.m_leaves[j]->m_id < c1.m_leaves[i]->m_id)
+                    n = c2.m_leaves[j++];
+                else {
+                    n = c1.m_leaves[i++];
+                    j++;
+                }
+                if (k == MAX_CUT_SIZE)
+                    return false;
+                r.m_leaves[k++] = n;
+            }
+            r.m_size = k;
+            unsigned tt1 = expand(c1, r);
+            unsigned tt2 = expand(c2, r);
+            if (inv1) tt1 = ~tt1 & 0xFFFF;
+            if (inv2) tt2 = ~tt2 & 0xFFFF;
+            r.m_tt = tt1 & tt2;
+            minimize(r);
+            return true;
+        }
+
+        static void mk_leaf_cut(aig * n, cut & c) {
+            if (n->m_id == 0) {
+                c.m_size = 0;
+                c.m_tt   = 0xFFFF;
+            }
+            else {
+                c.m_size      = 1;
+                c.m_tt        = var_tt(0);
+                c.m_leaves[0] = n;
+            }
+        }
+
+        bool has_cuts(aig * n) const {
+            unsigned idx = to_idx(n);
+            return idx < m_cut_begin.size() && m_cut_begin[idx] != UINT_MAX;
+        }
+
+        void compute_cuts(aig * n) {
+            cut leaf_cuts[2];
+            cut const * begin[2];
+            cut const * end[2];
+            for (unsigned i = 0; i < 2; i++) {
+                aig * c = n->m_children[i].ptr();
+                if (is_var(c)) {
+                    mk_leaf_cut(c, leaf_cuts[i]);
+                    begin[i] = leaf_cuts + i;
+                    end[i]   = leaf_cuts + i + 1;
+                }
+                else {
+                    begin[i] = m_cuts.c_ptr() + m_cut_begin[to_idx(c)];
+                    end[i]   = m_cuts.c_ptr() + m_cut_end[to_idx(c)];
+                }
+            }
+            bool inv1 = left(n).is_inverted();
+            bool inv2 = right(n).is_inverted();
+            m_new_cuts.reset();
+            cut t;
+            mk_leaf_cut(n, t);
+            m_new_cuts.push_back(t);
+            for (cut const * c1 = begin[0]; c1 != end[0]; ++c1) {
+                for (cut const * c2 = begin[1]; c2 != end[1]; ++c2) {
+                    cut c;
+                    if (merge(*c1, inv1, *c2, inv2, c) && !m_new_cuts.contains(c))
+                        m_new_cuts.push_back(c);
+                }
+            }
+            // keep the trivial cut, and the smallest ones
+            std::stable_sort(m_new_cuts.begin() + 1, m_new_cuts.end(), cut_lt());
+            if (m_new_cuts.size() > MAX_CUTS)
+                m_new_cuts.shrink(MAX_CUTS);
+            unsigned idx = to_idx(n);
+            if (idx >= m_cut_begin.size()) {
+                m_cut_begin.resize(idx+1, UINT_MAX);
+                m_cut_end.resize(idx+1, UINT_MAX);
+            }
+            m_cut_begin[idx] = m_cuts.size();
+            m_cuts.append(m_new_cuts);
+            m_cut_end[idx]   = m_cuts.size();
+        }
+
+        void ensure_cuts(aig * p) {
+            SASSERT(m_todo.empty());
+            m_todo.push_back(p);
+            while (!m_todo.empty()) {
+                aig * n = m_todo.back();
+                if (has_cuts(n)) {
+                    m_todo.pop_back();
+                    continue;
+                }
+                bool visited = true;
+                for (unsigned i = 0; i < 2; i++) {
+                    aig * c = n->m_children[i].ptr();
+                    if (!is_var(c) && !has_cuts(c)) {
+                        m_todo.push_back(c);
+                        visited = false;
+                    }
+                }
+                if (visited) {
+                    m_todo.pop_back();
+                    compute_cuts(n);
+                }
+            }
+        }
+
+        /**
+           \brief Return a literal equivalent to nl that is the constant, a literal or
+           the conjunction of two literals if such a function is found in the cuts of nl.
+        */
+        aig_lit rewrite(aig_lit nl) {
+            aig * n = nl.ptr();
+            if (is_var(n))
+                return nl;
+            ensure_cuts(n);
+            unsigned idx = to_idx(n);
+            // the first cut is the trivial one
+            for (unsigned k = m_cut_begin[idx] + 1; k < m_cut_end[idx]; k++) {
+                cut const & c = m_cuts[k];
+                aig_lit r;
+                if (c.m_size == 0) {
+                    r = c.m_tt == 0 ? m.m_false : m.m_true;
+                }
+                else if (c.m_size == 1) {
+                    r = aig_lit(c.m_leaves[0]);
+                    if (c.m_tt != var_tt(0))
+                        r.invert();
+                }
+                else if (c.m_size == 2) {
+                    unsigned f    = c.m_tt & 0xF;
+                    unsigned ones = (f & 1) + ((f >> 1) & 1) + ((f >> 2) & 1) + ((f >> 3) & 1);
+                    if (ones != 1 && ones != 3)
+                        continue;
+                    unsigned mt = 0;
+                    while (((f >> mt) & 1) != (ones == 1 ? 1u : 0u))
+                        mt++;
+                    aig_lit a(c.m_leaves[0]);
+                    aig_lit b(c.m_leaves[1]);
+                    if ((mt & 1) == 0) a.invert();
+                    if ((mt & 2) == 0) b.invert();
+                    r = m.mk_node(a, b);
+                    if (ones == 3)
+                        r.invert();
+                }
+                else {
+                    continue;
+                }
+                if (nl.is_inverted())
+                    r.invert();
+                if (r == nl)
+                    continue;
+                m.m_fraig_stats.m_rewrites++;
+                save(r);
+                return r;
+            }
+            return nl;
+        }
+
+        // -----------------------------------
+        //
+        // Main
+        //
+        // -----------------------------------
+
+        void add_node(aig * n) {
+            n->m_mark = true;
+            unsigned idx = m_nodes.size();
+            m_id2idx.insert(n->m_id, idx);
+            m_nodes.push_back(n);
+            if (is_var(n) && n->m_id != 0)
+                m_inputs.push_back(idx);
+        }
+
+        void collect(aig * root) {
+            add_node(m.m_true.ptr());
+            m_todo.push_back(root);
+            while (!m_todo.empty()) {
+                aig * n = m_todo.back();
+                if (n->m_mark) {
+                    m_todo.pop_back();
+                    continue;
+                }
+                bool visited = true;
+                if (!is_var(n)) {
+                    for (unsigned i = 0; i < 2; i++) {
+                        aig * c = n->m_children[i].ptr();
+                        if (!c->m_mark) {
+                            m_todo.push_back(c);
+                            visited = false;
+                        }
+                    }
+                }
+                if (visited) {
+                    m_todo.pop_back();
+                    add_node(n);
+                }
+            }
+            unmark(m_nodes.size(), m_nodes.c_ptr());
+        }
+
+        aig_lit map_lit(aig_lit const & l) const {
+            unsigned idx = 0;
+            VERIFY(m_id2idx.find(id(l), idx));
+            aig_lit r = m_map[idx];
+            if (l.is_inverted())
+                r.invert();
+            return r;
+        }
+
+        aig_lit operator()(aig_lit root) {
+            collect(root.ptr());
+            if (m_use_sat) {
+                for (unsigned k = 0; k < m_sim_words; k++)
+                    add_word();
+            }
+            m_map.resize(m_nodes.size(), aig_lit::null);
+            for (unsigned i = 0; i < m_nodes.size(); i++) {
+                m.checkpoint();
+                aig * n = m_nodes[i];
+                aig_lit nl;
+                if (is_var(n)) {
+                    nl = aig_lit(n);
+                }
+                else {
+                    nl = m.mk_node(map_lit(left(n)), map_lit(right(n)));
+                    save(nl);
+                    if (m_rewrite)
+                        nl = rewrite(nl);
+                }
+                sweep(i, nl);
+            }
+            IF_VERBOSE(10, verbose_stream() << "(aig.fraig :nodes " << m_nodes.size()
+                       << " :sim-words " << m_sim.size()
+                       << " :sat-vars " << m_solver.num_vars()
+                       << " :merged " << m.m_fraig_stats.m_merged
+                       << " :rewrites " << m.m_fraig_stats.m_rewrites << ")\n";);
+            return map_lit(root);
+        }
+    };
+
 public:
     imp(ast_manager & m, unsigned long long max_memory, bool default_gate_encoding):
         m_var_id_gen(0),
@@ -1548,6 +2191,24 @@ public:
         return p(l);
     }
 
+    aig_lit fraig(aig_lit l, params_ref const & p) {
+        aig_lit r;
+        {
+            fraig_proc proc(*this, p);
+            r = proc(l);
+            inc_ref(r);
+        }
+        dec_ref_result(r);
+        return r;
+    }
+
+    void collect_statistics(statistics & st) const {
+        st.update("aig fraig sat calls", m_fraig_stats.m_sat_calls);
+        st.update("aig fraig cex", m_fraig_stats.m_cex);
+        st.update("aig fraig merged", m_fraig_stats.m_merged);
+        st.update("aig fraig rewrites", m_fraig_stats.m_rewrites);
+    }
+
     void display_ref(std::ostream & out, aig * r) const {
         if (is_var(r)) 
             out << "#" << r->m_id;
@@ -1747,6 +2408,18 @@ void aig_manager::display_smt2(std::ostream & out, aig_ref const & r) const {
     m_imp->display_smt2(out, aig_lit(r));
 }
 
+void aig_manager::fraig(aig_ref & r, params_ref const & p) {
+    r = aig_ref(*this, m_imp->fraig(aig_lit(r), p));
+}
+
+void aig_manager::collect_statistics(statistics & st) const {
+    m_imp->collect_statistics(st);
+}
+
+void aig_manager::reset_statistics() {
+    m_imp->m_fraig_stats.reset();
+}
+
 unsigned aig_manager::get_num_aigs() const {
     return m_imp->get_num_aigs();
 }
@@ -21,8 +21,10 @@ Notes:
 
 #include"ast.h"
 #include"tactic_exception.h"
+#include"params.h"
 
 class goal;
+class statistics;
 class aig_lit;
 class aig_manager;
 
@@ -68,11 +70,19 @@ public:
     aig_ref mk_iff(aig_ref const & r1, aig_ref const & r2);
     aig_ref mk_ite(aig_ref const & r1, aig_ref const & r2, aig_ref const & r3);
     void max_sharing(aig_ref & r);
+    /**
+       \brief Functional reduction of r: cut based rewriting and SAT sweeping of the
+       nodes that have the same random simulation signature. The parameters are
+       aig_fraig_rewrite, aig_fraig_sim_words, aig_fraig_max_conflicts and random_seed.
+    */
+    void fraig(aig_ref & r, params_ref const & p = params_ref());
     void to_formula(aig_ref const & r, expr_ref & result);
     void to_formula(aig_ref const & r, goal & result);
     void display(std::ostream & out, aig_ref const & r) const;
     void display_smt2(std::ostream & out, aig_ref const & r) const;
     unsigned get_num_aigs() const;
+    void collect_statistics(statistics & st) const;
+    void reset_statistics();
 };
 
 #endif
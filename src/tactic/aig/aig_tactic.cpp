@@ -25,7 +25,10 @@ class aig_tactic : public tactic {
     unsigned long long m_max_memory;
     bool               m_aig_gate_encoding;
     bool               m_aig_per_assertion;
+    bool               m_fraig;
+    params_ref         m_fraig_params;
     aig_manager *      m_aig_manager;
+    statistics         m_stats;
 
     struct mk_aig_manager {
         aig_tactic & m_owner;
@@ -36,6 +39,8 @@ class aig_tactic : public tactic {
         }
         
         ~mk_aig_manager() {
+            if (m_owner.m_fraig)
+                m_owner.m_aig_manager->collect_statistics(m_owner.m_stats);
             dealloc(m_owner.m_aig_manager);
             m_owner.m_aig_manager = 0;
         }
@@ -51,6 +56,8 @@ public:
         t->m_max_memory = m_max_memory;
         t->m_aig_gate_encoding = m_aig_gate_encoding;
         t->m_aig_per_assertion = m_aig_per_assertion;
+        t->m_fraig = m_fraig;
+        t->m_fraig_params = m_fraig_params;
         return t;
     }
 
@@ -58,11 +65,17 @@ public:
         m_max_memory        = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
         m_aig_gate_encoding = p.get_bool("aig_default_gate_encoding", true);
         m_aig_per_assertion = p.get_bool("aig_per_assertion", true); 
+        m_fraig             = p.get_bool("aig_fraig", false);
+        m_fraig_params      = p;
     }
 
     virtual void collect_param_descrs(param_descrs & r) { 
         insert_max_memory(r);
         r.insert("aig_per_assertion", CPK_BOOL, "(default: true) process one assertion at a time.");
+        r.insert("aig_fraig", CPK_BOOL, "(default: false) merge functionally equivalent AIG nodes using random simulation and SAT sweeping.");
+        r.insert("aig_fraig_rewrite", CPK_BOOL, "(default: true) rewrite AIG nodes using their cuts with at most 4 leaves before SAT sweeping.");
+        r.insert("aig_fraig_sim_words", CPK_UINT, "(default: 4) number of random 64-bit simulation words used to compute the signatures of AIG nodes.");
+        r.insert("aig_fraig_max_conflicts", CPK_UINT, "(default: 100000) conflict budget of the SAT solver used for SAT sweeping, 0 disables SAT sweeping.");
     }
 
     void operator()(goal_ref const & g) {
@@ -73,6 +86,8 @@ public:
         if (m_aig_per_assertion) {
             for (unsigned i = 0; i < g->size(); i++) {
                 aig_ref r = m_aig_manager->mk_aig(g->form(i));
+                if (m_fraig)
+                    m_aig_manager->fraig(r, m_fraig_params);
                 m_aig_manager->max_sharing(r);
                 expr_ref new_f(g->m());
                 m_aig_manager->to_formula(r, new_f);
@@ -84,6 +99,8 @@ public:
             fail_if_unsat_core_generation("aig", g);
             aig_ref r = m_aig_manager->mk_aig(*(g.get()));
             g->reset(); // save memory
+            if (m_fraig)
+                m_aig_manager->fraig(r, m_fraig_params);
             m_aig_manager->max_sharing(r);
             m_aig_manager->to_formula(r, *(g.get()));
         }
@@ -102,6 +119,14 @@ public:
         result.push_back(g.get());
     }
 
+    virtual void collect_statistics(statistics & st) const {
+        st.copy(m_stats);
+    }
+
+    virtual void reset_statistics() {
+        m_stats.reset();
+    }
+
     virtual void cleanup() {}
 
 };
@@ -109,3 +134,9 @@ public:
 tactic * mk_aig_tactic(params_ref const & p) {
     return clean(alloc(aig_tactic, p));
 }
+
+tactic * mk_fraig_tactic(params_ref const & p) {
+    params_ref fraig_p;
+    fraig_p.set_bool("aig_fraig", true);
+    return using_params(mk_aig_tactic(p), fraig_p);
+}
@@ -23,7 +23,9 @@ Notes:
 class tactic;
 
 tactic * mk_aig_tactic(params_ref const & p = params_ref());
+tactic * mk_fraig_tactic(params_ref const & p = params_ref());
 /*
   ADD_TACTIC("aig", "simplify Boolean structure using AIGs.", "mk_aig_tactic()")
+  ADD_TACTIC("fraig", "simplify Boolean structure using AIGs, merging functionally equivalent nodes by SAT sweeping.", "mk_fraig_tactic()")
 */
 #endif
@@ -523,148 +523,143 @@ bool bound_propagator::propagate_eq(unsigned c_idx) {
     TRACE("bound_propagator_detail", tout << "propagating using eq: "; m_eq_manager.display(tout, *eq); tout << "\n";);
     // ll = (Sum_{a_i < 0} -a_i*lower(x_i)) + (Sum_{a_i > 0} -a_i * upper(x_i)) 
     // uu = (Sum_{a_i > 0} -a_i*lower(x_i)) + (Sum_{a_i < 0} -a_i * upper(x_i)) 
+    // ll and uu are computed as enclosures using double intervals: m_approx_ll[i] (m_approx_uu[i]) 
+    // is the bound of x_i that contributes to ll (uu), or zero if it doesn't exist.
     unsigned ll_i = UINT_MAX; // position of the variable that couldn't contribute to ll
     unsigned uu_i = UINT_MAX; // position of the variable that coundn't contribute to uu
     bool ll_failed = false;
     bool uu_failed = false;
-    double ll = 0.0;
-    double uu = 0.0;
     unsigned sz = eq->size();
+    m_approx_as.reserve(sz);
+    m_approx_ll.reserve(sz);
+    m_approx_uu.reserve(sz);
+    dinterval zero(0.0, 0.0);
     for (unsigned i = 0; i < sz; i++) {
         var x_i     = eq->x(i);
         double a_i  = eq->approx_a(i);
         bound * l_i = m_lowers[x_i];
         bound * u_i = m_uppers[x_i];
-        if (a_i < 0.0) {
-            if (!ll_failed) {
-                if (l_i == 0) {
-                    if (ll_i == UINT_MAX)
-                        ll_i = i;
-                    else
-                        ll_failed = true;
-                }
-                else {
-                    ll -= a_i * l_i->m_approx_k;
-                }
-            }
-            
-            if (!uu_failed) {
-                if (u_i == 0) {
-                    if (uu_i == UINT_MAX)
-                        uu_i = i;
-                    else
-                        uu_failed = true;
-                }
-                else {
-                    uu -= a_i * u_i->m_approx_k;
-                }
-            }
+        bound * ll_b = a_i < 0.0 ? l_i : u_i;
+        bound * uu_b = a_i < 0.0 ? u_i : l_i;
+        if (ll_b == 0) {
+            m_approx_ll[i] = zero;
+            if (ll_i == UINT_MAX)
+                ll_i = i;
+            else
+                ll_failed = true;
         }
         else {
-            if (!ll_failed) {
-                if (u_i == 0) {
-                    if (ll_i == UINT_MAX)
-                        ll_i = i;
-                    else
-                        ll_failed = true;
-                }
-                else {
-                    ll -= a_i * u_i->m_approx_k;
-                }
-            }
-
-            if (!uu_failed) {
-                if (l_i == 0) {
-                    if (uu_i == UINT_MAX)
-                        uu_i = i;
-                    else
-                        uu_failed = true;
-                }
-                else {
-                    uu -= a_i * l_i->m_approx_k;
-                }
-            }
+            m_approx_ll[i] = dinterval(ll_b->m_approx_k, ll_b->m_approx_k);
+        }
+        if (uu_b == 0) {
+            m_approx_uu[i] = zero;
+            if (uu_i == UINT_MAX)
+                uu_i = i;
+            else
+                uu_failed = true;
+        }
+        else {
+            m_approx_uu[i] = dinterval(uu_b->m_approx_k, uu_b->m_approx_k);
         }
         if (ll_failed && uu_failed)
             return false; // nothing to propagate
+        dinterval_set(m, eq->a(i), m_approx_as[i]);
     }
 
-    bool propagated = false;
-
     SASSERT(!ll_failed || !uu_failed);
-    if (ll_i == UINT_MAX || uu_i == UINT_MAX) {
-        for (unsigned i = 0; i < sz; i++) {
-            var x_i     = eq->x(i);
-            double a_i  = eq->approx_a(i);
-            bound * l_i = m_lowers[x_i];
-            bound * u_i = m_uppers[x_i];
-            // ll = (Sum_{a_i < 0} -a_i*lower(x_i)) + (Sum_{a_i > 0} -a_i * upper(x_i)) 
-            // uu = (Sum_{a_i > 0} -a_i*lower(x_i)) + (Sum_{a_i < 0} -a_i * upper(x_i)) 
-            if (ll_i == UINT_MAX) {
-                // can propagate a lower bound for a_i*x_i
-                if (a_i > 0.0) {
-                    // can propagate a lower bound for x_i
-                    double new_k = (ll + a_i * u_i->m_approx_k)/a_i;
-                    if (relevant_lower(x_i, new_k) && propagate_lower(c_idx, i))
-                        propagated = true;
-                }
-                else {
-                    // a_i < 0.0
-                    // can propagate a upper bound for x_i
-                    double new_k = (ll + a_i * l_i->m_approx_k)/a_i;
-                    if (relevant_upper(x_i, new_k) && propagate_upper(c_idx, i))
-                        propagated = true;
-                }
-            }
-            if (uu_i == UINT_MAX) {
-                // can propagate an upper bound for a_i*x_i
-                if (a_i > 0.0) {
-                    // can propagate a upper bound for x_i
-                    double new_k = (uu + a_i * l_i->m_approx_k)/a_i;
-                    if (relevant_upper(x_i, new_k) && propagate_upper(c_idx, i))
-                        propagated = true;
+    // Enclosures are used for the estimates of the new bounds. The upper end point is used for a new lower bound 
+    // and the lower end point for a new upper bound. So, a bound that is relevant with respect to the approximate 
+    // bounds m_approx_k is never missed because of rounding errors.
+    // The relevant positions are collected first (in the order they would be propagated), and the propagations 
+    // are performed after the rounding mode is restored.
+    m_approx_todo.reset();
+    {
+        dinterval_round_up scope;
+        dinterval * as  = m_approx_as.c_ptr();
+        dinterval * lls = m_approx_ll.c_ptr();
+        dinterval * uus = m_approx_uu.c_ptr();
+        // lls[i] := a_i * lls[i], uus[i] := a_i * uus[i]
+        dinterval_mul(sz, as, lls, lls);
+        dinterval_mul(sz, as, uus, uus);
+        dinterval ll, uu, new_k;
+        dinterval_sum(sz, lls, ll);
+        dinterval_sum(sz, uus, uu);
+        std::swap(ll.m_neg_l, ll.m_u); // ll := -ll
+        std::swap(uu.m_neg_l, uu.m_u); // uu := -uu
+
+        if (ll_i == UINT_MAX || uu_i == UINT_MAX) {
+            for (unsigned i = 0; i < sz; i++) {
+                var x_i     = eq->x(i);
+                bool a_pos  = eq->approx_a(i) > 0.0;
+                if (ll_i == UINT_MAX) {
+                    // can propagate a lower bound for a_i*x_i
+                    // (ll + a_i * upper(x_i))/a_i if a_i > 0.0, and (ll + a_i * lower(x_i))/a_i otherwise
+                    dinterval_add(ll, lls[i], new_k);
+                    dinterval_div(new_k, as[i], new_k);
+                    if (a_pos) {
+                        // can propagate a lower bound for x_i
+                        if (relevant_lower(x_i, new_k.upper()))
+                            m_approx_todo.push_back(pos_kind(i, true));
+                    }
+                    else {
+                        // can propagate a upper bound for x_i
+                        if (relevant_upper(x_i, new_k.lower()))
+                            m_approx_todo.push_back(pos_kind(i, false));
+                    }
                 }
-                else {
-                    // a_i < 0.0
-                    // can propagate a lower bound for x_i
-                    double new_k = (uu + a_i * u_i->m_approx_k)/a_i;
-                    if (relevant_lower(x_i, new_k) && propagate_lower(c_idx, i))
-                        propagated = true;
+                if (uu_i == UINT_MAX) {
+                    // can propagate an upper bound for a_i*x_i
+                    dinterval_add(uu, uus[i], new_k);
+                    dinterval_div(new_k, as[i], new_k);
+                    if (a_pos) {
+                        // can propagate a upper bound for x_i
+                        if (relevant_upper(x_i, new_k.lower()))
+                            m_approx_todo.push_back(pos_kind(i, false));
+                    }
+                    else {
+                        // can propagate a lower bound for x_i
+                        if (relevant_lower(x_i, new_k.upper()))
+                            m_approx_todo.push_back(pos_kind(i, true));
+                    }
                 }
             }
         }
-    }
 
-    if (!ll_failed && ll_i != UINT_MAX) {
-        // can propagate a lower bound for the monomial at position ll_i
-        var x_i      = eq->x(ll_i);
-        double a_i   = eq->approx_a(ll_i);
-        double new_k = ll/a_i;
-        if (a_i > 0.0) {
-            if (relevant_lower(x_i, new_k) && propagate_lower(c_idx, ll_i))
-                propagated = true;
+        if (!ll_failed && ll_i != UINT_MAX) {
+            // can propagate a lower bound for the monomial at position ll_i
+            var x_i      = eq->x(ll_i);
+            dinterval_div(ll, as[ll_i], new_k);
+            if (eq->approx_a(ll_i) > 0.0) {
+                if (relevant_lower(x_i, new_k.upper()))
+                    m_approx_todo.push_back(pos_kind(ll_i, true));
+            }
+            else {
+                if (relevant_upper(x_i, new_k.lower()))
+                    m_approx_todo.push_back(pos_kind(ll_i, false));
+            }
         }
-        else {
-            if (relevant_upper(x_i, new_k) && propagate_upper(c_idx, ll_i))
-                propagated = true;
+
+        if (!uu_failed && uu_i != UINT_MAX) {
+            // can propagate a upper bound for the monomial at position uu_i
+            var x_i      = eq->x(uu_i);
+            dinterval_div(uu, as[uu_i], new_k);
+            if (eq->approx_a(uu_i) > 0.0) {
+                if (relevant_upper(x_i, new_k.lower()))
+                    m_approx_todo.push_back(pos_kind(uu_i, false));
+            }
+            else {
+                if (relevant_lower(x_i, new_k.upper()))
+                    m_approx_todo.push_back(pos_kind(uu_i, true));
+            }
         }
     }
 
-    if (!uu_failed && uu_i != UINT_MAX) {
-        // can propagate a upper bound for the monomial at position uu_i
-        var x_i      = eq->x(uu_i);
-        double a_i   = eq->approx_a(uu_i);
-        double new_k = uu/a_i;
-        if (a_i > 0.0) {
-            if (relevant_upper(x_i, new_k) && propagate_upper(c_idx, uu_i))
-                propagated = true;
-        }
-        else {
-            if (relevant_lower(x_i, new_k) && propagate_lower(c_idx, uu_i))
-                propagated = true;
-        }
+    bool propagated = false;
+    for (unsigned j = 0; j < m_approx_todo.size(); j++) {
+        unsigned i = m_approx_todo[j].first;
+        if (m_approx_todo[j].second ? propagate_lower(c_idx, i) : propagate_upper(c_idx, i))
+            propagated = true;
     }
-    
     return propagated;
 }
 
@@ -26,6 +26,7 @@ Revision History:
 #include"statistics.h"
 #include"numeral_buffer.h"
 #include"linear_equation.h"
+#include"double_interval.h"
 
 class bound_propagator {
 public:
@@ -134,6 +135,13 @@ protected:
 
     unsigned_vector    m_to_reset_ts; // temp field: ids of the constraints we must reset the field m_timestamp
 
+    // temp fields used in propagate_eq
+    typedef std::pair<unsigned, bool> pos_kind; // position in the equation, and whether a lower bound is propagated
+    svector<dinterval> m_approx_as;   // enclosures of the coefficients
+    svector<dinterval> m_approx_ll;
+    svector<dinterval> m_approx_uu;
+    svector<pos_kind>  m_approx_todo;
+
     // config
     unsigned           m_max_refinements; // maximum number of refinements per round
     double             m_small_interval;
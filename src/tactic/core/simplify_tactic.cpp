@@ -19,16 +19,48 @@ Notes:
 #include"simplify_tactic.h"
 #include"th_rewriter.h"
 #include"ast_pp.h"
+#include"ast_translation.h"
+#include"scoped_ptr_vector.h"
+#include"z3_omp.h"
 
 struct simplify_tactic::imp {
     ast_manager &   m_manager;
     th_rewriter     m_r;
     unsigned        m_num_steps;
+    params_ref      m_params;
+    unsigned        m_threads;
+
+    // Formulas sharing a subterm of at least this depth are simplified by the same worker.
+    static const unsigned PAR_SHARED_DEPTH = 4;
+    // Minimal number of formulas for using more than one thread.
+    static const unsigned PAR_MIN_FORMULAS = 16;
+
+    struct worker {
+        ast_manager      m_manager;
+        expr_ref_vector  m_forms;
+        proof_ref_vector m_prs;
+        unsigned_vector  m_idxs;   // positions of m_forms in the goal
+        params_ref       m_params; // private copy, params_ref is not thread safe
+        unsigned         m_num_steps;
+        worker(ast_manager & m):
+            m_manager(m, !m.proof_mode()),
+            m_forms(m_manager),
+            m_prs(m_manager),
+            m_num_steps(0) {
+        }
+    };
 
     imp(ast_manager & m, params_ref const & p):
         m_manager(m),
         m_r(m, p),
         m_num_steps(0) {
+        updt_params(p);
+    }
+
+    void updt_params(params_ref const & p) {
+        m_params  = p;
+        m_threads = p.get_uint("threads", 1);
+        m_r.updt_params(p);
     }
 
     ~imp() {
@@ -42,6 +74,197 @@ struct simplify_tactic::imp {
         m_num_steps = 0;
     }
 
+    static unsigned find(unsigned_vector & parent, unsigned i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    /**
+       \brief Distribute the formulas of g among at most num_workers workers.
+       Formulas sharing a large subterm are assigned to the same worker, so that
+       the subterm is simplified only once. The workers are balanced using the
+       number of subterms of their formulas.
+    */
+    void partition(goal const & g, unsigned num_workers, vector<unsigned_vector> & workers) {
+        unsigned sz = g.size();
+        unsigned_vector parent, weight;
+        for (unsigned i = 0; i < sz; i++) {
+            parent.push_back(i);
+            weight.push_back(0);
+        }
+        obj_map<expr, unsigned> owner;
+        ptr_vector<expr> todo;
+        for (unsigned i = 0; i < sz; i++) {
+            todo.push_back(g.form(i));
+            while (!todo.empty()) {
+                expr * e = todo.back();
+                todo.pop_back();
+                unsigned j;
+                if (owner.find(e, j)) {
+                    if (get_depth(e) >= PAR_SHARED_DEPTH) {
+                        unsigned r1 = find(parent, i), r2 = find(parent, j);
+                        if (r1 != r2) 
+                            parent[r2] = r1;
+                    }
+                    continue;
+                }
+                owner.insert(e, i);
+                weight[i]++;
+                if (is_app(e)) {
+                    for (unsigned k = 0; k < to_app(e)->get_num_args(); k++)
+                        todo.push_back(to_app(e)->get_arg(k));
+                }
+                else if (is_quantifier(e)) {
+                    todo.push_back(to_quantifier(e)->get_expr());
+                }
+            }
+        }
+        // group weights
+        unsigned_vector groups;
+        for (unsigned i = 0; i < sz; i++) {
+            unsigned r = find(parent, i);
+            if (r == i) 
+                groups.push_back(i);
+            else
+                weight[r] += weight[i];
+        }
+        // Assign the heaviest groups first, each one to the lightest worker.
+        std::sort(groups.begin(), groups.end(), group_lt(weight));
+        num_workers = std::min(num_workers, groups.size());
+        unsigned_vector group2worker, load;
+        group2worker.resize(sz, UINT_MAX);
+        load.resize(num_workers, 0);
+        for (unsigned i = 0; i < groups.size(); i++) {
+            unsigned best = 0;
+            for (unsigned w = 1; w < num_workers; w++) {
+                if (load[w] < load[best])
+                    best = w;
+            }
+            load[best] += weight[groups[i]];
+            group2worker[groups[i]] = best;
+        }
+        workers.reset();
+        workers.resize(num_workers);
+        for (unsigned i = 0; i < sz; i++) 
+            workers[group2worker[find(parent, i)]].push_back(i);
+        TRACE("simplifier_par", 
+              for (unsigned w = 0; w < num_workers; w++) tout << "worker " << w << ": " << workers[w].size() << " formulas, load " << load[w] << "\n";);
+    }
+
+    struct group_lt {
+        unsigned_vector const & m_weight;
+        group_lt(unsigned_vector const & w):m_weight(w) {}
+        bool operator()(unsigned g1, unsigned g2) const { return m_weight[g1] > m_weight[g2]; }
+    };
+
+    bool use_par(goal const & g) const {
+        if (m_threads <= 1 || g.size() < PAR_MIN_FORMULAS)
+            return false;
+#ifdef _NO_OMP_
+        return false;
+#else
+        return 0 == omp_in_parallel();
+#endif
+    }
+
+    /**
+       \brief Simplify the formulas of g using several threads.
+       Each worker has its own manager, the formulas are copied using ast_translation.
+       Return false if the goal could not be split.
+    */
+    bool par_simplify(goal & g) {
+        vector<unsigned_vector> groups;
+        partition(g, m_threads, groups);
+        unsigned num_workers = groups.size();
+        if (num_workers <= 1)
+            return false;
+        IF_VERBOSE(10, verbose_stream() << "(simplifier :workers " << num_workers << ")\n";);
+        scoped_ptr_vector<worker> workers;
+        for (unsigned w = 0; w < num_workers; w++) {
+            worker * wk = alloc(worker, m());
+            workers.push_back(wk);
+            wk->m_idxs.swap(groups[w]);
+            wk->m_params.copy(m_params);
+            ast_translation tr(m(), wk->m_manager, false);
+            for (unsigned i = 0; i < wk->m_idxs.size(); i++) 
+                wk->m_forms.push_back(tr(g.form(wk->m_idxs[i])));
+        }
+        for (unsigned w = 0; w < num_workers; w++) 
+            m().limit().push_child(&workers[w]->m_manager.limit());
+        bool        failed = false;
+        std::string ex_msg;
+        #pragma omp parallel for
+        for (int w = 0; w < static_cast<int>(num_workers); w++) {
+            worker & wk = *workers[w];
+            try {
+                th_rewriter rw(wk.m_manager, wk.m_params);
+                expr_ref  new_curr(wk.m_manager);
+                proof_ref new_pr(wk.m_manager);
+                for (unsigned i = 0; i < wk.m_forms.size(); i++) {
+                    rw(wk.m_forms.get(i), new_curr, new_pr);
+                    wk.m_num_steps += rw.get_num_steps();
+                    wk.m_forms.set(i, new_curr);
+                    wk.m_prs.push_back(new_pr);
+                }
+            }
+            catch (z3_exception & ex) {
+                bool first = false;
+                #pragma omp critical (simplify_tactic)
+                {
+                    if (!failed) {
+                        failed = true;
+                        first  = true;
+                        ex_msg = ex.msg();
+                    }
+                }
+                if (first) {
+                    for (unsigned j = 0; j < num_workers; j++) 
+                        if (j != static_cast<unsigned>(w))
+                            workers[j]->m_manager.limit().cancel();
+                }
+            }
+        }
+        for (unsigned w = 0; w < num_workers; w++) 
+            m().limit().pop_child();
+        if (failed)
+            throw rewriter_exception(ex_msg.c_str());
+        // copy the results back, in the order of the goal.
+        unsigned sz = g.size();
+        ptr_vector<expr>  new_forms;
+        ptr_vector<proof> new_prs;
+        new_forms.resize(sz, 0);
+        new_prs.resize(sz, 0);
+        expr_ref_vector  trail(m());
+        for (unsigned w = 0; w < num_workers; w++) {
+            worker & wk = *workers[w];
+            ast_translation tr(wk.m_manager, m(), false);
+            for (unsigned i = 0; i < wk.m_idxs.size(); i++) {
+                unsigned idx = wk.m_idxs[i];
+                new_forms[idx] = tr(wk.m_forms.get(i));
+                trail.push_back(new_forms[idx]);
+                if (g.proofs_enabled()) {
+                    new_prs[idx] = tr(wk.m_prs.get(i));
+                    trail.push_back(new_prs[idx]);
+                }
+            }
+            m_num_steps += wk.m_num_steps;
+        }
+        workers.reset();
+        proof_ref new_pr(m());
+        for (unsigned idx = 0; idx < sz; idx++) {
+            if (g.inconsistent())
+                break;
+            new_pr = new_prs[idx];
+            if (g.proofs_enabled()) 
+                new_pr = m().mk_modus_ponens(g.pr(idx), new_pr);
+            g.update(idx, new_forms[idx], new_pr, g.dep(idx));
+        }
+        return true;
+    }
+
     void operator()(goal & g) {
         SASSERT(g.is_well_sorted());
         tactic_report report("simplifier", g);
@@ -49,20 +272,22 @@ struct simplify_tactic::imp {
         m_num_steps = 0;
         if (g.inconsistent())
             return;
-        expr_ref   new_curr(m());
-        proof_ref  new_pr(m());
-        unsigned size = g.size();
-        for (unsigned idx = 0; idx < size; idx++) {
-            if (g.inconsistent())
-                break;
-            expr * curr = g.form(idx);
-            m_r(curr, new_curr, new_pr);
-            m_num_steps += m_r.get_num_steps();
-            if (g.proofs_enabled()) {
-                proof * pr = g.pr(idx);
-                new_pr     = m().mk_modus_ponens(pr, new_pr);
+        if (!use_par(g) || !par_simplify(g)) {
+            expr_ref   new_curr(m());
+            proof_ref  new_pr(m());
+            unsigned size = g.size();
+            for (unsigned idx = 0; idx < size; idx++) {
+                if (g.inconsistent())
+                    break;
+                expr * curr = g.form(idx);
+                m_r(curr, new_curr, new_pr);
+                m_num_steps += m_r.get_num_steps();
+                if (g.proofs_enabled()) {
+                    proof * pr = g.pr(idx);
+                    new_pr     = m().mk_modus_ponens(pr, new_pr);
+                }
+                g.update(idx, new_curr, new_pr, g.dep(idx));
             }
-            g.update(idx, new_curr, new_pr, g.dep(idx));
         }
         TRACE("after_simplifier_bug", g.display(tout););
         g.elim_redundancies();
@@ -85,11 +310,12 @@ simplify_tactic::~simplify_tactic() {
 
 void simplify_tactic::updt_params(params_ref const & p) {
     m_params = p;
-    m_imp->m_r.updt_params(p);
+    m_imp->updt_params(p);
 }
 
 void simplify_tactic::get_param_descrs(param_descrs & r) {
     th_rewriter::get_param_descrs(r);
+    r.insert("threads", CPK_UINT, "(default: 1) maximal number of threads used to simplify the formulas of a goal. Formulas sharing large subterms are simplified by the same thread.");
 }
 
 void simplify_tactic::operator()(goal_ref const & in, 
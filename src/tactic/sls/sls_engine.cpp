@@ -26,6 +26,7 @@ Notes:
 #include"tactic.h"
 #include"cooperate.h"
 #include"luby.h"
+#include"bv_simulator.h"
 
 #include"sls_params.hpp"
 #include"sls_engine.h"
@@ -55,7 +56,8 @@ void sls_engine::updt_params(params_ref const & _p) {
     sls_params p(_p);
     m_produce_models = _p.get_bool("model", false);
     m_max_restarts = p.max_restarts();
-    m_tracker.set_random_seed(p.random_seed());
+    m_random_seed = p.random_seed();
+    m_tracker.set_random_seed(m_random_seed);
     m_walksat = p.walksat();
     m_walksat_repick = p.walksat_repick();
     m_paws_sp = p.paws_sp();
@@ -71,6 +73,7 @@ void sls_engine::updt_params(params_ref const & _p) {
     m_early_prune = p.early_prune();
     m_random_offset = p.random_offset();
     m_rescore = p.rescore();
+    m_sim_rounds = p.sim_rounds();
 
     // Andreas: Would cause trouble because repick requires an assertion being picked before which is not the case in GSAT.
     if (m_walksat_repick && !m_walksat)
@@ -568,11 +571,60 @@ void sls_engine::operator()(goal_ref const & g, model_converter_ref & mc) {
         mc = 0;
 }
 
+/**
+   \brief Evaluate m_sim_rounds batches of random assignments with the bit-parallel
+   simulator, and use the assignment satisfying the most assertions as starting point.
+*/
+void sls_engine::init_by_simulation() {
+    if (m_sim_rounds == 0)
+        return;
+    bv_simulator sim(m_manager, m_random_seed);
+    if (!sim.compile(m_assertions.size(), m_assertions.c_ptr())) {
+        IF_VERBOSE(10, verbose_stream() << "(sls :simulation-unsupported)" << std::endl;);
+        return;
+    }
+    unsigned num_inputs = sim.get_num_inputs();
+    unsigned best       = 0;
+    svector<uint64> best_values;
+    unsigned sat[bv_simulator::LANES];
+    for (unsigned r = 0; r < m_sim_rounds && best < m_assertions.size(); r++) {
+        checkpoint();
+        sim.randomize();
+        sim.run();
+        for (unsigned l = 0; l < bv_simulator::LANES; l++)
+            sat[l] = 0;
+        for (unsigned i = 0; i < m_assertions.size(); i++) {
+            uint64 w = sim.get_bool(m_assertions[i]);
+            for (unsigned l = 0; l < bv_simulator::LANES; l++)
+                sat[l] += static_cast<unsigned>((w >> l) & 1);
+        }
+        for (unsigned l = 0; l < bv_simulator::LANES; l++) {
+            if (sat[l] > best || best_values.empty()) {
+                best = sat[l];
+                best_values.reset();
+                for (unsigned i = 0; i < num_inputs; i++)
+                    best_values.push_back(sim.get_value(sim.get_input(i), l));
+            }
+        }
+    }
+    IF_VERBOSE(10, verbose_stream() << "(sls :simulation-best " << best << "/" << m_assertions.size() << ")" << std::endl;);
+    mpz v;
+    for (unsigned i = 0; i < num_inputs; i++) {
+        func_decl * fd = sim.get_input(i)->get_decl();
+        if (!m_tracker.get_entry_points().contains(fd))
+            continue;
+        m_mpz_manager.set(v, best_values[i]);
+        m_tracker.set_value(fd, v);
+    }
+    m_mpz_manager.del(v);
+}
+
 lbool sls_engine::operator()() {    
     m_tracker.initialize(m_assertions);
     m_tracker.reset(m_assertions);
     if (m_restart_init)
         m_tracker.randomize(m_assertions);
+    init_by_simulation();
 
     lbool res = l_undef;
 
@@ -83,6 +83,8 @@ protected:
     unsigned        m_early_prune;
     unsigned        m_random_offset;
     unsigned        m_rescore;
+    unsigned        m_sim_rounds;
+    unsigned        m_random_seed;
 
     typedef enum { MV_FLIP = 0, MV_INC, MV_DEC, MV_INV } move_type;
 
@@ -134,6 +136,8 @@ protected:
 
     void mk_random_move(ptr_vector<func_decl> & unsat_constants);
 
+    void init_by_simulation();
+
     //double get_restart_armin(unsigned cnt_restarts);    
     unsigned check_restart(unsigned curr_value);
 };
@@ -12,6 +12,7 @@ Copyright (c) 2015 Microsoft Corporation
 #include "model.h"
 #include "pdr_util.h"
 #include "smt2parser.h"
+#include "rewrite_cache.h"
 
 
 static expr_ref parse_fml(ast_manager& m, char const* str) {
@@ -35,6 +36,83 @@ static expr_ref parse_fml(ast_manager& m, char const* str) {
 static char const* example1 = "(<= (+ (* 1.3 x y) (* 2.3 y y) (* (- 1.1 x x))) 2.2)";
 static char const* example2 = "(= (+ 4 3 (- (* 3 x x) (* 5 y)) y) 0)";
 
+static void tst_rewrite_cache() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    m.set_rewrite_cache_size(1000);
+    rewrite_cache & c = *m.get_rewrite_cache();
+    expr_ref fml = parse_fml(m, example2);
+    expr_ref r1(m), r2(m);
+    th_rewriter rw1(m);
+    rw1(fml, r1);
+    unsigned sz = c.size();
+    VERIFY(sz > 0);
+    // a new rewriter with the same configuration reuses the results.
+    th_rewriter rw2(m);
+    rw2(fml, r2);
+    VERIFY(r1 == r2);
+    VERIFY(c.size() == sz);
+    // the results of the old configuration are kept, rw1 still uses them.
+    params_ref p;
+    p.set_bool("flat", false);
+    rw2.updt_params(p);
+    VERIFY(c.size() == sz);
+    rw2(fml, r2);
+    VERIFY(c.size() > sz);
+    rw1(fml, r2);
+    VERIFY(r1 == r2);
+    // the cache is bounded
+    m.set_rewrite_cache_size(2);
+    VERIFY(c.size() <= 2);
+    fml = parse_fml(m, example1);
+    rw1(fml, r1);
+    VERIFY(c.size() <= 2);
+    // the result does not depend on the cache.
+    m.set_rewrite_cache_size(0);
+    th_rewriter rw3(m);
+    rw3(fml, r2);
+    VERIFY(r1 == r2);
+}
+
+// A tiny cache is full during most of the rewriting steps performed by the smt solver.
+static void tst_rewrite_cache_fp() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    for (unsigned sz = 2; sz < 10; sz++) {
+        m.set_rewrite_cache_size(sz);
+        cmd_context ctx(false, &m);
+        std::istringstream is("(declare-const x (_ FloatingPoint 8 24))\n"
+                              "(assert (fp.eq x ((_ to_fp 8 24) RNE 3.0)))\n"
+                              "(check-sat-using smt)\n");
+        VERIFY(parse_smt2_commands(ctx, is));
+        VERIFY(ctx.get_check_sat_result() != 0 && ctx.get_check_sat_result()->status() == l_true);
+        VERIFY(m.get_rewrite_cache()->size() <= sz);
+    }
+    m.set_rewrite_cache_size(0);
+}
+
+// The rewritten term may be referenced only by the result (e.g., rw(r, r)).
+static void tst_rewrite_cache_alias() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    th_rewriter rw0(m);
+    m.set_rewrite_cache_size(4);
+    th_rewriter rw(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref one(a.mk_numeral(rational(1), true), m);
+    for (unsigned i = 0; i < 100; i++) {
+        expr_ref r(a.mk_add(a.mk_add(x, a.mk_numeral(rational(i), true)), one), m);
+        rw(r, r);
+        r = m.mk_eq(r, x);
+        rw(r, r);
+        expr_ref e(a.mk_add(a.mk_add(x, a.mk_numeral(rational(i), true)), one), m);
+        e = m.mk_eq(e, x);
+        rw0(e, e);
+        VERIFY(r == e);
+    }
+    m.set_rewrite_cache_size(0);
+}
 
 void tst_arith_rewriter() {
     ast_manager m;
@@ -62,4 +140,7 @@ void tst_arith_rewriter() {
     std::cout << mk_pp(fml, m) << "\n";
     pdr::normalize_arithmetic(fml);
     std::cout << mk_pp(fml, m) << "\n";
+    tst_rewrite_cache();
+    tst_rewrite_cache_fp();
+    tst_rewrite_cache_alias();
 }
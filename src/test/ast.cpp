@@ -17,6 +17,8 @@ Revision History:
 
 --*/
 #include "ast.h"
+#include "z3_omp.h"
+#include "statistics.h"
 
 static void tst1() {
     ast_manager m;
@@ -141,6 +143,90 @@ struct foo {
     bool           m_val2:1;
 };
 
+static expr * mk_concurrent_term(ast_manager & m, func_decl * f, expr_ref_vector const & cs, unsigned seed, unsigned depth) {
+    if (depth == 0)
+        return cs.get(seed % cs.size());
+    expr * a = mk_concurrent_term(m, f, cs, seed * 3 + 1, depth - 1);
+    expr * b = mk_concurrent_term(m, f, cs, seed * 7 + 2, depth - 1);
+    return m.mk_app(f, a, b);
+}
+
+static void tst6() {
+    ast_manager m;
+    sort_ref s(m.mk_uninterpreted_sort(symbol("S")), m);
+    sort * domain[2] = { s.get(), s.get() };
+    func_decl_ref f(m.mk_func_decl(symbol("f"), 2, domain, s.get()), m);
+    expr_ref_vector cs(m);
+    for (unsigned i = 0; i < 5; i++)
+        cs.push_back(m.mk_const(symbol(i), s.get()));
+    unsigned num_asts = m.get_num_asts();
+    m.enable_concurrency();
+    const int num_threads = 8;
+    expr_ref_vector results(m);
+    results.resize(num_threads);
+    #pragma omp parallel for
+    for (int i = 0; i < num_threads; i++) {
+        // every thread builds the same terms, and some temporary ones.
+        for (unsigned j = 0; j < 200; j++) {
+            expr_ref t(m.mk_app(f, mk_concurrent_term(m, f, cs, j, 8), m.mk_fresh_const("k", s.get())), m);
+            expr_ref e(m.mk_eq(t, cs.get(0)), m);
+        }
+        expr_ref r(mk_concurrent_term(m, f, cs, 0, 8), m);
+        results.set(i, r);
+    }
+    for (int i = 1; i < num_threads; i++)
+        VERIFY(results.get(i) == results.get(0));
+    results.reset();
+    m.collect_garbage();
+    VERIFY(m.get_num_asts() == num_asts);
+    m.disable_concurrency();
+    VERIFY(m.get_num_asts() == num_asts);
+    expr_ref t(mk_concurrent_term(m, f, cs, 0, 3), m);
+    VERIFY(m.contains(t));
+}
+
+static void tst7() {
+    ast_manager m;
+    sort_ref s(m.mk_uninterpreted_sort(symbol("S")), m);
+    sort * domain[2] = { s.get(), s.get() };
+    func_decl_ref f(m.mk_func_decl(symbol("f"), 2, domain, s.get()), m);
+    func_decl_ref g(m.mk_func_decl(symbol("g"), 1, domain, s.get()), m);
+    expr_ref a(m.mk_const(symbol("a"), s.get()), m);
+    unsigned num_asts = m.get_num_asts();
+    m.enable_deferred_deletion(4);
+    expr_ref t(a, m);
+    for (unsigned i = 0; i < 1000; i++) 
+        t = m.mk_app(f, t.get(), m.mk_app(g, t.get()));
+    expr_ref ga(m.mk_app(g, a.get()), m);
+    VERIFY(m.get_num_asts() == num_asts + 2000);
+    // dropping the term does not delete it
+    t = 0;
+    ga = 0;
+    VERIFY(m.get_num_deferred() == 1);
+    VERIFY(m.get_num_asts() == num_asts + 2000);
+    // g(a) is reused before it is reclaimed
+    app * r = m.mk_app(g, a.get());
+    // every new node reclaims at most 4 nodes
+    expr_ref u(m.mk_app(f, a.get(), a.get()), m);
+    VERIFY(m.get_num_asts() >= num_asts + 2000 + 1 - 4);
+    for (unsigned i = 0; i < 100; i++) 
+        u = m.mk_app(f, u.get(), a.get());
+    VERIFY(m.get_num_deferred() > 0);
+    VERIFY(m.contains(r));
+    VERIFY(r->get_arg(0) == a.get());
+    ga = r;
+    u = 0;
+    m.collect_garbage();
+    VERIFY(m.get_num_deferred() == 0);
+    VERIFY(m.get_num_asts() == num_asts + 1);
+    ga = 0;
+    m.disable_deferred_deletion();
+    VERIFY(m.get_num_asts() == num_asts);
+    statistics st;
+    m.collect_statistics(st);
+    TRACE("ast", st.display(tout););
+}
+
 void tst_ast() {
     TRACE("ast", 
           tout << "sizeof(ast):  " << sizeof(ast) << "\n";
@@ -153,5 +239,7 @@ void tst_ast() {
     tst3();
     tst4();
     tst5();
+    tst6();
+    tst7();
 }
 
@@ -0,0 +1,120 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+--*/
+
+#include "bv_simulator.h"
+#include "bv_decl_plugin.h"
+#include "th_rewriter.h"
+#include "expr_safe_replace.h"
+#include "reg_decl_plugins.h"
+#include "ast_pp.h"
+
+static expr * mk_random_bv(ast_manager & m, random_gen & r, ptr_vector<expr> const & leaves, unsigned depth);
+
+static expr * mk_random_pred(ast_manager & m, random_gen & r, ptr_vector<expr> const & leaves, unsigned depth) {
+    bv_util bv(m);
+    static const decl_kind preds[8] = { OP_ULEQ, OP_ULT, OP_UGEQ, OP_UGT, OP_SLEQ, OP_SLT, OP_SGEQ, OP_SGT };
+    expr * a = mk_random_bv(m, r, leaves, depth);
+    expr * b = mk_random_bv(m, r, leaves, depth);
+    switch (r(4)) {
+    case 0:  return m.mk_eq(a, b);
+    case 1: {
+        unsigned idx = r(8);
+        return m.mk_eq(bv.mk_extract(idx, idx, a), bv.mk_numeral(rational(1), 1));
+    }
+    default: return m.mk_app(bv.get_fid(), preds[r(8)], a, b);
+    }
+}
+
+static expr * mk_random_bv(ast_manager & m, random_gen & r, ptr_vector<expr> const & leaves, unsigned depth) {
+    bv_util bv(m);
+    static const decl_kind binops[22] = {
+        OP_BADD, OP_BSUB, OP_BMUL, OP_BUDIV, OP_BUREM, OP_BSDIV, OP_BSREM, OP_BSMOD,
+        OP_BAND, OP_BOR, OP_BXOR, OP_BNAND, OP_BNOR, OP_BXNOR, OP_BSHL, OP_BLSHR, OP_BASHR,
+        OP_EXT_ROTATE_LEFT, OP_EXT_ROTATE_RIGHT, OP_BADD, OP_BMUL, OP_BSUB
+    };
+    if (depth == 0 || r(5) == 0) {
+        if (r(4) == 0)
+            return bv.mk_numeral(rational(r(256)), 8);
+        return leaves[r(leaves.size())];
+    }
+    expr * a = mk_random_bv(m, r, leaves, depth - 1);
+    expr * b = mk_random_bv(m, r, leaves, depth - 1);
+    switch (r(8)) {
+    case 0:  return m.mk_app(bv.get_fid(), OP_BNEG, a);
+    case 1:  return m.mk_app(bv.get_fid(), OP_BNOT, a);
+    case 2:  return m.mk_ite(mk_random_pred(m, r, leaves, depth - 1), a, b);
+    case 3:  return bv.mk_concat(bv.mk_extract(5, 2, a), bv.mk_extract(7, 4, b));
+    case 4:  return bv.mk_sign_extend(3, bv.mk_extract(4, 0, a));
+    default: return m.mk_app(bv.get_fid(), binops[r(22)], a, b);
+    }
+}
+
+void tst_bv_simulator() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util     bv(m);
+    random_gen  r(0);
+    th_rewriter rw(m);
+    expr_ref_vector pinned(m);
+    ptr_vector<expr> leaves;
+    for (unsigned i = 0; i < 3; i++) {
+        std::string name("x");
+        name += static_cast<char>('0' + i);
+        leaves.push_back(m.mk_const(symbol(name.c_str()), bv.mk_sort(8)));
+        pinned.push_back(leaves.back());
+    }
+    for (unsigned iter = 0; iter < 200; iter++) {
+        expr_ref t(mk_random_bv(m, r, leaves, 4), m);
+        expr_ref p(mk_random_pred(m, r, leaves, 3), m);
+        bv_simulator sim(m, iter);
+        expr * roots[2] = { t, p };
+        VERIFY(sim.compile(2, roots));
+        sim.randomize();
+        sim.run();
+        for (unsigned lane = 0; lane < bv_simulator::LANES; lane += 7) {
+            expr_safe_replace sub(m);
+            for (unsigned i = 0; i < sim.get_num_inputs(); i++) {
+                app * x = sim.get_input(i);
+                sub.insert(x, bv.mk_numeral(rational(sim.get_value(x, lane), rational::ui64()), 8));
+            }
+            expr_ref v(m);
+            sub(t, v);
+            rw(v);
+            rational val;
+            unsigned sz;
+            VERIFY(bv.is_numeral(v, val, sz));
+            if (val.get_uint64() != sim.get_value(t, lane)) {
+                std::cout << mk_pp(t, m) << "\nlane " << lane << ": " << val << " " << sim.get_value(t, lane) << "\n";
+                UNREACHABLE();
+            }
+            sub(p, v);
+            rw(v);
+            VERIFY(m.is_true(v) || m.is_false(v));
+            VERIFY(m.is_true(v) == (sim.get_value(p, lane) == 1));
+        }
+    }
+    // candidate equivalences
+    bv_simulator sim(m);
+    expr_ref t1(bv.mk_bv_add(leaves[0], leaves[1]), m);
+    expr_ref t2(bv.mk_bv_sub(leaves[0], m.mk_app(bv.get_fid(), OP_BNEG, leaves[1])), m);
+    expr_ref t3(bv.mk_bv_sub(leaves[0], leaves[1]), m);
+    expr * roots[3] = { t1, t2, t3 };
+    VERIFY(sim.compile(3, roots));
+    sim.randomize();
+    sim.run();
+    VERIFY(sim.equal_on_all_lanes(t1, t2));
+    VERIFY(!sim.equal_on_all_lanes(t1, t3));
+    // bit2bool is not evaluated by the rewriter, compare with the bits of the value
+    parameter idx(3);
+    expr * x0 = leaves[0];
+    expr_ref b3(m.mk_app(bv.get_fid(), OP_BIT2BOOL, 1, &idx, 1, &x0), m);
+    VERIFY(sim.compile(b3));
+    sim.run();
+    for (unsigned lane = 0; lane < bv_simulator::LANES; lane++)
+        VERIFY(sim.get_value(b3, lane) == ((sim.get_value(x0, lane) >> 3) & 1));
+    // unsupported terms
+    expr_ref wide(m.mk_const(symbol("w"), bv.mk_sort(65)), m);
+    VERIFY(!sim.compile(m.mk_eq(wide, wide)));
+}
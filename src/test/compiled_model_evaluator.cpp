@@ -0,0 +1,104 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+--*/
+
+#include "compiled_model_evaluator.h"
+#include "model.h"
+#include "arith_decl_plugin.h"
+#include "reg_decl_plugins.h"
+#include "ast_pp.h"
+
+void tst_compiled_model_evaluator() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort * int_s = a.mk_int();
+
+    func_decl_ref f(m);
+    f = m.mk_func_decl(symbol("f"), 1, &int_s, int_s);
+    app_ref x(m.mk_const(symbol("x"), int_s), m);
+    app_ref y(m.mk_const(symbol("y"), int_s), m);
+    app_ref z(m.mk_const(symbol("z"), int_s), m);
+
+    expr_ref_vector roots(m);
+    roots.push_back(a.mk_add(a.mk_mul(x, y), m.mk_app(f, z.get())));
+    roots.push_back(m.mk_ite(a.mk_lt(x, y), x, y));
+    roots.push_back(a.mk_gt(m.mk_app(f, x.get()), a.mk_numeral(rational(3), true)));
+    roots.push_back(a.mk_mul(z, z));
+
+    compiled_model_evaluator ev(m);
+    ev.set_model_completion(true);
+    for (unsigned i = 0; i < roots.size(); i++)
+        VERIFY(ev.compile(roots.get(i)) == i);
+
+    random_gen r(0);
+    for (unsigned iter = 0; iter < 100; iter++) {
+        model_ref md = alloc(model, m);
+        // z keeps its value in most models
+        md->register_decl(x->get_decl(), a.mk_numeral(rational(r(10)), true));
+        md->register_decl(y->get_decl(), a.mk_numeral(rational(r(10)), true));
+        md->register_decl(z->get_decl(), a.mk_numeral(rational(iter / 10), true));
+        func_interp * fi = alloc(func_interp, m, 1);
+        for (unsigned j = 0; j < 3; j++) {
+            expr * arg = a.mk_numeral(rational(j), true);
+            fi->insert_entry(&arg, a.mk_numeral(rational(iter % 2 == 0 ? j : 2 * j), true));
+        }
+        fi->set_else(a.mk_numeral(rational(7), true));
+        md->register_decl(f, fi);
+
+        ev(*md);
+        for (unsigned i = 0; i < roots.size(); i++) {
+            expr_ref expected(m);
+            VERIFY(md->eval(roots.get(i), expected, true));
+            if (expected.get() != ev.get_value(i)) {
+                std::cout << mk_pp(roots.get(i), m) << "\n" << mk_pp(expected, m) << " " << mk_pp(ev.get_value(i), m) << "\n";
+                UNREACHABLE();
+            }
+        }
+    }
+    statistics st;
+    ev.collect_statistics(st);
+    st.display(std::cout);
+
+    // changing only x does not reevaluate (* z z)
+    model_ref md = alloc(model, m);
+    md->register_decl(x->get_decl(), a.mk_numeral(rational(1), true));
+    md->register_decl(y->get_decl(), a.mk_numeral(rational(2), true));
+    md->register_decl(z->get_decl(), a.mk_numeral(rational(3), true));
+    ev(*md);
+    ev.reset_statistics();
+    md->register_decl(x->get_decl(), a.mk_numeral(rational(5), true));
+    ev(*md);
+    st.reset();
+    ev.collect_statistics(st);
+    st.display(std::cout);
+    for (unsigned i = 0; i < st.size(); i++)
+        if (strcmp(st.get_key(i), "compiled eval skipped") == 0)
+            VERIFY(st.get_uint_value(i) > 0);
+    rational v;
+    VERIFY(a.is_numeral(ev.get_value(1), v) && v == rational(2));
+    VERIFY(a.is_numeral(ev.get_value(3), v) && v == rational(9));
+
+    // incremental updates of a single model
+    for (unsigned iter = 0; iter < 100; iter++) {
+        app * c = iter % 3 == 0 ? x : (iter % 3 == 1 ? y : z);
+        md->register_decl(c->get_decl(), a.mk_numeral(rational(r(5)), true));
+        func_decl * d = c->get_decl();
+        if (iter % 10 == 0) {
+            func_interp * fi = alloc(func_interp, m, 1);
+            fi->set_else(a.mk_numeral(rational(iter), true));
+            md->register_decl(f, fi);
+            func_decl * ds[2] = { d, f };
+            ev.update(*md, 2, ds);
+        }
+        else {
+            ev.update(*md, d);
+        }
+        for (unsigned i = 0; i < roots.size(); i++) {
+            expr_ref expected(m);
+            VERIFY(md->eval(roots.get(i), expected, true));
+            VERIFY(expected.get() == ev.get_value(i));
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+--*/
+
+#include "func_interp.h"
+#include "arith_decl_plugin.h"
+#include "reg_decl_plugins.h"
+
+static void check_entries(ast_manager & m, func_interp const & fi, unsigned n, unsigned offset) {
+    arith_util a(m);
+    for (unsigned i = 0; i < n; i++) {
+        expr_ref_vector args(m);
+        args.push_back(a.mk_numeral(rational(i), true));
+        args.push_back(a.mk_numeral(rational(i % 7), true));
+        func_entry * e = fi.get_entry(args.c_ptr());
+        rational v;
+        VERIFY(e != 0 && a.is_numeral(e->get_result(), v) && v == rational(i + offset));
+        args[1] = a.mk_numeral(rational(i % 7 + 1), true);
+        VERIFY(fi.get_entry(args.c_ptr()) == 0);
+    }
+}
+
+void tst_func_interp() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    unsigned n = 200;
+    func_interp fi(m, 2);
+    expr_ref_vector args(m);
+    for (unsigned i = 0; i < n; i++) {
+        args.reset();
+        args.push_back(a.mk_numeral(rational(i), true));
+        args.push_back(a.mk_numeral(rational(i % 7), true));
+        fi.insert_new_entry(args.c_ptr(), a.mk_numeral(rational(i), true));
+        // lookups interleaved with insertions, the index is built and then extended
+        if (i % 50 == 0)
+            check_entries(m, fi, i + 1, 0);
+    }
+    check_entries(m, fi, n, 0);
+    for (unsigned i = 0; i < n; i++) {
+        args.reset();
+        args.push_back(a.mk_numeral(rational(i), true));
+        args.push_back(a.mk_numeral(rational(i % 7), true));
+        fi.insert_entry(args.c_ptr(), a.mk_numeral(rational(i + 1), true));
+    }
+    VERIFY(fi.num_entries() == n);
+    check_entries(m, fi, n, 1);
+
+    // non-value arguments are not indexed
+    app_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    args.reset();
+    args.push_back(x);
+    args.push_back(x);
+    fi.insert_new_entry(args.c_ptr(), a.mk_numeral(rational(0), true));
+    VERIFY(fi.get_entry(args.c_ptr()) == 0);
+
+    // compress removes entries and rebuilds the index
+    fi.set_else(a.mk_numeral(rational(1), true));
+    fi.compress();
+    VERIFY(fi.num_entries() == n);
+    scoped_ptr<func_interp> fi2 = fi.copy();
+    for (unsigned i = 1; i < n; i++) {
+        args.reset();
+        args.push_back(a.mk_numeral(rational(i), true));
+        args.push_back(a.mk_numeral(rational(i % 7), true));
+        VERIFY(fi2->get_entry(args.c_ptr()) != 0);
+    }
+    args.reset();
+    args.push_back(a.mk_numeral(rational(0), true));
+    args.push_back(a.mk_numeral(rational(0), true));
+    VERIFY(fi.get_entry(args.c_ptr()) == 0);
+}
@@ -0,0 +1,141 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+--*/
+
+#include "grobner.h"
+#include "reg_decl_plugins.h"
+#include "z3.h"
+#include <iostream>
+#include <algorithm>
+
+static bool divides(unsigned_vector const & m1, unsigned_vector const & m2) {
+    return std::includes(m2.begin(), m2.end(), m1.begin(), m1.end());
+}
+
+/**
+   \brief Store in result the leading monomials of a Groebner basis that are
+   not divisible by other leading monomials. This set is unique for a given
+   ideal and monomial order, and it is {1} if the equations are inconsistent.
+   A monomial is represented by the sorted ids of its variables.
+*/
+static void get_minimal_leading_monomials(grobner const & gb, vector<unsigned_vector> & result) {
+    ptr_vector<grobner::equation> eqs;
+    gb.get_equations(eqs);
+    vector<unsigned_vector> lms;
+    for (unsigned i = 0; i < eqs.size(); i++) {
+        if (eqs[i]->get_num_monomials() == 0)
+            continue;
+        grobner::monomial const * lm = eqs[i]->get_monomial(0);
+        unsigned_vector ids;
+        for (unsigned j = 0; j < lm->get_degree(); j++)
+            ids.push_back(lm->get_var(j)->get_id());
+        std::sort(ids.begin(), ids.end());
+        lms.push_back(ids);
+    }
+    for (unsigned i = 0; i < lms.size(); i++) {
+        bool minimal = true;
+        for (unsigned j = 0; minimal && j < lms.size(); j++) {
+            if (i != j && divides(lms[j], lms[i]) && (!divides(lms[i], lms[j]) || j < i))
+                minimal = false;
+        }
+        if (minimal)
+            result.push_back(lms[i]);
+    }
+}
+
+static bool same_monomials(vector<unsigned_vector> const & ms1, vector<unsigned_vector> const & ms2) {
+    if (ms1.size() != ms2.size())
+        return false;
+    for (unsigned i = 0; i < ms1.size(); i++) {
+        bool found = false;
+        for (unsigned j = 0; !found && j < ms2.size(); j++)
+            found = ms1[i].size() == ms2[j].size() && divides(ms1[i], ms2[j]);
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+/**
+   \brief Compute a Groebner basis of random equations with Buchberger and F4
+   steps, and compare the results.
+*/
+static void tst_grobner_random(unsigned seed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    random_gen r(seed);
+    app_ref_vector xs(m);
+    unsigned num_vars = 2 + r(3);
+    for (unsigned i = 0; i < num_vars; i++)
+        xs.push_back(m.mk_fresh_const("x", a.mk_real()));
+
+    vector<unsigned_vector> lms[2];
+    for (unsigned k = 0; k < 2; k++) {
+        v_dependency_manager dm;
+        grobner gb(m, dm);
+        gb.set_f4(k == 1);
+        random_gen rk(seed);
+        unsigned num_eqs = 2 + rk(2);
+        for (unsigned i = 0; i < num_eqs; i++) {
+            ptr_vector<grobner::monomial> ms;
+            unsigned num_ms = 1 + rk(4);
+            for (unsigned j = 0; j < num_ms; j++) {
+                ptr_vector<expr> vars;
+                unsigned deg = rk(3);
+                for (unsigned l = 0; l < deg; l++)
+                    vars.push_back(xs.get(rk(num_vars)));
+                rational c(static_cast<int>(rk(7)) - 3);
+                if (c.is_zero())
+                    c = rational(1);
+                ms.push_back(gb.mk_monomial(c, vars.size(), vars.c_ptr()));
+            }
+            gb.assert_eq_0(ms.size(), ms.c_ptr());
+        }
+        if (!gb.compute_basis(10000))
+            return;
+        get_minimal_leading_monomials(gb, lms[k]);
+    }
+    if (!same_monomials(lms[0], lms[1])) {
+        std::cout << "seed: " << seed << " buchberger: " << lms[0].size() << " f4: " << lms[1].size() << "\n";
+        UNREACHABLE();
+    }
+}
+
+static Z3_lbool check_nra(char const * spec, bool f4) {
+    Z3_global_param_set("smt.arith.nl.gb.f4", f4 ? "true" : "false");
+    Z3_context ctx = Z3_mk_context(0);
+    Z3_ast fml = Z3_parse_smtlib2_string(ctx, spec, 0, 0, 0, 0, 0, 0);
+    Z3_solver s = Z3_mk_solver(ctx);
+    Z3_solver_inc_ref(ctx, s);
+    Z3_solver_assert(ctx, s, fml);
+    Z3_lbool r = Z3_solver_check(ctx, s);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_del_context(ctx);
+    Z3_global_param_reset_all();
+    return r;
+}
+
+void tst_grobner() {
+    for (unsigned seed = 0; seed < 200; seed++)
+        tst_grobner_random(seed);
+
+    char const * specs[] = {
+        "(declare-const x Real) (declare-const y Real) (declare-const z Real)\n"
+        "(assert (= (* x y) 1.0)) (assert (= (* y z) 2.0)) (assert (= (* x z) 0.0))",
+        "(declare-const x Real) (declare-const y Real)\n"
+        "(assert (= (+ (* x x) (* y y)) 1.0)) (assert (= (* x y) 0.5)) (assert (= (- x y) 0.0))",
+        "(declare-const x Real) (declare-const y Real) (declare-const z Real)\n"
+        "(assert (= (* x y z) 1.0)) (assert (= (+ (* x y) z) 2.0)) (assert (> z 1.0))",
+        "(declare-const x Real) (declare-const y Real) (declare-const z Real)\n"
+        "(assert (= (+ (* x x) (* 2.0 y z)) 0.0)) (assert (= (- (* x y) z) 1.0)) (assert (= (* z z) (* x x x)))\n"
+        "(assert (< x (- 1.0)))",
+    };
+    for (unsigned i = 0; i < sizeof(specs)/sizeof(specs[0]); i++) {
+        Z3_lbool r1 = check_nra(specs[i], false);
+        Z3_lbool r2 = check_nra(specs[i], true);
+        std::cout << "buchberger: " << r1 << " f4: " << r2 << "\n";
+        VERIFY(r1 == Z3_L_UNDEF || r2 == Z3_L_UNDEF || r1 == r2);
+    }
+}
@@ -23,6 +23,8 @@ Revision History:
 #include"ast.h"
 #include"debug.h"
 #include"rlimit.h"
+#include"double_interval.h"
+#include"hwf.h"
 
 template class interval_manager<im_default_config>;
 typedef im_default_config::interval interval;
@@ -289,6 +291,26 @@ static void tst_pw_2(unsigned N, unsigned magnitude) {
     del_interval(imc, a); del_interval(imc, b); del_interval(imc, r);
 }
 
+// The square of the open interval (-1, 0) is approximated by [0, 1), it contains zero.
+static void tst_pw_2_open() {
+    reslimit rl;
+    unsynch_mpq_manager                 nm;
+    im_default_config                   imc(nm);
+    interval_manager<im_default_config> im(rl, imc);
+    interval a, r;
+    a.m_lower_open = true;
+    a.m_lower_inf  = false;
+    nm.set(a.m_lower, -1);
+    a.m_upper_open = true;
+    a.m_upper_inf  = false;
+    nm.set(a.m_upper, 0);
+    VERIFY(!im.contains_zero(a));
+    im.power(a, 2, r);
+    im.display(std::cout, r); std::cout << "\n";
+    VERIFY(im.contains_zero(r));
+    del_interval(imc, a); del_interval(imc, r);
+}
+
 static void tst_pw_3(unsigned N, unsigned magnitude) {
     reslimit rl;
     unsynch_mpq_manager                 nm;
@@ -464,6 +486,124 @@ static void tst_pi_float() {
 }
 #endif
 
+static bool dinterval_contains(hwf_manager & fm, unsynch_mpq_manager & qm, dinterval const & a, mpq const & v) {
+    scoped_mpq b(qm);
+    hwf h;
+    if (a.lower() != -HUGE_VAL) {
+        fm.set(h, a.lower());
+        fm.to_rational(h, qm, b);
+        if (qm.gt(b, v))
+            return false;
+    }
+    if (a.upper() != HUGE_VAL) {
+        fm.set(h, a.upper());
+        fm.to_rational(h, qm, b);
+        if (qm.lt(b, v))
+            return false;
+    }
+    return true;
+}
+
+static void mk_random_rational(unsynch_mpq_manager & qm, mpq & a) {
+    scoped_mpz n(qm), d(qm);
+    qm.set(n, rand() - RAND_MAX/2);
+    qm.set(d, rand()%1000 + 1);
+    if (rand()%4 == 0)
+        qm.mul2k(n, rand()%70);
+    if (rand()%4 == 0)
+        qm.set(d, 1);
+    qm.set(a, n, d);
+}
+
+static void tst_double_interval(unsigned N) {
+    unsynch_mpq_manager qm;
+    hwf_manager         fm;
+    scoped_mpq a(qm), b(qm), r(qm);
+    scoped_mpq_vector   xs(qm);
+    svector<dinterval>  ixs;
+    for (unsigned i = 0; i < N; i++) {
+        dinterval ia, ib, ir;
+        mk_random_rational(qm, a);
+        mk_random_rational(qm, b);
+        dinterval_set(qm, a, ia);
+        dinterval_set(qm, b, ib);
+        VERIFY(dinterval_contains(fm, qm, ia, a));
+        VERIFY(dinterval_contains(fm, qm, ib, b));
+        VERIFY(ia.lower() <= ia.upper());
+
+        {
+            dinterval_round_up up;
+            dinterval_add(ia, ib, ir);
+        }
+        qm.add(a, b, r);
+        VERIFY(dinterval_contains(fm, qm, ir, r));
+        {
+            dinterval_round_up up;
+            dinterval_sub(ia, ib, ir);
+        }
+        qm.sub(a, b, r);
+        VERIFY(dinterval_contains(fm, qm, ir, r));
+        {
+            dinterval_round_up up;
+            dinterval_mul(ia, ib, ir);
+        }
+        qm.mul(a, b, r);
+        VERIFY(dinterval_contains(fm, qm, ir, r));
+        if (!qm.is_zero(b)) {
+            {
+                dinterval_round_up up;
+                dinterval_div(ia, ib, ir);
+            }
+            qm.div(a, b, r);
+            VERIFY(dinterval_contains(fm, qm, ir, r));
+        }
+
+        // the product of the hull of a and b with the hull of a and -b must contain all corners
+        dinterval hab(std::min(ia.lower(), ib.lower()), std::max(ia.upper(), ib.upper()));
+        dinterval hanb(std::min(ia.lower(), -ib.upper()), std::max(ia.upper(), -ib.lower()));
+        if (rand()%8 == 0)
+            hanb.m_u = HUGE_VAL;
+        {
+            dinterval_round_up up;
+            dinterval_mul(hab, hanb, ir);
+        }
+        qm.mul(a, a, r);
+        VERIFY(dinterval_contains(fm, qm, ir, r));
+        scoped_mpq nb(qm);
+        qm.set(nb, b);
+        qm.neg(nb);
+        qm.mul(b, nb, r);
+        VERIFY(dinterval_contains(fm, qm, ir, r));
+        qm.mul(a, nb, r);
+        VERIFY(dinterval_contains(fm, qm, ir, r));
+
+        xs.push_back(a);
+        ixs.push_back(ia);
+    }
+    // 0 * (-oo, +oo) = 0
+    dinterval ir;
+    {
+        dinterval_round_up up;
+        dinterval_mul(dinterval(0.0, 0.0), dinterval::entire(), ir);
+    }
+    VERIFY(ir.lower() == 0.0 && ir.upper() == 0.0);
+    // batched operations
+    svector<dinterval> irs;
+    irs.resize(ixs.size());
+    {
+        dinterval_round_up up;
+        dinterval_mul(ixs.size(), ixs.c_ptr(), ixs.c_ptr(), irs.c_ptr());
+        dinterval_sum(irs.size(), irs.c_ptr(), ir);
+    }
+    qm.reset(r);
+    for (unsigned i = 0; i < xs.size(); i++) {
+        qm.mul(xs[i], xs[i], a);
+        qm.add(r, a, r);
+        VERIFY(dinterval_contains(fm, qm, irs[i], a));
+    }
+    VERIFY(dinterval_contains(fm, qm, ir, r));
+}
+
 #define NUM_TESTS 1000
 #define SMALL_MAG 3
 #define MID_MAG   10
@@ -475,11 +615,13 @@ void tst_interval() {
     // enable_trace("interval_nth_root");
     // tst_pi();
     // tst_pi_float();
+    tst_double_interval(NUM_TESTS);
     tst_root_2(NUM_TESTS, MID_MAG, 100);
     tst_root_3(NUM_TESTS, MID_MAG, 100);
     tst_div(NUM_TESTS, SMALL_MAG);
     tst_inv(NUM_TESTS, SMALL_MAG);
     tst_pw_2(NUM_TESTS, SMALL_MAG);
+    tst_pw_2_open();
     tst_pw_3(NUM_TESTS, SMALL_MAG);
     tst_neg(NUM_TESTS, SMALL_MAG);
     tst_sub(NUM_TESTS, SMALL_MAG);
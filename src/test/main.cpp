@@ -166,6 +166,7 @@ int main(int argc, char ** argv) {
     TST(object_allocator);
     TST(mpz);
     TST(mpq);
+    TST_ARGV(mpz_bench);
     TST(mpf);
     TST(total_order);
     TST(dl_table);
@@ -185,6 +186,7 @@ int main(int argc, char ** argv) {
     TST(check_assumptions);
     TST(smt_context);
     TST(theory_dl);
+    TST(theory_fpa);
     TST(model_retrieval);
     TST(factor_rewriter);
     TST(smt2print_parse);
@@ -226,6 +228,10 @@ int main(int argc, char ** argv) {
     TST(sat_user_scope);
     TST(pdr);
     TST_ARGV(ddnf);
+    TST(bv_simulator);
+    TST(compiled_model_evaluator);
+    TST(func_interp);
+    TST(grobner);
     //TST_ARGV(hs);
 }
 
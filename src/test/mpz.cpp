@@ -488,6 +488,133 @@ static void tst_pw2() {
     }
 }
 
+static void mk_random_digits(unsynch_mpz_manager & m, unsigned num_digits, mpz & r) {
+    scoped_mpz d(m);
+    m.reset(r);
+    for (unsigned i = 0; i < num_digits; i++) {
+        m.mul2k(r, 32);
+        m.set(d, static_cast<unsigned>(rand()) ^ (static_cast<unsigned>(rand()) << 16));
+        m.add(r, d, r);
+    }
+}
+
+// Check the subquadratic multiplication and division against
+// multiplication by single digits.
+static void tst_large_mul_div(unsigned num_iterations, unsigned max_digits) {
+    unsynch_mpz_manager m;
+    scoped_mpz a(m), b(m), c(m), expected(m), d(m), t(m), x(m), base(m), n(m), q(m), r(m);
+    m.power(mpz(2), 32, base);
+    for (unsigned it = 0; it < num_iterations; it++) {
+        mk_random_digits(m, 1 + rand() % max_digits, a);
+        mk_random_digits(m, 1 + rand() % max_digits, b);
+        if (m.is_zero(b))
+            continue;
+        m.mul(a, b, c);
+        m.reset(expected);
+        m.set(x, b);
+        for (unsigned i = 0; !m.is_zero(x); i++) {
+            m.rem(x, base, d);
+            m.mul(a, d, t);
+            m.mul2k(t, 32*i);
+            m.add(expected, t, expected);
+            m.machine_div2k(x, 32);
+        }
+        SASSERT(m.eq(c, expected));
+        mk_random_digits(m, 1 + rand() % max_digits, t);
+        m.add(c, t, n);
+        m.machine_div(n, b, q);
+        m.rem(n, b, r);
+        SASSERT(m.lt(r, b));
+        m.mul(q, b, t);
+        m.add(t, r, t);
+        SASSERT(m.eq(t, n));
+    }
+}
+
+static int64 mk_random_int64() {
+    uint64 v = 0;
+    for (unsigned i = 0; i < 4; i++)
+        v = (v << 16) ^ static_cast<uint64>(rand());
+    // mix values close to the small/int64 boundaries with arbitrary ones
+    switch (rand() % 4) {
+    case 0: v &= 0xFFFFFFFFull; break;
+    case 1: v &= 0x3FFFFFFFFFFFFFFFull; break;
+    default: break;
+    }
+    return rand() % 2 == 0 ? static_cast<int64>(v) : -static_cast<int64>(v >> 1);
+}
+
+// Check the machine integer fast paths against the same operations
+// on operands shifted past 64 bits.
+template<bool SYNCH>
+static void tst_int64_ops(mpz_manager<SYNCH> & m, unsigned num_iterations) {
+    _scoped_numeral<mpz_manager<SYNCH> > a(m), b(m), c(m), q(m), r(m), A(m), B(m), C(m);
+    for (unsigned it = 0; it < num_iterations; it++) {
+        m.set(a, mk_random_int64());
+        m.set(b, mk_random_int64());
+        m.mul2k(a, 64, A);
+        m.mul2k(b, 64, B);
+
+        m.add(a, b, c);
+        m.add(A, B, C);
+        m.mul2k(c, 64);
+        SASSERT(m.eq(c, C));
+
+        m.sub(a, b, c);
+        m.sub(A, B, C);
+        m.mul2k(c, 64);
+        SASSERT(m.eq(c, C));
+
+        m.mul(a, b, c);
+        m.mul(A, b, C);
+        m.mul2k(c, 64);
+        SASSERT(m.eq(c, C));
+
+        m.gcd(a, b, c);
+        m.gcd(A, B, C);
+        m.mul2k(c, 64);
+        SASSERT(m.eq(c, C));
+
+        if (m.is_zero(b))
+            continue;
+        m.machine_div_rem(a, b, q, r);
+        m.mul(q, b, c);
+        m.add(c, r, c);
+        SASSERT(m.eq(c, a));
+        m.abs(r);
+        m.set(c, b);
+        m.abs(c);
+        SASSERT(m.lt(r, c));
+        m.machine_div(a, b, c);
+        SASSERT(m.eq(c, q));
+    }
+}
+
+static void tst_int64_fast_paths() {
+    unsynch_mpz_manager um;
+    tst_int64_ops(um, 2000);
+    synch_mpz_manager sm;
+    tst_int64_ops(sm, 2000);
+    // the synchronized manager does not use a lock
+    for (unsigned k = 0; k < 2; k++) {
+        #pragma omp parallel for
+        for (int i = 0; i < 8; i++) {
+            _scoped_numeral<synch_mpz_manager> a(sm), b(sm), c(sm);
+            sm.set(a, "123456789012345678901234567890");
+            sm.set(b, i + 1);
+            for (unsigned j = 0; j < 1000; j++) {
+                sm.mul(a, b, c);
+                sm.machine_div(c, b, c);
+                VERIFY(sm.eq(a, c));
+            }
+        }
+#ifdef _MP_THREAD_SCRATCH
+        // the worker threads allocate new scratch cells after they are released
+        finalize_mpz_thread_scratch();
+#endif
+    }
+}
+
 void tst_mpz() {
     disable_trace("mpz");
     enable_trace("mpz_2k");
@@ -498,6 +625,8 @@ void tst_mpz() {
     tst_2k();
     tst_gcd_bug();
     tst_root();
+    tst_large_mul_div(200, 300);
+    tst_int64_fast_paths();
     tst_log2();
     // tst_gcd();
     tst_scoped();
@@ -0,0 +1,107 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+Module Name:
+
+    mpz_bench.cpp
+
+Abstract:
+
+    Micro-benchmark for mpz and mpq operations over operands of
+    increasing number of digits.
+
+    Usage: test-z3 mpz_bench [max_digits]
+
+Author:
+
+Revision History:
+
+--*/
+#include<iostream>
+#include<iomanip>
+#include<cstdlib>
+#include"mpq.h"
+#include"stopwatch.h"
+
+static void mk_random(unsynch_mpq_manager & m, unsigned num_digits, mpz & r) {
+    scoped_mpz d(m);
+    m.reset(r);
+    for (unsigned i = 0; i < num_digits; i++) {
+        m.mul2k(r, 32);
+        m.set(d, static_cast<unsigned>(rand()) ^ (static_cast<unsigned>(rand()) << 16));
+        m.add(r, d, r);
+    }
+    if (m.is_zero(r))
+        m.set(r, 1);
+}
+
+static void report(char const * op, unsigned num_digits, unsigned num_ops, stopwatch const & sw) {
+    double us = 1000000.0 * sw.get_seconds() / num_ops;
+    std::cout << std::setw(8) << op << std::setw(8) << num_digits
+              << std::setw(14) << std::fixed << std::setprecision(3) << us << " us/op" << std::endl;
+}
+
+static void bench(unsynch_mpq_manager & m, unsigned num_digits) {
+    // keep the number of digit operations roughly constant across sizes
+    unsigned num_ops = std::max(4u, 200000u / (num_digits * num_digits));
+    scoped_mpz a(m), b(m), c(m), q(m), r(m);
+    scoped_mpq p(m), s(m), t(m);
+    mk_random(m, num_digits, a);
+    mk_random(m, num_digits, b);
+    stopwatch sw;
+
+    sw.start();
+    for (unsigned i = 0; i < num_ops; i++)
+        m.mul(a, b, c);
+    sw.stop();
+    report("mul", num_digits, num_ops, sw);
+
+    mk_random(m, 2 * num_digits, c);
+    sw.reset();
+    sw.start();
+    for (unsigned i = 0; i < num_ops; i++) {
+        m.machine_div(c, b, q);
+        m.rem(c, b, r);
+    }
+    sw.stop();
+    report("div", num_digits, num_ops, sw);
+
+    sw.reset();
+    sw.start();
+    for (unsigned i = 0; i < num_ops; i++)
+        m.gcd(a, b, r);
+    sw.stop();
+    report("gcd", num_digits, num_ops, sw);
+
+    m.set(p, a, b);
+    mk_random(m, num_digits, c);
+    m.set(s, b, c);
+    sw.reset();
+    sw.start();
+    for (unsigned i = 0; i < num_ops; i++)
+        m.add(p, s, t);
+    sw.stop();
+    report("q-add", num_digits, num_ops, sw);
+
+    sw.reset();
+    sw.start();
+    for (unsigned i = 0; i < num_ops; i++)
+        m.mul(p, s, t);
+    sw.stop();
+    report("q-mul", num_digits, num_ops, sw);
+}
+
+void tst_mpz_bench(char ** argv, int argc, int & i) {
+    unsigned max_digits = 1024;
+    if (i + 1 < argc) {
+        int n = atoi(argv[i + 1]);
+        if (n > 0) {
+            max_digits = n;
+            ++i;
+        }
+    }
+    unsynch_mpq_manager m;
+    srand(0);
+    for (unsigned num_digits = 2; num_digits <= max_digits; num_digits *= 2)
+        bench(m, num_digits);
+}
@@ -22,6 +22,7 @@ Notes:
 #include"nlsat_solver.h"
 #include"util.h"
 #include"rlimit.h"
+#include"z3.h"
 
 nlsat::interval_set_ref tst_interval(nlsat::interval_set_ref const & s1,
                                      nlsat::interval_set_ref const & s2,
@@ -302,7 +303,241 @@ static void tst5() {
     std::cout << "2) " << i << "\n";
 }
 
+static nlsat::literal mk_lit(nlsat::solver & s, nlsat::atom::kind k, polynomial_ref const & p) {
+    nlsat::poly * _p[1] = { p.get() };
+    bool is_even[1] = { false };
+    return s.mk_ineq_literal(k, 1, _p, is_even);
+}
+
+static lbool check_icp(nlsat::solver & s, unsigned * num_failures = 0) {
+    lbool r = s.check();
+    statistics st;
+    s.collect_statistics(st);
+    st.display(std::cout);
+    if (num_failures != 0)
+        *num_failures = 0;
+    for (unsigned i = 0; num_failures != 0 && i < st.size(); i++)
+        if (strcmp(st.get_key(i), "nlsat icp failures") == 0)
+            *num_failures = st.get_uint_value(i);
+    return r;
+}
+
+static void tst_icp() {
+    params_ref      ps;
+    ps.set_bool("icp", true);
+    {
+        // x^2 + y^2 < 1 and x > 2 is infeasible
+        reslimit      rlim;
+        nlsat::solver s(rlim, ps);
+        nlsat::pmanager & pm = s.pm();
+        polynomial_ref x(pm), y(pm), p(pm);
+        x = pm.mk_polynomial(s.mk_var(false));
+        y = pm.mk_polynomial(s.mk_var(false));
+        p = (x^2) + (y^2) - 1;
+        nlsat::literal l1 = mk_lit(s, nlsat::atom::LT, p);
+        p = x - 2;
+        nlsat::literal l2 = mk_lit(s, nlsat::atom::GT, p);
+        s.mk_clause(1, &l1);
+        s.mk_clause(1, &l2);
+        VERIFY(check_icp(s) == l_false);
+    }
+    {
+        // 1 <= x <= 3, x*y > 1, y < 2
+        reslimit      rlim;
+        nlsat::solver s(rlim, ps);
+        nlsat::pmanager & pm = s.pm();
+        polynomial_ref x(pm), y(pm), p(pm);
+        nlsat::var _x = s.mk_var(false);
+        nlsat::var _y = s.mk_var(false);
+        x = pm.mk_polynomial(_x);
+        y = pm.mk_polynomial(_y);
+        nlsat::literal ls[4];
+        p = x - 1; 
+        ls[0] = ~mk_lit(s, nlsat::atom::LT, p);
+        p = x - 3;
+        ls[1] = ~mk_lit(s, nlsat::atom::GT, p);
+        p = x*y - 1;
+        ls[2] = mk_lit(s, nlsat::atom::GT, p);
+        p = y - 2;
+        ls[3] = mk_lit(s, nlsat::atom::LT, p);
+        for (unsigned i = 0; i < 4; i++)
+            s.mk_clause(1, ls + i);
+        VERIFY(check_icp(s) == l_true);
+        for (unsigned i = 0; i < 4; i++) {
+            VERIFY(s.value(ls[i]) == l_true);
+        }
+        std::cout << "x: "; s.am().display_decimal(std::cout, s.value(_x));
+        std::cout << ", y: "; s.am().display_decimal(std::cout, s.value(_y)); std::cout << "\n";
+    }
+    {
+        // x^2 + y^2 < 4 and (x^2 - 1)(y^2 - 1) > 0 and x*y > 3/2: requires search after the bounds are added
+        reslimit      rlim;
+        nlsat::solver s(rlim, ps);
+        nlsat::pmanager & pm = s.pm();
+        polynomial_ref x(pm), y(pm), p(pm);
+        x = pm.mk_polynomial(s.mk_var(false));
+        y = pm.mk_polynomial(s.mk_var(false));
+        nlsat::literal ls[3];
+        p = (x^2) + (y^2) - 4;
+        ls[0] = mk_lit(s, nlsat::atom::LT, p);
+        p = ((x^2) - 1)*((y^2) - 1);
+        ls[1] = mk_lit(s, nlsat::atom::GT, p);
+        p = 2*x*y - 3;
+        ls[2] = mk_lit(s, nlsat::atom::GT, p);
+        for (unsigned i = 0; i < 3; i++)
+            s.mk_clause(1, ls + i);
+        lbool r = check_icp(s);
+        VERIFY(r == l_true);
+        for (unsigned i = 0; i < 3; i++) {
+            VERIFY(s.value(ls[i]) == l_true);
+        }
+    }
+    {
+        // x*y^2 = 1, -1 < y < 0, x < 2: the bounds of y^2 contain zero, 
+        // and they must not be used to divide the bounds of x*y^2.
+        reslimit      rlim;
+        nlsat::solver s(rlim, ps);
+        nlsat::pmanager & pm = s.pm();
+        polynomial_ref x(pm), y(pm), p(pm);
+        x = pm.mk_polynomial(s.mk_var(false));
+        y = pm.mk_polynomial(s.mk_var(false));
+        nlsat::literal ls[4];
+        p = x*(y^2) - 1;
+        ls[0] = mk_lit(s, nlsat::atom::EQ, p);
+        p = y + 1;
+        ls[1] = mk_lit(s, nlsat::atom::GT, p);
+        ls[2] = mk_lit(s, nlsat::atom::LT, y);
+        p = x - 2;
+        ls[3] = mk_lit(s, nlsat::atom::LT, p);
+        for (unsigned i = 0; i < 4; i++)
+            s.mk_clause(1, ls + i);
+        unsigned num_failures;
+        VERIFY(check_icp(s, &num_failures) == l_true);
+        VERIFY(num_failures == 0);
+    }
+}
+
+static Z3_lbool check_nra(char const * spec, bool icp) {
+    Z3_global_param_set("nlsat.icp", icp ? "true" : "false");
+    Z3_context ctx = Z3_mk_context(0);
+    Z3_ast fml = Z3_parse_smtlib2_string(ctx, spec, 0, 0, 0, 0, 0, 0);
+    Z3_inc_ref(ctx, fml);
+    // (then simplify purify-arith nlsat)
+    char const * names[3] = { "simplify", "purify-arith", "nlsat" };
+    Z3_tactic t = Z3_mk_tactic(ctx, names[2]);
+    Z3_tactic_inc_ref(ctx, t);
+    for (unsigned i = 2; i-- > 0; ) {
+        Z3_tactic t1 = Z3_mk_tactic(ctx, names[i]);
+        Z3_tactic_inc_ref(ctx, t1);
+        Z3_tactic t2 = Z3_tactic_and_then(ctx, t1, t);
+        Z3_tactic_inc_ref(ctx, t2);
+        Z3_tactic_dec_ref(ctx, t1);
+        Z3_tactic_dec_ref(ctx, t);
+        t = t2;
+    }
+    Z3_solver s = Z3_mk_solver_from_tactic(ctx, t);
+    Z3_solver_inc_ref(ctx, s);
+    Z3_solver_assert(ctx, s, fml);
+    Z3_lbool r = Z3_solver_check(ctx, s);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_tactic_dec_ref(ctx, t);
+    Z3_dec_ref(ctx, fml);
+    Z3_del_context(ctx);
+    Z3_global_param_reset_all();
+    return r;
+}
+
+// The result with the icp pre-phase must be the result without it.
+static void tst_icp_sound() {
+    char const * specs[] = {
+        // y = -1/5 is not a mpff numeral
+        "(declare-const y Real) (assert (= (+ (* 5.0 y) 1.0) 0.0))",
+        "(declare-const x Real) (declare-const y Real) (declare-const z Real)\n"
+        "(assert (< (+ (* 4.0 z) (* 3.0 x)) 0.0)) (assert (= (+ (* 5.0 y) 1.0) 0.0))\n"
+        "(assert (= (+ (* -3.0 y) (* 4.0 y x)) 0.0)) (assert (< (* 2.0 z x) 0.0))",
+        "(declare-const x Real) (declare-const y Real) (declare-const z Real)\n"
+        "(assert (= (+ (* -2.0 x) (* -3.0 y x)) 0.0)) (assert (> (+ (* -1.0 z x) (* -1.0 z)) 0.0))\n"
+        "(assert (or (> (+ -5.0 (* -3.0 z x)) 0.0) (> (+ z (* -3.0 z z)) 0.0))) (assert (<= (+ (* 2.0 y x) (* -2.0 z)) 0.0))",
+        // the constant of a sum
+        "(declare-const x Real) (declare-const y Real)\n"
+        "(assert (>= y 0.0)) (assert (<= y 1.0)) (assert (= (- x y 1.0) 0.0)) (assert (> x 1.5))",
+        // y <= 0 does not imply y^2 = 0
+        "(declare-const x Real) (declare-const y Real) (assert (<= y 0.0)) (assert (= (* x y y) 1.0))",
+        // the bounds of x are implied by the product of the bounds of y and z
+        "(declare-const x Real) (declare-const y Real) (declare-const z Real)\n"
+        "(assert (= (* x y z) 1.0)) (assert (<= 1.0 y 2.0)) (assert (<= 10.0 z 20.0)) (assert (< x 0.04))",
+        // y^2 is approximated by [0, 1) for y in (-1, 0)
+        "(declare-const x Real) (declare-const y Real)\n"
+        "(assert (= (* x y y) 1.0)) (assert (< (- 1.0) y)) (assert (< y 0.0)) (assert (< x 2.0))",
+        "(declare-const x Real) (declare-const y Real) (declare-const z Real)\n"
+        "(assert (= (+ (* 2.0 z x) 2.0 (* -1.0 x)) 0.0)) (assert (<= (+ (* 3.0 y y) (* 2.0 y) (* 5.0 x y)) 0.0))",
+    };
+    for (unsigned i = 0; i < sizeof(specs)/sizeof(specs[0]); i++) {
+        Z3_lbool r1 = check_nra(specs[i], false);
+        Z3_lbool r2 = check_nra(specs[i], true);
+        std::cout << "icp=false: " << r1 << " icp=true: " << r2 << "\n";
+        VERIFY(r1 == Z3_L_UNDEF || r2 == Z3_L_UNDEF || r1 == r2);
+    }
+}
+
+static void tst_push_pop(bool icp) {
+    reslimit      rlim;
+    params_ref    ps;
+    ps.set_bool("icp", icp);
+    nlsat::solver s(rlim, ps);
+    nlsat::pmanager & pm = s.pm();
+    polynomial_ref x(pm), y(pm), p(pm);
+    nlsat::var _x = s.mk_var(false);
+    x = pm.mk_polynomial(_x);
+    y = pm.mk_polynomial(s.mk_var(false));
+    int a1 = 1, a2 = 2, a3 = 3;
+    // x^2 + y^2 < 1
+    p = (x^2) + (y^2) - 1;
+    nlsat::literal l1 = mk_lit(s, nlsat::atom::LT, p);
+    s.mk_clause(1, &l1, &a1);
+    VERIFY(s.check() == l_true);
+    s.push();
+    // x > 2
+    p = x - 2;
+    nlsat::literal l2 = mk_lit(s, nlsat::atom::GT, p);
+    s.mk_clause(1, &l2, &a2);
+    SASSERT(s.num_scopes() == 1);
+    VERIFY(s.check() == l_false);
+    vector<nlsat::assumption, false> core;
+    s.get_core(core);
+    std::cout << "core size: " << core.size() << "\n";
+    SASSERT(core.size() == 2);
+    SASSERT(core.contains(&a1) && core.contains(&a2));
+    s.pop(1);
+    SASSERT(s.num_scopes() == 0);
+    VERIFY(s.check() == l_true);
+    SASSERT(s.value(l1) == l_true);
+    s.push();
+    // 4*x*y > 1
+    p = 4*x*y - 1;
+    nlsat::literal l3 = mk_lit(s, nlsat::atom::GT, p);
+    s.mk_clause(1, &l3, &a3);
+    VERIFY(s.check() == l_true);
+    SASSERT(s.value(l1) == l_true && s.value(l3) == l_true);
+    std::cout << "x: "; s.am().display_decimal(std::cout, s.value(_x)); std::cout << "\n";
+    s.push();
+    p = x;
+    nlsat::literal l4 = mk_lit(s, nlsat::atom::LT, p);
+    s.mk_clause(1, &l4);
+    VERIFY(s.check() == l_true);
+    SASSERT(s.value(l4) == l_true);
+    s.pop(2);
+    VERIFY(s.check() == l_true);
+    statistics st;
+    s.collect_statistics(st);
+    st.display(std::cout);
+}
+
 void tst_nlsat() {
+    tst_push_pop(false);
+    tst_push_pop(true);
+    tst_icp();
+    tst_icp_sound();
     tst5();
     tst4();
     tst3();
@@ -835,6 +835,51 @@ static void tst_psc() {
 #endif
 }
 
+static void mk_random_poly(polynomial_ref const & a, polynomial_ref const & b, polynomial_ref const & x, 
+                           unsigned max_deg, int max_coeff, polynomial_ref & r) {
+    polynomial::manager & m = r.m();
+    r = m.mk_zero();
+    for (unsigned k = 0; k <= max_deg; k++) {
+        polynomial_ref c(m);
+        c = (rand() % (2*max_coeff + 1) - max_coeff) * (a^(1 + rand() % 2));
+        c = c + (rand() % (2*max_coeff + 1) - max_coeff) * (a * (b^(1 + rand() % 2)));
+        c = c + (rand() % (2*max_coeff + 1) - max_coeff);
+        r = k == 0 ? r + c : r + c * (x^k);
+    }
+    r = r + (a + 1) * (x^(max_deg+1));
+}
+
+// Compare the multi-modular resultant and psc_chain with the subresultant PRS over Z.
+static void tst_modular_psc() {
+    reslimit rl;
+    polynomial::numeral_manager nm;
+    polynomial::manager m(rl, nm);
+    polynomial_ref a(m), b(m), x(m), p(m), q(m), r1(m), r2(m);
+    a = m.mk_polynomial(m.mk_var());
+    b = m.mk_polynomial(m.mk_var());
+    x = m.mk_polynomial(m.mk_var());
+    polynomial::var vx = max_var(x);
+    for (unsigned i = 0; i < 40; i++) {
+        mk_random_poly(a, b, x, 1 + rand() % 4, 1 + (i % 4) * 1000, p);
+        mk_random_poly(a, b, x, 1 + rand() % 3, 3, q);
+        if (i % 5 == 0)
+            q = q * p + 1; 
+        polynomial_ref_vector S1(m), S2(m);
+        m.set_use_modular_psc(false);
+        r1 = resultant(p, q, vx);
+        m.psc_chain(p, q, vx, S1);
+        m.set_use_modular_psc(true);
+        r2 = resultant(p, q, vx);
+        m.psc_chain(p, q, vx, S2);
+        m.set_use_modular_psc(false);
+        SASSERT(m.eq(r1, r2));
+        SASSERT(S1.size() == S2.size());
+        for (unsigned j = 0; j < S1.size(); j++) {
+            SASSERT(m.eq(S1.get(j), S2.get(j)));
+        }
+    }
+}
+
 static void tst_vars(polynomial_ref const & p, unsigned sz, polynomial::var * xs) {
     polynomial::var_vector r;
     p.m().vars(p, r);
@@ -1422,6 +1467,42 @@ static void tst_mk_unique() {
     SASSERT(p.get() == q.get());
 }
 
+static void tst_cache_lru() {
+    polynomial::numeral_manager nm;
+    reslimit rl; polynomial::manager m(rl, nm);
+    polynomial_ref a(m), b(m), x(m), p(m), q(m);
+    a = m.mk_polynomial(m.mk_var());
+    b = m.mk_polynomial(m.mk_var());
+    x = m.mk_polynomial(m.mk_var());
+    polynomial::var vx = max_var(x);
+    polynomial::cache c(m, 4);
+    polynomial_ref_vector S1(m), S2(m);
+    for (unsigned i = 1; i <= 10; i++) {
+        p = (x^3) + i*a*x + b;
+        q = (x^2) + a*b*x + i;
+        c.psc_chain(p, q, vx, S1);
+        SASSERT(c.num_entries() <= 4);
+        // cache hit
+        c.psc_chain(p, q, vx, S2);
+        SASSERT(S1.size() == S2.size());
+        for (unsigned j = 0; j < S1.size(); j++) {
+            SASSERT(S1.get(j) == S2.get(j));
+        }
+    }
+    // first entries were evicted, recompute them
+    p = (x^3) + a*x + b;
+    q = (x^2) + a*b*x + 1;
+    c.psc_chain(p, q, vx, S1);
+    m.psc_chain(p, q, vx, S2);
+    SASSERT(S1.size() == S2.size());
+    for (unsigned j = 0; j < S1.size(); j++) {
+        SASSERT(m.eq(S1.get(j), S2.get(j)));
+    }
+    statistics st;
+    c.collect_statistics(st);
+    st.display(std::cout);
+}
+
 struct dummy_del_eh : public polynomial::manager::del_eh {
     unsigned m_counter;
     dummy_del_eh():m_counter(0) {}
@@ -1823,6 +1904,8 @@ void tst_polynomial() {
     // enable_trace("eval_bug");
     // enable_trace("mgcd");
     tst_psc();
+    tst_modular_psc();
+    tst_cache_lru();
     return;
     tst_eval();
     tst_divides();
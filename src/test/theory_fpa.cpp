@@ -0,0 +1,87 @@
+/*++
+Copyright (c) 2015 Microsoft Corporation
+
+--*/
+
+#include "z3.h"
+#include "debug.h"
+#include <iostream>
+
+static Z3_solver mk_smt_solver(Z3_context ctx, bool lazy_ops) {
+    Z3_global_param_set("smt.fp.lazy_ops", lazy_ops ? "true" : "false");
+    Z3_tactic t = Z3_mk_tactic(ctx, "smt");
+    Z3_tactic_inc_ref(ctx, t);
+    Z3_solver s = Z3_mk_solver_from_tactic(ctx, t);
+    Z3_solver_inc_ref(ctx, s);
+    Z3_tactic_dec_ref(ctx, t);
+    return s;
+}
+
+static Z3_lbool check_fpa(char const * spec, bool lazy_ops) {
+    Z3_context ctx = Z3_mk_context(0);
+    Z3_solver s = mk_smt_solver(ctx, lazy_ops);
+    Z3_ast fml = Z3_parse_smtlib2_string(ctx, spec, 0, 0, 0, 0, 0, 0);
+    Z3_solver_assert(ctx, s, fml);
+    Z3_lbool r = Z3_solver_check(ctx, s);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_del_context(ctx);
+    Z3_global_param_reset_all();
+    return r;
+}
+
+/**
+   \brief Check the constraints in specs one after the other, each one in
+   its own scope on top of base, and return the result of the last check.
+*/
+static Z3_lbool check_fpa_scopes(char const * base, char const * const * specs, unsigned num_specs, bool lazy_ops, Z3_lbool * results) {
+    Z3_context ctx = Z3_mk_context(0);
+    Z3_solver s = mk_smt_solver(ctx, lazy_ops);
+    Z3_solver_assert(ctx, s, Z3_parse_smtlib2_string(ctx, base, 0, 0, 0, 0, 0, 0));
+    for (unsigned i = 0; i < num_specs; i++) {
+        Z3_solver_push(ctx, s);
+        Z3_solver_assert(ctx, s, Z3_parse_smtlib2_string(ctx, specs[i], 0, 0, 0, 0, 0, 0));
+        results[i] = Z3_solver_check(ctx, s);
+        Z3_solver_pop(ctx, s, 1);
+    }
+    Z3_lbool r = Z3_solver_check(ctx, s);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_del_context(ctx);
+    Z3_global_param_reset_all();
+    return r;
+}
+
+#define DECLS "(declare-const x (_ FloatingPoint 8 24)) (declare-const y (_ FloatingPoint 8 24))\n"
+
+void tst_theory_fpa() {
+    char const * specs[] = {
+        DECLS "(assert (fp.eq (fp.mul RNE x y) ((_ to_fp 8 24) RNE 6.0))) (assert (fp.eq x ((_ to_fp 8 24) RNE 2.0)))",
+        DECLS "(assert (fp.eq (fp.mul RNE x x) ((_ to_fp 8 24) RNE 2.0)))",
+        DECLS "(assert (fp.eq (fp.div RNE x y) ((_ to_fp 8 24) RNE 0.5))) (assert (fp.gt y ((_ to_fp 8 24) RNE 3.0)))",
+        DECLS "(assert (fp.lt (fp.sqrt RNE x) ((_ to_fp 8 24) RNE 0.0)))",
+        DECLS "(assert (= (fp.mul RNE x y) (fp.div RNE y x))) (assert (fp.eq x ((_ to_fp 8 24) RNE 4.0)))",
+    };
+    for (unsigned i = 0; i < sizeof(specs)/sizeof(specs[0]); i++) {
+        Z3_lbool r1 = check_fpa(specs[i], false);
+        Z3_lbool r2 = check_fpa(specs[i], true);
+        std::cout << "eager: " << r1 << " lazy: " << r2 << "\n";
+        VERIFY(r1 == r2);
+    }
+
+    // abstractions created in a scope are removed when the scope is popped
+    char const * base = DECLS "(assert (fp.gt x ((_ to_fp 8 24) RNE 1.0)))";
+    char const * scoped[] = {
+        DECLS "(assert (fp.eq (fp.mul RNE x y) ((_ to_fp 8 24) RNE 6.0))) (assert (fp.eq x ((_ to_fp 8 24) RNE 2.0)))",
+        DECLS "(assert (fp.lt (fp.mul RNE x x) ((_ to_fp 8 24) RNE 1.0)))",
+        DECLS "(assert (fp.eq (fp.div RNE y x) ((_ to_fp 8 24) RNE 3.0))) (assert (fp.lt y x))",
+        DECLS "(assert (fp.isNaN (fp.sqrt RNE (fp.neg x))))",
+    };
+    unsigned num_scoped = sizeof(scoped)/sizeof(scoped[0]);
+    Z3_lbool rs1[4], rs2[4];
+    Z3_lbool r1 = check_fpa_scopes(base, scoped, num_scoped, false, rs1);
+    Z3_lbool r2 = check_fpa_scopes(base, scoped, num_scoped, true, rs2);
+    for (unsigned i = 0; i < num_scoped; i++) {
+        std::cout << "scope " << i << " eager: " << rs1[i] << " lazy: " << rs2[i] << "\n";
+        VERIFY(rs1[i] == rs2[i]);
+    }
+    VERIFY(r1 == Z3_L_TRUE && r2 == Z3_L_TRUE);
+}
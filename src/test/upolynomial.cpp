@@ -278,6 +278,76 @@ static void tst_isolate_roots() {
 
 }
 
+enum isolation_kind { ISO_DRS, ISO_VCA, ISO_PAR };
+
+static void tst_vca_isolate_roots(polynomial_ref const & p, unsigned expected_sz, rational const * expected_roots) {
+    reslimit rl;
+    upolynomial::manager um(rl, p.m().m());
+    upolynomial::scoped_numeral_vector q(um);
+    um.to_numeral_vector(p, q);
+    SASSERT(!um.has_zero_roots(q.size(), q.c_ptr()));
+    mpbq_manager bqm(p.m().m());
+    for (unsigned kind = ISO_DRS; kind <= ISO_PAR; kind++) {
+        for (unsigned num_threads = 2; num_threads <= (kind == ISO_PAR ? 5u : 2u); num_threads++) {
+            scoped_mpbq_vector roots(bqm);
+            scoped_mpbq_vector lowers(bqm);
+            scoped_mpbq_vector uppers(bqm);
+            switch (kind) {
+            case ISO_DRS: um.sqf_isolate_roots(q.size(), q.c_ptr(), bqm, roots, lowers, uppers); break;
+            case ISO_VCA: um.vca_isolate_roots(q.size(), q.c_ptr(), bqm, roots, lowers, uppers); break;
+            default: um.par_isolate_roots(q.size(), q.c_ptr(), num_threads, bqm, roots, lowers, uppers); break;
+            }
+            std::cout << "kind: " << kind << ", threads: " << num_threads << ", roots: " << roots.size() << ", intervals: " << lowers.size() << "\n";
+            check_roots(roots, lowers, uppers, expected_sz, expected_roots);
+            for (unsigned i = 0; i < lowers.size(); i++) {
+                SASSERT(um.descartes_bound_a_b(q.size(), q.c_ptr(), bqm, lowers[i], uppers[i]) == 1);
+            }
+        }
+    }
+}
+
+static void tst_vca_isolate_roots() {
+    reslimit rl;
+    polynomial::numeral_manager nm;
+    polynomial::manager m(rl, nm);
+    polynomial_ref x(m);
+    x = m.mk_polynomial(m.mk_var());
+    polynomial_ref p(m);
+    p = (x-1)*(x-2);
+    {
+        rational ex[2] = { rational(1), rational(2) };
+        tst_vca_isolate_roots(p, 2, ex);
+    }
+    p = (x - 1)*(x + 1)*(x + 2)*(x + 3)*(x - 3);
+    {
+        rational ex[5] = { rational(1), rational(-1), rational(-2), rational(-3), rational(3) };
+        tst_vca_isolate_roots(p, 5, ex);
+    }
+    p = (10000*x - 31)*(10000*x - 32)*(10000*x - 33);
+    {
+        rational ex[3] = { rational(31, 10000), rational(32, 10000), rational(33, 10000) };
+        tst_vca_isolate_roots(p, 3, ex);
+    }
+    p = (x - 2)*(x - 4)*(x - 8)*(x - 16)*(x - 32)*(x - 64)*(2*x - 1)*(4*x - 1)*(8*x - 1)*(16*x - 1)*(32*x - 1);
+    {
+        rational ex[11] = { rational(2), rational(4), rational(8), rational(16), rational(32), rational(64),
+                            rational(1, 2), rational(1, 4), rational(1, 8), rational(1, 16), rational(1, 32) };
+        tst_vca_isolate_roots(p, 11, ex);
+    }
+    // roots at the slice end-points of the parallel procedure
+    p = x + 7;
+    rational ex[20];
+    unsigned sz = 0;
+    for (int i = -10; i <= 10; i++) {
+        if (i == 0 || i == -7)
+            continue;
+        p = p * (x - i);
+        ex[sz++] = rational(i);
+    }
+    ex[sz++] = rational(-7);
+    tst_vca_isolate_roots(p, sz, ex);
+}
+
 static void tst_remove_one_half() {
     reslimit rl;
     polynomial::numeral_manager nm;
@@ -907,9 +977,9 @@ static void tst_fact() {
     tst_fact((x0^4) + (x0^2) - 20, 3);
     tst_fact((x0^4) + (x0^2) - 20, 1, upolynomial::factor_params(5, 1, 1000));
     tst_fact((x0^4) + (x0^2) - 20, 3, upolynomial::factor_params(7, 1, 1000));
-    tst_fact((x0^70) - 6*(x0^65) - (x0^60) + 60*(x0^55) - 54*(x0^50) - 230*(x0^45) + 274*(x0^40) + 542*(x0^35) - 615*(x0^30) - 1120*(x0^25) + 1500*(x0^20) - 160*(x0^15) - 395*(x0^10) + 76*(x0^5) + 34, 1, upolynomial::factor_params(3, 1, 20));
-    tst_fact((x0^70) - 6*(x0^65) - (x0^60) + 60*(x0^55) - 54*(x0^50) - 230*(x0^45) + 274*(x0^40) + 542*(x0^35) - 615*(x0^30) - 1120*(x0^25) + 1500*(x0^20) - 160*(x0^15) - 395*(x0^10) + 76*(x0^5) + 34, 2, upolynomial::factor_params(3, 1, 72));
-    tst_fact((x0^70) - 6*(x0^65) - (x0^60) + 60*(x0^55) - 54*(x0^50) - 230*(x0^45) + 274*(x0^40) + 542*(x0^35) - 615*(x0^30) - 1120*(x0^25) + 1500*(x0^20) - 160*(x0^15) - 395*(x0^10) + 76*(x0^5) + 34, 3, upolynomial::factor_params(3, 1, 80));
+    tst_fact((x0^70) - 6*(x0^65) - (x0^60) + 60*(x0^55) - 54*(x0^50) - 230*(x0^45) + 274*(x0^40) + 542*(x0^35) - 615*(x0^30) - 1120*(x0^25) + 1500*(x0^20) - 160*(x0^15) - 395*(x0^10) + 76*(x0^5) + 34, 1, upolynomial::factor_params(3, 1, 20, 0));
+    tst_fact((x0^70) - 6*(x0^65) - (x0^60) + 60*(x0^55) - 54*(x0^50) - 230*(x0^45) + 274*(x0^40) + 542*(x0^35) - 615*(x0^30) - 1120*(x0^25) + 1500*(x0^20) - 160*(x0^15) - 395*(x0^10) + 76*(x0^5) + 34, 2, upolynomial::factor_params(3, 1, 72, 0));
+    tst_fact((x0^70) - 6*(x0^65) - (x0^60) + 60*(x0^55) - 54*(x0^50) - 230*(x0^45) + 274*(x0^40) + 542*(x0^35) - 615*(x0^30) - 1120*(x0^25) + 1500*(x0^20) - 160*(x0^15) - 395*(x0^10) + 76*(x0^5) + 34, 3, upolynomial::factor_params(3, 1, 80, 0));
     tst_fact( (x0^10) - 10*(x0^8) + 38*(x0^6) - 2*(x0^5) - 100*(x0^4) - 40*(x0^3) + 121*(x0^2) - 38*x0 - 17, 1);
     tst_fact( (x0^4) - 404*(x0^2) + 39204, 2);
     tst_fact(((x0^5) - (x0^2) + 1)*((-1)*x0 + 1)*((x0^2) - 2*x0 + 3), 3);
@@ -991,6 +1061,55 @@ static void tst_fact() {
               5);
 }
 
+// Swinnerton-Dyer polynomial for the first n primes, evaluated at x + c. 
+// It is irreducible, but it splits into factors of degree at most 2 modulo every prime.
+static void mk_swinnerton_dyer(polynomial::manager & m, polynomial_ref const & x, int c, unsigned n, polynomial_ref & r) {
+    static int primes[] = { 2, 3, 5, 7, 11 };
+    SASSERT(n <= sizeof(primes)/sizeof(int));
+    r = x + c;
+    for (unsigned i = 0; i < n; i++) {
+        polynomial_ref y(m);
+        y = m.mk_polynomial(m.mk_var());
+        r = r - y;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        polynomial::var y = m.num_vars() - n + i;
+        polynomial_ref q(m), tmp(m);
+        q = m.mk_polynomial(y);
+        q = (q^2) - primes[i];
+        m.resultant(r, q, y, tmp);
+        r = tmp;
+    }
+}
+
+static void tst_lattice_fact() {
+    reslimit rl;
+    polynomial::numeral_manager nm;
+    polynomial::manager m(rl, nm);
+    polynomial_ref x0(m);
+    x0 = m.mk_polynomial(m.mk_var());
+    upolynomial::factor_params lattice;
+    lattice.m_lattice_min_factors = 2;
+    upolynomial::factor_params no_lattice;
+    no_lattice.m_lattice_min_factors = 0;
+    polynomial_ref sd3(m), sd4(m), sd4_1(m), sd5(m);
+    mk_swinnerton_dyer(m, x0, 0, 3, sd3);
+    mk_swinnerton_dyer(m, x0, 0, 4, sd4);
+    mk_swinnerton_dyer(m, x0, 1, 4, sd4_1);
+    mk_swinnerton_dyer(m, x0, 0, 5, sd5);
+    tst_fact((x0^4) + (x0^2) - 20, 3, lattice);
+    tst_fact(((x0^5) - (x0^2) + 1)*((-1)*x0 + 1)*((x0^2) - 2*x0 + 3), 3, lattice);
+    tst_fact((x0 - 1)*(x0 - 2)*(x0 + 3)*(x0 - 4)*(x0 + 5)*(x0 - 6)*(x0 + 7)*(x0 - 8)*(x0 + 9)*(x0 - 10), 10, lattice);
+    // the lattice recombination does not depend on the search limit
+    tst_fact((x0^70) - 6*(x0^65) - (x0^60) + 60*(x0^55) - 54*(x0^50) - 230*(x0^45) + 274*(x0^40) + 542*(x0^35) - 615*(x0^30) - 1120*(x0^25) + 1500*(x0^20) - 160*(x0^15) - 395*(x0^10) + 76*(x0^5) + 34, 3, upolynomial::factor_params(3, 1, 20, 2));
+    tst_fact(sd4, 1, no_lattice);
+    tst_fact(sd4, 1, lattice);
+    tst_fact(sd3*sd4_1, 2, lattice);
+    tst_fact(sd4*sd4_1*((x0^2) - 3), 3, lattice);
+    tst_fact(sd5, 1);
+    tst_fact(sd5*(3*(x0^3) - 2*x0 + 7), 2);
+}
+
 static void tst_rem(polynomial_ref const & p, polynomial_ref const & q, polynomial_ref const & expected) {
     SASSERT(is_univariate(p));
     SASSERT(is_univariate(q));
@@ -1067,9 +1186,11 @@ void tst_upolynomial() {
     tst_gcd();
     tst_lower_bound();
     tst_fact();
+    tst_lattice_fact();
     tst_rem();
     tst_exact_div();
     tst_isolate_roots5();
+    tst_vca_isolate_roots();
     // tst_gcd2();
     // tst_isolate_roots4();
     // tst_isolate_roots3();
@@ -20,6 +20,7 @@ Revision History:
 #include"trace.h"
 #include"buffer.h"
 #include"mpn.h"
+#include<algorithm>
 
 #define max(a,b)    (((a) > (b)) ? (a) : (b))
 
@@ -104,18 +105,154 @@ bool mpn_manager::sub(mpn_digit const * a, size_t const lnga,
     return true; // return k != 0?
 }
 
+#define DIGIT_BITS (sizeof(mpn_digit)*8)
+#define HALF_BITS (sizeof(mpn_digit)*4)
+
+// Operands with fewer digits than this are multiplied by the quadratic algorithm.
+#define KARATSUBA_THRESHOLD 32
+// Divisors with fewer digits than this are handled by Knuth's Algorithm D.
+#define BZ_THRESHOLD 64
+
+// r[0..n) := a[0..n) + b[0..n), returns the carry. r may be equal to a or b.
+static mpn_digit add_n(mpn_digit * r, mpn_digit const * a, mpn_digit const * b, size_t n) {
+    mpn_digit k = 0;
+    for (size_t j = 0; j < n; j++) {
+        mpn_digit s = a[j] + b[j];
+        mpn_digit c1 = s < a[j];
+        r[j] = s + k;
+        k = c1 | (r[j] < s);
+    }
+    return k;
+}
+
+// r[0..n) := a[0..n) - b[0..n), returns the borrow. r may be equal to a or b.
+static mpn_digit sub_n(mpn_digit * r, mpn_digit const * a, mpn_digit const * b, size_t n) {
+    mpn_digit k = 0;
+    for (size_t j = 0; j < n; j++) {
+        mpn_digit d = a[j] - b[j];
+        mpn_digit c1 = d > a[j];
+        r[j] = d - k;
+        k = c1 | (r[j] > d);
+    }
+    return k;
+}
+
+// r[0..lr) += a[0..la), where la <= lr, returns the carry out of r.
+static mpn_digit add_to(mpn_digit * r, size_t lr, mpn_digit const * a, size_t la) {
+    SASSERT(la <= lr);
+    mpn_digit k = add_n(r, r, a, la);
+    for (size_t j = la; k != 0 && j < lr; j++) {
+        r[j]++;
+        k = r[j] == 0;
+    }
+    return k;
+}
+
+// r[0..lr) -= a[0..la), where la <= lr, returns the borrow out of r.
+static mpn_digit sub_from(mpn_digit * r, size_t lr, mpn_digit const * a, size_t la) {
+    SASSERT(la <= lr);
+    mpn_digit k = sub_n(r, r, a, la);
+    for (size_t j = la; k != 0 && j < lr; j++) {
+        k = r[j] == 0;
+        r[j]--;
+    }
+    return k;
+}
+
+static int compare_n(mpn_digit const * a, mpn_digit const * b, size_t n) {
+    for (size_t j = n; j-- > 0; ) {
+        if (a[j] != b[j])
+            return a[j] > b[j] ? 1 : -1;
+    }
+    return 0;
+}
+
 bool mpn_manager::mul(mpn_digit const * a, size_t const lnga,
                       mpn_digit const * b, size_t const lngb,
                       mpn_digit * c) const {
     trace(a, lnga, b, lngb, "*");
+    mul_rec(a, lnga, b, lngb, c);
+    trace_nl(c, lnga+lngb);
+    return true;
+}
+
+void mpn_manager::mul_rec(mpn_digit const * a, size_t lnga,
+                          mpn_digit const * b, size_t lngb,
+                          mpn_digit * c) const {
+    if (lnga < lngb) {
+        std::swap(a, b);
+        std::swap(lnga, lngb);
+    }
+    if (lngb < KARATSUBA_THRESHOLD)
+        mul_basecase(a, lnga, b, lngb, c);
+    else if (lngb <= (lnga + 1) / 2)
+        mul_unbalanced(a, lnga, b, lngb, c);
+    else
+        mul_karatsuba(a, lnga, b, lngb, c);
+}
+
+void mpn_manager::mul_unbalanced(mpn_digit const * a, size_t const lnga,
+                                 mpn_digit const * b, size_t const lngb,
+                                 mpn_digit * c) const {
+    // Multiply b by slices of a that have lngb digits each.
+    SASSERT(lnga >= lngb);
+    for (size_t i = 0; i < lnga + lngb; i++)
+        c[i] = 0;
+    mpn_sbuffer t(2 * lngb, 0);
+    for (size_t i = 0; i < lnga; i += lngb) {
+        size_t lng = std::min(lngb, lnga - i);
+        mul_rec(a + i, lng, b, lngb, t.c_ptr());
+        mpn_digit k = add_to(c + i, lnga + lngb - i, t.c_ptr(), lng + lngb);
+        SASSERT(k == 0); (void)k;
+    }
+}
+
+void mpn_manager::mul_karatsuba(mpn_digit const * a, size_t const lnga,
+                                mpn_digit const * b, size_t const lngb,
+                                mpn_digit * c) const {
+    // a = a1 * B^h + a0, b = b1 * B^h + b0
+    // a * b = z2 * B^2h + (z1 - z2 - z0) * B^h + z0, where
+    // z2 = a1 * b1, z0 = a0 * b0 and z1 = (a1 + a0) * (b1 + b0).
+    size_t h = (lnga + 1) / 2;
+    SASSERT(lnga >= lngb && lngb > h);
+    size_t lnga1 = lnga - h;
+    size_t lngb1 = lngb - h;
+    size_t lngc  = lnga + lngb;
+
+    mul_rec(a, h, b, h, c);
+    mul_rec(a + h, lnga1, b + h, lngb1, c + 2*h);
+
+    mpn_sbuffer t(4*h + 4, 0);
+    mpn_digit * sa = t.c_ptr();
+    mpn_digit * sb = sa + (h + 1);
+    mpn_digit * z1 = sb + (h + 1);
+    for (size_t i = 0; i < h; i++) {
+        sa[i] = a[i];
+        sb[i] = b[i];
+    }
+    sa[h] = add_to(sa, h, a + h, lnga1);
+    sb[h] = add_to(sb, h, b + h, lngb1);
+    mul_rec(sa, h + 1, sb, h + 1, z1);
+
+    size_t lngz1 = 2*h + 2;
+    mpn_digit k = sub_from(z1, lngz1, c, 2*h);
+    k |= sub_from(z1, lngz1, c + 2*h, lnga1 + lngb1);
+    SASSERT(k == 0);
+    while (lngz1 > lngc - h) {
+        SASSERT(z1[lngz1 - 1] == 0);
+        lngz1--;
+    }
+    k |= add_to(c + h, lngc - h, z1, lngz1);
+    SASSERT(k == 0); (void)k;
+}
+
+void mpn_manager::mul_basecase(mpn_digit const * a, size_t const lnga,
+                               mpn_digit const * b, size_t const lngb,
+                               mpn_digit * c) const {
     // Essentially Knuth's Algorithm M. 
-    // Perhaps implement a more efficient version, see e.g., Knuth, Section 4.3.3.    
     size_t i;
     mpn_digit k;
 
-#define DIGIT_BITS (sizeof(mpn_digit)*8)
-#define HALF_BITS (sizeof(mpn_digit)*4)
-
     for (unsigned i = 0; i < lnga; i++)
         c[i] = 0;
 
@@ -139,9 +276,6 @@ bool mpn_manager::mul(mpn_digit const * a, size_t const lnga,
             c[j+lnga] = k;
         }        
     }
-    
-    trace_nl(c, lnga+lngb);
-    return true;
 }
 
 #define MASK_FIRST (~((mpn_digit)(-1) >> 1))
@@ -191,6 +325,8 @@ bool mpn_manager::div(mpn_digit const * numer, size_t const lnum,
         size_t d = div_normalize(numer, lnum, denom, lden, u, v);
         if (lden == 1)
             res = div_1(u, v[0], quot);
+        else if (lden >= BZ_THRESHOLD && lnum - lden >= BZ_THRESHOLD)
+            res = div_bz(u, v, quot);
         else
             res = div_n(u, v, quot, rem, t_ms, t_ab);
         div_unnormalize(u, v, d, rem);    
@@ -352,6 +488,104 @@ bool mpn_manager::div_n(mpn_sbuffer & numer, mpn_sbuffer const & denom,
     return true; // return rem != 0?
 }
 
+bool mpn_manager::div_bz(mpn_sbuffer & numer, mpn_sbuffer const & denom,
+                         mpn_digit * quot) const {
+    // Burnikel and Ziegler, Fast Recursive Division, 1998.
+    // numer is split in blocks of n digits that are divided from the
+    // most significant one down, each step dividing 2n by n digits.
+    size_t n     = denom.size();
+    size_t lnum  = numer.size();
+    size_t lquot = lnum - n;
+    size_t num_blocks = (lnum + n - 1) / n;
+    SASSERT(denom[n-1] & MASK_FIRST);
+
+    mpn_sbuffer x(2*n, 0), q(n, 0), r(n, 0);
+    for (size_t i = num_blocks; i-- > 0; ) {
+        for (size_t j = 0; j < n; j++) {
+            size_t idx = i*n + j;
+            x[j]   = (idx < lnum) ? numer[idx] : 0;
+            x[n+j] = r[j];
+        }
+        div_2n1n(x.c_ptr(), denom.c_ptr(), n, q.c_ptr(), r.c_ptr());
+        for (size_t j = 0; j < n; j++) {
+            size_t idx = i*n + j;
+            if (idx < lquot)
+                quot[idx] = q[j];
+            else
+                SASSERT(q[j] == 0);
+        }
+    }
+
+    // Leave the remainder where div_n leaves it.
+    for (size_t j = 0; j < lnum; j++)
+        numer[j] = (j < n) ? r[j] : 0;
+    return true;
+}
+
+void mpn_manager::div_2n1n(mpn_digit const * a, mpn_digit const * b, size_t const n,
+                           mpn_digit * quot, mpn_digit * rem) const {
+    // a has 2n digits, b has n digits and is normalized, and a < b * B^n.
+    // quot and rem receive n digits each.
+    SASSERT(n > 1);
+    if (n % 2 == 1 || n < BZ_THRESHOLD) {
+        mpn_sbuffer u(2*n, 0), v(n, 0), ms, ab;
+        for (size_t i = 0; i < 2*n; i++)
+            u[i] = a[i];
+        for (size_t i = 0; i < n; i++)
+            v[i] = b[i];
+        div_n(u, v, quot, rem, ms, ab);
+        for (size_t i = 0; i < n; i++)
+            rem[i] = u[i];
+        return;
+    }
+
+    size_t k = n / 2;
+    mpn_sbuffer t(3*k, 0);
+    div_3n2n(a + k, b, k, quot + k, t.c_ptr() + k);
+    for (size_t i = 0; i < k; i++)
+        t[i] = a[i];
+    div_3n2n(t.c_ptr(), b, k, quot, rem);
+}
+
+void mpn_manager::div_3n2n(mpn_digit const * a, mpn_digit const * b, size_t const k,
+                           mpn_digit * quot, mpn_digit * rem) const {
+    // a = [a1, a2, a3] has 3k digits, b = [b1, b2] has 2k digits and is
+    // normalized, and a < b * B^k. quot receives k digits and rem 2k digits.
+    mpn_digit const * a12 = a + k;
+    mpn_digit const * a1  = a + 2*k;
+    mpn_digit const * b2  = b;
+    mpn_digit const * b1  = b + k;
+
+    // t := r1 * B^k + a3, where q * b1 + r1 = [a1, a2]
+    mpn_sbuffer t(2*k + 1, 0);
+    for (size_t i = 0; i < k; i++)
+        t[i] = a[i];
+    if (compare_n(a1, b1, k) < 0) {
+        div_2n1n(a12, b1, k, quot, t.c_ptr() + k);
+    }
+    else {
+        // a1 == b1, q = B^k - 1 and r1 = [a1, a2] - q * b1 = a2 + b1
+        for (size_t i = 0; i < k; i++)
+            quot[i] = (mpn_digit)-1;
+        t[2*k] = add_n(t.c_ptr() + k, a12, b1, k);
+    }
+
+    // rem := t - q * b2, corrected by adding b while it is negative.
+    mpn_sbuffer d(2*k + 1, 0);
+    mul_rec(quot, k, b2, k, d.c_ptr());
+    if (sub_n(t.c_ptr(), t.c_ptr(), d.c_ptr(), 2*k + 1) != 0) {
+        mpn_digit carry = 0;
+        while (carry == 0) {
+            mpn_digit one = 1;
+            sub_from(quot, k, &one, 1);
+            carry = add_to(t.c_ptr(), 2*k + 1, b, 2*k);
+        }
+    }
+    SASSERT(t[2*k] == 0);
+    for (size_t i = 0; i < 2*k; i++)
+        rem[i] = t[i];
+}
+
 char * mpn_manager::to_string(mpn_digit const * a, size_t const lng, char * buf, size_t const lbuf) const {
     SASSERT(buf && lbuf > 0);    
     TRACE("mpn_to_string", tout << "[mpn] to_string "; display_raw(tout, a, lng); tout << " == "; );
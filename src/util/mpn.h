@@ -105,6 +105,31 @@ private:
                mpn_digit * quot, mpn_digit * rem,
                mpn_sbuffer & ms, mpn_sbuffer & ab) const;
 
+    bool div_bz(mpn_sbuffer & numer, mpn_sbuffer const & denom,
+                mpn_digit * quot) const;
+
+    void div_2n1n(mpn_digit const * a, mpn_digit const * b, size_t const n,
+                  mpn_digit * quot, mpn_digit * rem) const;
+
+    void div_3n2n(mpn_digit const * a, mpn_digit const * b, size_t const k,
+                  mpn_digit * quot, mpn_digit * rem) const;
+
+    void mul_rec(mpn_digit const * a, size_t lnga,
+                 mpn_digit const * b, size_t lngb,
+                 mpn_digit * c) const;
+
+    void mul_basecase(mpn_digit const * a, size_t const lnga,
+                      mpn_digit const * b, size_t const lngb,
+                      mpn_digit * c) const;
+
+    void mul_unbalanced(mpn_digit const * a, size_t const lnga,
+                        mpn_digit const * b, size_t const lngb,
+                        mpn_digit * c) const;
+
+    void mul_karatsuba(mpn_digit const * a, size_t const lnga,
+                       mpn_digit const * b, size_t const lngb,
+                       mpn_digit * c) const;
+
     void trace(mpn_digit const * a, size_t const lnga, 
                mpn_digit const * b, size_t const lngb, 
                const char * op) const;
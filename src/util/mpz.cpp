@@ -23,6 +23,14 @@ Revision History:
 #include"hash.h"
 #include"bit_util.h"
 
+#ifdef _MP_THREAD_SCRATCH
+#ifdef _WINDOWS
+#include<windows.h>
+#else
+#include<pthread.h>
+#endif
+#endif
+
 #if defined(_MP_INTERNAL)
 #include"mpn.h"
 #elif defined(_MP_GMP)
@@ -83,11 +91,131 @@ static T gcd_core(T u, T v) {
 unsigned u_gcd(unsigned u, unsigned v) { return gcd_core(u, v); }
 uint64 u64_gcd(uint64 u, uint64 v) { return gcd_core(u, v); }
 
+#ifdef _MP_THREAD_SCRATCH
+MPZ_THREAD_LOCAL mpz_thread_scratch * g_mpz_thread_scratch = 0;
+MPZ_THREAD_LOCAL unsigned g_mpz_thread_scratch_epoch = 0;
+// Incremented by finalize_mpz_thread_scratch, it invalidates the scratch cells of all threads.
+unsigned g_mpz_scratch_epoch = 1;
+// Scratch cells of all threads.
+static mpz_thread_scratch * g_mpz_scratch_list = 0;
+// The key is used to release the scratch cells of a thread when it exits.
+static bool g_mpz_scratch_key_valid = false;
+#ifdef _WINDOWS
+static DWORD g_mpz_scratch_key;
+#else
+static pthread_key_t g_mpz_scratch_key;
+#endif
+
+static void del_mpz_thread_scratch(mpz_thread_scratch * s) {
+    for (unsigned i = 0; i < 2; i++) {
+        memory::deallocate(s->m_tmp[i]);
+        memory::deallocate(s->m_arg[i]);
+    }
+    dealloc(s);
+}
+
+#ifdef _WINDOWS
+static VOID WINAPI mpz_thread_exit(PVOID p) {
+#else
+static void mpz_thread_exit(void * p) {
+#endif
+    mpz_thread_scratch * s = static_cast<mpz_thread_scratch *>(p);
+    if (s == 0)
+        return;
+    bool owned = false;
+    #pragma omp critical (mpz_thread_scratch)
+    {
+        // scratch cells of a previous epoch were already released by finalize_mpz_thread_scratch.
+        if (s->m_epoch == g_mpz_scratch_epoch) {
+            if (s->m_prev)
+                s->m_prev->m_next = s->m_next;
+            else
+                g_mpz_scratch_list = s->m_next;
+            if (s->m_next)
+                s->m_next->m_prev = s->m_prev;
+            owned = true;
+        }
+    }
+    if (owned)
+        del_mpz_thread_scratch(s);
+}
+
+void init_mpz_thread_scratch() {
+    // same initial capacity used by mpz_manager
+    unsigned capacity = sizeof(digit_t) == sizeof(uint64) ? 4 : 6;
+    mpz_thread_scratch * s = alloc(mpz_thread_scratch);
+    for (unsigned i = 0; i < 2; i++) {
+        mpz_cell * cells[2];
+        for (unsigned j = 0; j < 2; j++) {
+            cells[j] = reinterpret_cast<mpz_cell *>(memory::allocate(sizeof(mpz_cell) + sizeof(digit_t) * capacity));
+            cells[j]->m_capacity = capacity;
+        }
+        cells[1]->m_size = 1;
+        s->m_tmp[i] = cells[0];
+        s->m_arg[i] = cells[1];
+    }
+    s->m_prev = 0;
+    #pragma omp critical (mpz_thread_scratch)
+    {
+        if (!g_mpz_scratch_key_valid) {
+#ifdef _WINDOWS
+            g_mpz_scratch_key = FlsAlloc(mpz_thread_exit);
+#else
+            pthread_key_create(&g_mpz_scratch_key, mpz_thread_exit);
+#endif
+            g_mpz_scratch_key_valid = true;
+        }
+        s->m_epoch = g_mpz_scratch_epoch;
+        s->m_next  = g_mpz_scratch_list;
+        if (g_mpz_scratch_list)
+            g_mpz_scratch_list->m_prev = s;
+        g_mpz_scratch_list = s;
+    }
+#ifdef _WINDOWS
+    FlsSetValue(g_mpz_scratch_key, s);
+#else
+    pthread_setspecific(g_mpz_scratch_key, s);
+#endif
+    g_mpz_thread_scratch       = s;
+    g_mpz_thread_scratch_epoch = s->m_epoch;
+}
+
+void finalize_mpz_thread_scratch() {
+    // Other threads (e.g., idle OpenMP workers) may still be alive,
+    // they allocate new scratch cells if they use a synchronized manager again.
+    mpz_thread_scratch * s = 0;
+    bool key_valid = false;
+    #pragma omp critical (mpz_thread_scratch)
+    {
+        s = g_mpz_scratch_list;
+        g_mpz_scratch_list = 0;
+        key_valid = g_mpz_scratch_key_valid;
+        g_mpz_scratch_key_valid = false;
+        g_mpz_scratch_epoch++;
+    }
+    if (key_valid) {
+#ifdef _WINDOWS
+        FlsFree(g_mpz_scratch_key);
+#else
+        pthread_key_delete(g_mpz_scratch_key);
+#endif
+    }
+    while (s) {
+        mpz_thread_scratch * next = s->m_next;
+        del_mpz_thread_scratch(s);
+        s = next;
+    }
+    g_mpz_thread_scratch = 0;
+}
+#endif
+
 template<bool SYNCH>
 mpz_manager<SYNCH>::mpz_manager():
     m_allocator("mpz_manager") {
+#ifndef _MP_THREAD_SCRATCH
     if (SYNCH)
         omp_init_nest_lock(&m_lock);
+#endif
 #ifndef _MP_GMP
     if (sizeof(digit_t) == sizeof(uint64)) {
         // 64-bit machine
@@ -97,6 +225,12 @@ mpz_manager<SYNCH>::mpz_manager():
         m_init_cell_capacity = 6;
     }
     for (unsigned i = 0; i < 2; i++) {
+        m_tmp[i] = 0;
+        m_arg[i] = 0;
+#ifdef _MP_THREAD_SCRATCH
+        if (SYNCH)
+            continue;
+#endif
         m_tmp[i] = allocate(m_init_cell_capacity);
         m_arg[i] = allocate(m_init_cell_capacity);
         m_arg[i]->m_size = 1;
@@ -144,8 +278,8 @@ mpz_manager<SYNCH>::~mpz_manager() {
 #ifndef _MP_GMP
     del(m_int_min);
     for (unsigned i = 0; i < 2; i++) {
-        deallocate(m_tmp[i]);
-        deallocate(m_arg[i]);
+        if (m_tmp[i]) deallocate(m_tmp[i]);
+        if (m_arg[i]) deallocate(m_arg[i]);
     }
 #else
     mpz_clear(m_tmp);
@@ -157,8 +291,10 @@ mpz_manager<SYNCH>::~mpz_manager() {
     mpz_clear(m_int64_max);
     mpz_clear(m_int64_min);
 #endif
+#ifndef _MP_THREAD_SCRATCH
     if (SYNCH)
         omp_destroy_nest_lock(&m_lock);
+#endif
 }
 
 template<bool SYNCH>
@@ -252,30 +388,31 @@ void mpz_manager<SYNCH>::set(mpz & a, int sign, unsigned sz) {
         verbose_stream() << "max_sz: " << max_sz << "\n";
     }
 #endif
+    mpz_cell * & t = tmp<IDX>();
     unsigned i = sz;
     for (; i > 0; --i) {
-        if (m_tmp[IDX]->m_digits[i-1] != 0)
+        if (t->m_digits[i-1] != 0)
             break;
     }
 
     if (i == 0) {
-        // m_tmp[IDX] is zero
+        // t is zero
         reset(a);
         return;
     }
     
-    if (i == 1 && m_tmp[IDX]->m_digits[0] <= INT_MAX) {
-        // m_tmp[IDX] fits is a fixnum
+    if (i == 1 && t->m_digits[0] <= INT_MAX) {
+        // t fits is a fixnum
         del(a);
-        a.m_val = sign < 0 ? -static_cast<int>(m_tmp[IDX]->m_digits[0]) : static_cast<int>(m_tmp[IDX]->m_digits[0]);
+        a.m_val = sign < 0 ? -static_cast<int>(t->m_digits[0]) : static_cast<int>(t->m_digits[0]);
         return;
     }
 
     a.m_val = sign;
-    std::swap(a.m_ptr, m_tmp[IDX]);
+    std::swap(a.m_ptr, t);
     a.m_ptr->m_size = i;
-    if (!m_tmp[IDX]) // 'a' was a small number
-        m_tmp[IDX] = allocate(m_init_cell_capacity);
+    if (!t) // 'a' was a small number
+        t = allocate(m_init_cell_capacity);
 }
 #endif
 
@@ -369,7 +506,7 @@ void mpz_manager<SYNCH>::big_add_sub(mpz const & a, mpz const & b, mpz & c) {
         ensure_tmp_capacity<0>(sz);
         m_mpn_manager.add(cell_a->m_digits, cell_a->m_size,
                           cell_b->m_digits, cell_b->m_size, 
-                          m_tmp[0]->m_digits, sz, &real_sz);
+                          tmp<0>()->m_digits, sz, &real_sz);
         SASSERT(real_sz <= sz);
         set<0>(c, sign_a, static_cast<unsigned>(real_sz));
     }
@@ -388,7 +525,7 @@ void mpz_manager<SYNCH>::big_add_sub(mpz const & a, mpz const & b, mpz & c) {
                               cell_b->m_size,
                               cell_a->m_digits,
                               cell_a->m_size,
-                              m_tmp[0]->m_digits,
+                              tmp<0>()->m_digits,
                               &borrow);
             SASSERT(borrow == 0);
             set<0>(c, sign_b, sz);
@@ -401,7 +538,7 @@ void mpz_manager<SYNCH>::big_add_sub(mpz const & a, mpz const & b, mpz & c) {
                               cell_a->m_size,
                               cell_b->m_digits,
                               cell_b->m_size,
-                              m_tmp[0]->m_digits,
+                              tmp<0>()->m_digits,
                               &borrow);
             SASSERT(borrow == 0);
             set<0>(c, sign_a, sz);
@@ -455,7 +592,7 @@ void mpz_manager<SYNCH>::big_mul(mpz const & a, mpz const & b, mpz & c) {
                       cell_a->m_size,
                       cell_b->m_digits,
                       cell_b->m_size,
-                      m_tmp[0]->m_digits);
+                      tmp<0>()->m_digits);
     set<0>(c, sign_a == sign_b ? 1 : -1, sz);
 #else
     // GMP version
@@ -497,8 +634,8 @@ void mpz_manager<SYNCH>::quot_rem_core(mpz const & a, mpz const & b, mpz & q, mp
     ensure_tmp_capacity<1>(r_sz);
     m_mpn_manager.div(cell_a->m_digits, cell_a->m_size,
                       cell_b->m_digits, cell_b->m_size,                      
-                       m_tmp[0]->m_digits,
-                       m_tmp[1]->m_digits);
+                       tmp<0>()->m_digits,
+                       tmp<1>()->m_digits);
     if (MODE == QUOT_ONLY || MODE == QUOT_AND_REM)
         set<0>(q, sign_a == sign_b ? 1 : -1, q_sz);
     if (MODE == REM_ONLY || MODE == QUOT_AND_REM)
@@ -558,6 +695,7 @@ void mpz_manager<SYNCH>::big_rem(mpz const & a, mpz const & b, mpz & c) {
 
 template<bool SYNCH>
 void mpz_manager<SYNCH>::gcd(mpz const & a, mpz const & b, mpz & c) {
+    int64 a64, b64;
     if (is_small(a) && is_small(b)) {
         int _a = a.m_val;
         int _b = b.m_val;
@@ -568,6 +706,10 @@ void mpz_manager<SYNCH>::gcd(mpz const & a, mpz const & b, mpz & c) {
         // If a == b == INT_MIN
         set(c, r);
     }
+    else if (is_i64(a, a64) && is_i64(b, b64)) {
+        // INT64_MIN is not in the range of is_i64
+        set(c, u64_gcd(static_cast<uint64>(a64 < 0 ? -a64 : a64), static_cast<uint64>(b64 < 0 ? -b64 : b64)));
+    }
     else {
 #ifdef _MP_GMP
         mpz_t * arg0;
@@ -32,6 +32,52 @@ Revision History:
 unsigned u_gcd(unsigned u, unsigned v);
 uint64 u64_gcd(uint64 u, uint64 v);
 
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+#define _MP_OVERFLOW_BUILTINS
+#endif
+
+/**
+   \brief Store a + b in r. Return true if the addition overflowed.
+*/
+inline bool i64_add_overflow(int64 a, int64 b, int64 & r) {
+#ifdef _MP_OVERFLOW_BUILTINS
+    return __builtin_add_overflow(a, b, &r);
+#else
+    r = static_cast<int64>(static_cast<uint64>(a) + static_cast<uint64>(b));
+    return ((a ^ r) & (b ^ r)) < 0;
+#endif
+}
+
+/**
+   \brief Store a - b in r. Return true if the subtraction overflowed.
+*/
+inline bool i64_sub_overflow(int64 a, int64 b, int64 & r) {
+#ifdef _MP_OVERFLOW_BUILTINS
+    return __builtin_sub_overflow(a, b, &r);
+#else
+    r = static_cast<int64>(static_cast<uint64>(a) - static_cast<uint64>(b));
+    return ((a ^ b) & (a ^ r)) < 0;
+#endif
+}
+
+/**
+   \brief Store a * b in r. Return true if the multiplication overflowed.
+*/
+inline bool i64_mul_overflow(int64 a, int64 b, int64 & r) {
+#ifdef _MP_OVERFLOW_BUILTINS
+    return __builtin_mul_overflow(a, b, &r);
+#else
+    r = static_cast<int64>(static_cast<uint64>(a) * static_cast<uint64>(b));
+    if (-INT_MAX <= a && a <= INT_MAX && -INT_MAX <= b && b <= INT_MAX)
+        return false;
+    if (a == 0)
+        return false;
+    if ((a == -1 && b == INT64_MIN) || (b == -1 && a == INT64_MIN))
+        return true;
+    return r / a != b;
+#endif
+}
+
 #ifdef _MP_GMP
 typedef unsigned digit_t;
 #endif
@@ -64,11 +110,51 @@ class mpz_cell {
     digit_t   m_digits[0];
     friend class mpz_manager<true>;
     friend class mpz_manager<false>;
+    friend void init_mpz_thread_scratch();
 };
 #else
 #include<gmp.h>
 #endif
 
+#if !defined(_MP_GMP) && (defined(_WINDOWS) || defined(_USE_THREAD_LOCAL))
+// Synchronized managers keep their scratch cells in thread local storage,
+// and allocate cells using the (thread safe) memory manager.
+// Thus, they don't need a lock.
+#define _MP_THREAD_SCRATCH
+#endif
+
+#ifdef _MP_THREAD_SCRATCH
+#ifdef _WINDOWS
+#define MPZ_THREAD_LOCAL __declspec(thread)
+#else
+#define MPZ_THREAD_LOCAL __thread
+#endif
+
+struct mpz_thread_scratch {
+    mpz_cell *           m_tmp[2];
+    mpz_cell *           m_arg[2];
+    unsigned             m_epoch;
+    mpz_thread_scratch * m_prev;
+    mpz_thread_scratch * m_next;
+};
+
+extern MPZ_THREAD_LOCAL mpz_thread_scratch * g_mpz_thread_scratch;
+// g_mpz_thread_scratch is valid only if g_mpz_thread_scratch_epoch == g_mpz_scratch_epoch.
+extern MPZ_THREAD_LOCAL unsigned g_mpz_thread_scratch_epoch;
+extern unsigned g_mpz_scratch_epoch;
+
+void init_mpz_thread_scratch();
+
+/**
+   \brief Release the scratch cells of all threads.
+   The scratch cells of a thread are also released when the thread exits.
+*/
+void finalize_mpz_thread_scratch();
+/*
+  ADD_FINALIZER('finalize_mpz_thread_scratch();')
+*/
+#endif
+
 /**
    \brief Multi-precision integer.
    
@@ -105,9 +191,14 @@ inline void swap(mpz & m1, mpz & m2) { m1.swap(m2); }
 template<bool SYNCH = true>
 class mpz_manager {
     small_object_allocator  m_allocator;
+#ifdef _MP_THREAD_SCRATCH
+#define MPZ_BEGIN_CRITICAL() {}
+#define MPZ_END_CRITICAL()   {}
+#else
     omp_nest_lock_t         m_lock;
 #define MPZ_BEGIN_CRITICAL() if (SYNCH) omp_set_nest_lock(&m_lock);
 #define MPZ_END_CRITICAL()   if (SYNCH) omp_unset_nest_lock(&m_lock);
+#endif
     mpn_manager             m_mpn_manager;
 
 #ifndef _MP_GMP
@@ -120,7 +211,13 @@ class mpz_manager {
 
     mpz_cell * allocate(unsigned capacity) {
         SASSERT(capacity >= m_init_cell_capacity);
-        mpz_cell * cell  = reinterpret_cast<mpz_cell *>(m_allocator.allocate(cell_size(capacity)));
+        mpz_cell * cell;
+#ifdef _MP_THREAD_SCRATCH
+        if (SYNCH)
+            cell = reinterpret_cast<mpz_cell *>(memory::allocate(cell_size(capacity)));
+        else
+#endif
+            cell = reinterpret_cast<mpz_cell *>(m_allocator.allocate(cell_size(capacity)));
         cell->m_capacity = capacity;
         return cell;
     }
@@ -143,20 +240,59 @@ class mpz_manager {
     }
 
     void deallocate(mpz_cell * ptr) { 
+#ifdef _MP_THREAD_SCRATCH
+        if (SYNCH) {
+            memory::deallocate(ptr);
+            return;
+        }
+#endif
         m_allocator.deallocate(cell_size(ptr->m_capacity), ptr); 
     }
 
+#ifdef _MP_THREAD_SCRATCH
+    static mpz_thread_scratch & thread_scratch() {
+        if (g_mpz_thread_scratch_epoch != g_mpz_scratch_epoch)
+            init_mpz_thread_scratch();
+        return *g_mpz_thread_scratch;
+    }
+#endif
+
+    /**
+       \brief Scratch cell used to store results.
+    */
+    template<int IDX>
+    mpz_cell * & tmp() {
+#ifdef _MP_THREAD_SCRATCH
+        if (SYNCH)
+            return thread_scratch().m_tmp[IDX];
+#endif
+        return m_tmp[IDX];
+    }
+
     /**
-      \brief Make sure that m_tmp[IDX] can hold the given number of digits
+       \brief Scratch cell used to store small arguments as cells.
+    */
+    template<int IDX>
+    mpz_cell * arg() {
+#ifdef _MP_THREAD_SCRATCH
+        if (SYNCH)
+            return thread_scratch().m_arg[IDX];
+#endif
+        return m_arg[IDX];
+    }
+
+    /**
+      \brief Make sure that tmp<IDX>() can hold the given number of digits
     */
     template<int IDX>
     void ensure_tmp_capacity(unsigned capacity) {
-        if (m_tmp[IDX]->m_capacity >= capacity)
+        mpz_cell * & t = tmp<IDX>();
+        if (t->m_capacity >= capacity)
             return;
-        deallocate(m_tmp[IDX]);
+        deallocate(t);
         unsigned new_capacity = (3 * capacity + 1) >> 1;
-        m_tmp[IDX] = allocate(new_capacity);
-        SASSERT(m_tmp[IDX]->m_capacity >= capacity);
+        t = allocate(new_capacity);
+        SASSERT(t->m_capacity >= capacity);
     }
     
     // Expand capacity of a while preserving its content.
@@ -246,7 +382,7 @@ class mpz_manager {
                 cell = m_int_min.m_ptr;
             }
             else {
-                cell = m_arg[IDX];
+                cell = arg<IDX>();
                 SASSERT(cell->m_size == 1);
                 if (a.m_val < 0) {
                     sign = -1;
@@ -285,6 +421,28 @@ class mpz_manager {
     }
 #endif 
 
+    /**
+       \brief Return true if \c a is in (-2^63, 2^63), and store its value in \c v.
+       Used to run operations on medium sized numbers using machine integers.
+    */
+    static bool is_i64(mpz const & a, int64 & v) {
+        if (is_small(a)) {
+            v = a.m_val;
+            return true;
+        }
+#ifndef _MP_GMP
+        if (!is_abs_uint64(a))
+            return false;
+        uint64 num = big_abs_to_uint64(a);
+        if (num >> 63)
+            return false;
+        v = a.m_val < 0 ? -static_cast<int64>(num) : static_cast<int64>(num);
+        return true;
+#else
+        return false;
+#endif
+    }
+
 #ifndef _MP_GMP
     template<bool SUB>
     void big_add_sub(mpz const & a, mpz const & b, mpz & c);
@@ -345,9 +503,13 @@ public:
     
     void add(mpz const & a, mpz const & b, mpz & c) {
         STRACE("mpz", tout << "[mpz] " << to_string(a) << " + " << to_string(b) << " == ";); 
+        int64 _a, _b, _c;
         if (is_small(a) && is_small(b)) {
             set_i64(c, i64(a) + i64(b));
         }
+        else if (is_i64(a, _a) && is_i64(b, _b) && !i64_add_overflow(_a, _b, _c)) {
+            set_i64(c, _c);
+        }
         else {
             MPZ_BEGIN_CRITICAL();
             big_add(a, b, c);
@@ -358,9 +520,13 @@ public:
 
     void sub(mpz const & a, mpz const & b, mpz & c) {
         STRACE("mpz", tout << "[mpz] " << to_string(a) << " - " << to_string(b) << " == ";); 
+        int64 _a, _b, _c;
         if (is_small(a) && is_small(b)) {
             set_i64(c, i64(a) - i64(b));
         }
+        else if (is_i64(a, _a) && is_i64(b, _b) && !i64_sub_overflow(_a, _b, _c)) {
+            set_i64(c, _c);
+        }
         else {
             MPZ_BEGIN_CRITICAL();
             big_sub(a, b, c);
@@ -375,9 +541,13 @@ public:
 
     void mul(mpz const & a, mpz const & b, mpz & c) {
         STRACE("mpz", tout << "[mpz] " << to_string(a) << " * " << to_string(b) << " == ";); 
+        int64 _a, _b, _c;
         if (is_small(a) && is_small(b)) {
             set_i64(c, i64(a) * i64(b));
         }
+        else if (is_i64(a, _a) && is_i64(b, _b) && !i64_mul_overflow(_a, _b, _c)) {
+            set_i64(c, _c);
+        }
         else {
             MPZ_BEGIN_CRITICAL();
             big_mul(a, b, c);
@@ -422,9 +592,9 @@ public:
 
     void machine_div_rem(mpz const & a, mpz const & b, mpz & q, mpz & r) {
         STRACE("mpz", tout << "[mpz-ext] divrem(" << to_string(a) << ",  " << to_string(b) << ") == ";); 
-        if (is_small(a) && is_small(b)) {
-            int64 _a = i64(a);
-            int64 _b = i64(b);
+        int64 _a, _b;
+        if (is_i64(a, _a) && is_i64(b, _b)) {
+            // no overflow: INT64_MIN is not in the range of is_i64
             set_i64(q, _a / _b);
             set_i64(r, _a % _b);
         }
@@ -438,8 +608,9 @@ public:
 
     void machine_div(mpz const & a, mpz const & b, mpz & c) {
         STRACE("mpz", tout << "[mpz-ext] machine-div(" << to_string(a) << ",  " << to_string(b) << ") == ";); 
-        if (is_small(a) && is_small(b)) {
-            set_i64(c, i64(a) / i64(b));
+        int64 _a, _b;
+        if (is_i64(a, _a) && is_i64(b, _b)) {
+            set_i64(c, _a / _b);
         }
         else {
             MPZ_BEGIN_CRITICAL();
@@ -451,8 +622,9 @@ public:
 
     void rem(mpz const & a, mpz const & b, mpz & c) {
         STRACE("mpz", tout << "[mpz-ext] rem(" << to_string(a) << ",  " << to_string(b) << ") == ";); 
-        if (is_small(a) && is_small(b)) {
-            set_i64(c, i64(a) % i64(b));
+        int64 _a, _b;
+        if (is_i64(a, _a) && is_i64(b, _b)) {
+            set_i64(c, _a % _b);
         }
         else {
             MPZ_BEGIN_CRITICAL();